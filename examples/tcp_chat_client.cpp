@@ -8,15 +8,15 @@
 
 #include "asio_service.h"
 
-#include "server/asio/tcp_client.h"
+#include "server/asio/framed_tcp_client.h"
 #include "threads/thread.h"
 
 #include <iostream>
 
-class ChatClient : public CppServer::Asio::TCPClient
+class ChatClient : public CppServer::Asio::FramedTCPClient<CppServer::Asio::DelimiterCodec>
 {
 public:
-    using CppServer::Asio::TCPClient::TCPClient;
+    using CppServer::Asio::FramedTCPClient<CppServer::Asio::DelimiterCodec>::FramedTCPClient;
 
 protected:
     void onConnected() override
@@ -35,10 +35,9 @@ protected:
         Connect();
     }
 
-    size_t onReceived(const void* buffer, size_t size) override
+    void onMessage(const void* buffer, size_t size) override
     {
         std::cout << "Incoming: " << std::string((const char*)buffer, size) << std::endl;
-        return size;
     }
 
     void onError(int error, const std::string& category, const std::string& message) override
@@ -96,8 +95,8 @@ int main(int argc, char** argv)
             continue;
         }
 
-        // Send the entered text to the chat server
-        client->Send(line);
+        // Send the entered text line to the chat server
+        client->SendMessage(line);
     }
 
     // Disconnect the client
@@ -8,7 +8,7 @@
 
 #include "asio_service.h"
 
-#include "server/asio/tcp_server.h"
+#include "server/asio/framed_tcp_session.h"
 
 #include <iostream>
 
@@ -26,10 +26,10 @@ protected:
     }
 };
 
-class ChatSession : public CppServer::Asio::TCPSession<ChatServer, ChatSession>
+class ChatSession : public CppServer::Asio::FramedTCPSession<ChatServer, ChatSession, CppServer::Asio::DelimiterCodec>
 {
 public:
-    using CppServer::Asio::TCPSession<ChatServer, ChatSession>::TCPSession;
+    using CppServer::Asio::FramedTCPSession<ChatServer, ChatSession, CppServer::Asio::DelimiterCodec>::FramedTCPSession;
 
 protected:
     void onConnected() override
@@ -38,7 +38,7 @@ protected:
 
         // Send invite message
         std::string message("Hello from TCP chat! Please send a message or '!' to disconnect the client!");
-        Send(message);
+        SendMessage(message);
     }
 
     void onDisconnected() override
@@ -46,20 +46,19 @@ protected:
         std::cout << "Chat TCP session with Id " << id() << " disconnected!" << std::endl;
     }
 
-    size_t onReceived(const void* buffer, size_t size) override
+    void onMessage(const void* buffer, size_t size) override
     {
         std::string message((const char*)buffer, size);
         std::cout << "Incoming: " << message << std::endl;
 
-        // Multicast message to all connected sessions
-        server()->Multicast(message);
+        // Multicast the message line to all connected sessions
+        CppServer::Asio::Buffer frame;
+        codec().Encode(buffer, size, frame);
+        server()->Multicast(frame.data(), frame.size());
 
-        // If the buffer starts with '!' the disconnect the current session
+        // If the message is '!' the disconnect the current session
         if (message == "!")
             Disconnect();
-
-        // Inform that we handled the whole buffer
-        return size;
     }
 
     void onError(int error, const std::string& category, const std::string& message) override
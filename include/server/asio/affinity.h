@@ -0,0 +1,84 @@
+/*!
+    \file affinity.h
+    \brief Thread affinity and NUMA placement definition
+    \author Ivan Shynkarenka
+    \date 30.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_AFFINITY_H
+#define CPPSERVER_ASIO_AFFINITY_H
+
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace CppServer {
+namespace Asio {
+
+//! Thread affinity and NUMA placement
+/*!
+    Platform helpers to pin working threads to CPUs and to place their memory
+    on NUMA nodes. They are used by Asio service to pin its working threads.
+    Threads are pinned with CppCommon thread affinity.
+
+    NUMA placement does not depend on libnuma. On Linux the NUMA topology is
+    read from sysfs and the preferred node of the thread memory is set with
+    the set_mempolicy() system call. On other platforms memory is placed by
+    the first touch of the pinned thread.
+
+    Thread-safe.
+*/
+class Affinity
+{
+public:
+    Affinity() = delete;
+    Affinity(const Affinity&) = delete;
+    Affinity(Affinity&&) = delete;
+    ~Affinity() = delete;
+
+    Affinity& operator=(const Affinity&) = delete;
+    Affinity& operator=(Affinity&&) = delete;
+
+    //! Get the count of NUMA nodes
+    /*!
+        \return Count of NUMA nodes or 1 if NUMA topology is not available
+    */
+    static int NumaNodes();
+    //! Get CPUs of the given NUMA node
+    /*!
+        \param node - NUMA node
+        \return CPUs of the NUMA node or empty vector if the node is not available
+    */
+    static std::vector<int> NumaNodeCpus(int node);
+
+    //! Parse the CPU list
+    /*!
+        CPU list is a comma separated list of CPUs and CPU ranges in Linux
+        cpulist format (e.g. "0-3,8,10-11"). Invalid items are skipped.
+
+        \param cpus - CPU list
+        \return Parsed CPUs
+    */
+    static std::vector<int> ParseCpuList(const std::string& cpus);
+
+    //! Pin the current thread to the given CPUs
+    /*!
+        Only the first 64 CPUs could be used (CppCommon thread affinity limit).
+
+        \param cpus - CPUs to run the current thread on
+        \return Error code (empty if the thread was successfully pinned)
+    */
+    static std::error_code SetThreadAffinity(const std::vector<int>& cpus);
+    //! Prefer the given NUMA node for memory allocated by the current thread
+    /*!
+        \param node - NUMA node
+        \return Error code (empty if the NUMA node was successfully set)
+    */
+    static std::error_code SetThreadNumaNode(int node);
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_AFFINITY_H
@@ -12,7 +12,23 @@
 #define ASIO_STANDALONE
 #define ASIO_SEPARATE_COMPILATION
 
+#include <asio/version.hpp>
+
+// Asio io_uring backend (CPPSERVER_IO_URING build option) is available since Asio 1.21.0
+#if defined(CPPSERVER_IO_URING) && defined(__linux__)
+#if ASIO_VERSION < 102100
+#error "CPPSERVER_IO_URING build option requires Asio 1.21.0 or later"
+#endif
+#define ASIO_HAS_IO_URING
+#define ASIO_HAS_IO_URING_AS_DEFAULT
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include <asio.hpp>
 #include <asio/ssl.hpp>
@@ -44,6 +60,14 @@ enum class InternetProtocol
 */
 std::ostream& operator<<(std::ostream& stream, InternetProtocol protocol);
 
+//! Buffer
+/*!
+    Buffer is used to send the same data to many sessions or clients by
+    sharing it with std::shared_ptr<const Buffer> instead of copying it
+    into each send buffer.
+*/
+typedef std::vector<uint8_t> Buffer;
+
 } // namespace Asio
 
 } // namespace CppServer
@@ -0,0 +1,246 @@
+/*!
+    \file client_pool.h
+    \brief Client pool definition
+    \author Ivan Shynkarenka
+    \date 05.04.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_CLIENT_POOL_H
+#define CPPSERVER_ASIO_CLIENT_POOL_H
+
+#include "service_pool.h"
+#include "statistics.h"
+
+#include <limits>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace CppServer {
+namespace Asio {
+
+//! Load balancing
+enum class LoadBalancing
+{
+    LeastPending,                       //!< Select the connected client with the least bytes pending to send
+    PowerOfTwo                          //!< Select the client with less bytes pending to send of two random connected clients
+};
+
+//! Client pool
+/*!
+    Client pool keeps the given count of connected clients per server
+    endpoint and sends data through the client selected by the load
+    balancing. The load of the client is the size of its send buffer, so
+    the pool moves new data away from connections of a slow server which
+    does not drain sent data.
+
+    Clients which are not connected are never selected, so the failed
+    endpoint is out of rotation until one of its clients is connected
+    again (e.g. by the client automatic reconnect).
+
+    Clients are selected from the immutable snapshot of pool clients, so
+    sending through the pool does not take any lock.
+
+    Thread-safe.
+*/
+template <class TClient>
+class ClientPool
+{
+public:
+    //! Initialize client pool with a given Asio service and count of connections per endpoint
+    /*!
+        \param service - Asio service
+        \param connections - Count of connections per endpoint (default is 1)
+    */
+    explicit ClientPool(std::shared_ptr<Service> service, size_t connections = 1);
+    ClientPool(const ClientPool&) = delete;
+    ClientPool(ClientPool&&) = delete;
+    virtual ~ClientPool() = default;
+
+    ClientPool& operator=(const ClientPool&) = delete;
+    ClientPool& operator=(ClientPool&&) = delete;
+
+    //! Get the Asio service
+    std::shared_ptr<Service>& service() noexcept { return _service; }
+    //! Get the Asio service pool used to host pool clients
+    std::shared_ptr<ServicePool>& pool() noexcept { return _pool; }
+    //! Get the count of connections per endpoint
+    size_t connections() const noexcept { return _connections; }
+
+    //! Get the count of server endpoints
+    size_t endpoints() const;
+    //! Get the count of server endpoints with at least one connected client
+    size_t available_endpoints() const;
+    //! Get the count of pool clients
+    size_t clients() const;
+    //! Get the count of connected pool clients
+    size_t connected_clients() const;
+
+    //! Get the number of bytes sent by pool clients
+    uint64_t bytes_sent() const;
+    //! Get the number of bytes received by pool clients
+    uint64_t bytes_received() const;
+    //! Get the number of bytes pending in send buffers of pool clients
+    uint64_t bytes_pending() const;
+    //! Get the pool statistics
+    /*!
+        Messages of the pool statistics are send operations of the pool.
+        Errors are send operations rejected because no client is connected
+        or the selected client rejected the data.
+    */
+    const Statistics& statistics() const noexcept { return _statistics; }
+
+    //! Is the pool connected?
+    bool IsConnected() const noexcept { return _connected; }
+
+    //! Setup the Asio service pool to host pool clients
+    /*!
+        Each pool client is placed into the next service of the pool in
+        round-robin order. Without the service pool all clients are hosted
+        by the pool Asio service.
+
+        The service pool should be setup before endpoints are added.
+
+        \param pool - Asio service pool
+    */
+    void SetupServicePool(std::shared_ptr<ServicePool> pool) noexcept { _pool = pool; }
+
+    //! Get the option: load balancing
+    LoadBalancing option_load_balancing() const noexcept { return _balancing; }
+
+    //! Setup option: load balancing
+    /*!
+        Least pending balancing scans all pool clients for each send. Power
+        of two choices balancing compares only two random clients, so it is
+        cheaper for large pools and concurrent producers do not herd onto
+        the same least loaded client.
+
+        Default is least pending balancing.
+
+        \param balancing - Load balancing
+    */
+    void SetupLoadBalancing(LoadBalancing balancing) noexcept { _balancing = balancing; }
+
+    //! Add the server endpoint with a given IP address and port number
+    /*!
+        \param address - Server IP address
+        \param port - Server port number
+        \return 'true' if the endpoint was successfully added, 'false' if the endpoint is already added
+    */
+    bool AddEndpoint(const std::string& address, int port) { return AddEndpoint(asio::ip::tcp::endpoint(asio::ip::address::from_string(address), port)); }
+    //! Add the server endpoint
+    /*!
+        Creates clients of the endpoint and connects them if the pool is
+        connected.
+
+        \param endpoint - Server TCP endpoint
+        \return 'true' if the endpoint was successfully added, 'false' if the endpoint is already added
+    */
+    bool AddEndpoint(const asio::ip::tcp::endpoint& endpoint);
+    //! Remove the server endpoint
+    /*!
+        Disconnects clients of the endpoint and removes them from the pool.
+
+        \param endpoint - Server TCP endpoint
+        \return 'true' if the endpoint was successfully removed, 'false' if the endpoint was not found
+    */
+    bool RemoveEndpoint(const asio::ip::tcp::endpoint& endpoint);
+
+    //! Connect all pool clients
+    /*!
+        \return 'true' if the pool was successfully connected, 'false' if the pool is already connected
+    */
+    bool Connect();
+    //! Disconnect all pool clients
+    /*!
+        \return 'true' if the pool was successfully disconnected, 'false' if the pool is already disconnected
+    */
+    bool Disconnect();
+
+    //! Select the connected client by the load balancing
+    /*!
+        \return Selected client or nullptr if no client is connected
+    */
+    std::shared_ptr<TClient> Select() const;
+
+    //! Send data through the selected client
+    /*!
+        \param buffer - Buffer to send
+        \param size - Buffer size
+        \return Count of pending bytes in the send buffer of the selected client or 0 if the data was not sent
+    */
+    size_t Send(const void* buffer, size_t size);
+    //! Send a text string through the selected client
+    /*!
+        \param text - Text string to send
+        \return Count of pending bytes in the send buffer of the selected client or 0 if the data was not sent
+    */
+    size_t Send(const std::string& text) { return Send(text.data(), text.size()); }
+    //! Send the shared buffer through the selected client
+    /*!
+        \param buffer - Shared buffer to send
+        \return Count of pending bytes in the send buffer of the selected client or 0 if the data was not sent
+    */
+    size_t Send(std::shared_ptr<const Buffer> buffer);
+
+protected:
+    //! Create a new client of the given server endpoint
+    /*!
+        This method should be implemented to create clients of the pool
+        (e.g. to setup automatic reconnect of created clients).
+
+        \param service - Asio service of the client
+        \param endpoint - Server TCP endpoint
+        \return Created client
+    */
+    virtual std::shared_ptr<TClient> CreateClient(std::shared_ptr<Service>& service, const asio::ip::tcp::endpoint& endpoint) = 0;
+    //! Is the given client ready to send data?
+    /*!
+        \param client - Pool client
+        \return 'true' if the client is ready to send data, 'false' otherwise
+    */
+    virtual bool IsReady(const TClient& client) const noexcept = 0;
+
+private:
+    typedef std::vector<std::shared_ptr<TClient>> Clients;
+
+    // Asio service
+    std::shared_ptr<Service> _service;
+    // Asio service pool
+    std::shared_ptr<ServicePool> _pool;
+    size_t _connections;
+    std::atomic<bool> _connected;
+    // Pool options
+    LoadBalancing _balancing;
+    // Pool statistics
+    Statistics _statistics;
+    // Server endpoints and their clients
+    struct Endpoint
+    {
+        asio::ip::tcp::endpoint endpoint;
+        Clients clients;
+    };
+    mutable std::mutex _endpoints_lock;
+    std::vector<Endpoint> _endpoints;
+    // Snapshot of all pool clients to select from
+    std::shared_ptr<const Clients> _clients;
+
+    //! Get the snapshot of all pool clients
+    std::shared_ptr<const Clients> Snapshot() const { return std::atomic_load(&_clients); }
+    //! Publish the snapshot of all pool clients
+    /*!
+        Should be called under the endpoints lock.
+    */
+    void Publish();
+
+    //! Get the random number generator of the current thread
+    static std::minstd_rand& Random();
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#include "client_pool.inl"
+
+#endif // CPPSERVER_ASIO_CLIENT_POOL_H
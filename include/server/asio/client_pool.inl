@@ -0,0 +1,296 @@
+/*!
+    \file client_pool.inl
+    \brief Client pool inline implementation
+    \author Ivan Shynkarenka
+    \date 05.04.2017
+    \copyright MIT License
+*/
+
+namespace CppServer {
+namespace Asio {
+
+template <class TClient>
+inline ClientPool<TClient>::ClientPool(std::shared_ptr<Service> service, size_t connections)
+    : _service(service),
+      _connections(connections),
+      _connected(false),
+      _balancing(LoadBalancing::LeastPending),
+      _clients(std::make_shared<Clients>())
+{
+    assert((service != nullptr) && "ASIO service is invalid!");
+    if (service == nullptr)
+        throw CppCommon::ArgumentException("ASIO service is invalid!");
+
+    assert((connections > 0) && "Count of connections per endpoint should be greater than zero!");
+    if (connections == 0)
+        throw CppCommon::ArgumentException("Count of connections per endpoint should be greater than zero!");
+}
+
+template <class TClient>
+inline size_t ClientPool<TClient>::endpoints() const
+{
+    std::lock_guard<std::mutex> locker(_endpoints_lock);
+    return _endpoints.size();
+}
+
+template <class TClient>
+inline size_t ClientPool<TClient>::available_endpoints() const
+{
+    std::lock_guard<std::mutex> locker(_endpoints_lock);
+    size_t result = 0;
+    for (const auto& endpoint : _endpoints)
+        for (const auto& client : endpoint.clients)
+            if (IsReady(*client))
+            {
+                ++result;
+                break;
+            }
+    return result;
+}
+
+template <class TClient>
+inline size_t ClientPool<TClient>::clients() const
+{
+    return Snapshot()->size();
+}
+
+template <class TClient>
+inline size_t ClientPool<TClient>::connected_clients() const
+{
+    size_t result = 0;
+    for (const auto& client : *Snapshot())
+        if (IsReady(*client))
+            ++result;
+    return result;
+}
+
+template <class TClient>
+inline uint64_t ClientPool<TClient>::bytes_sent() const
+{
+    uint64_t result = 0;
+    for (const auto& client : *Snapshot())
+        result += client->bytes_sent();
+    return result;
+}
+
+template <class TClient>
+inline uint64_t ClientPool<TClient>::bytes_received() const
+{
+    uint64_t result = 0;
+    for (const auto& client : *Snapshot())
+        result += client->bytes_received();
+    return result;
+}
+
+template <class TClient>
+inline uint64_t ClientPool<TClient>::bytes_pending() const
+{
+    uint64_t result = 0;
+    for (const auto& client : *Snapshot())
+        result += client->bytes_pending();
+    return result;
+}
+
+template <class TClient>
+inline bool ClientPool<TClient>::AddEndpoint(const asio::ip::tcp::endpoint& endpoint)
+{
+    // Create clients of the endpoint out of the lock, so the client factory could use the pool
+    Endpoint entry;
+    entry.endpoint = endpoint;
+    entry.clients.reserve(_connections);
+    for (size_t i = 0; i < _connections; ++i)
+    {
+        auto& service = (_pool != nullptr) ? _pool->GetNextService() : _service;
+        entry.clients.emplace_back(CreateClient(service, endpoint));
+    }
+
+    bool connect;
+    {
+        std::lock_guard<std::mutex> locker(_endpoints_lock);
+
+        for (const auto& current : _endpoints)
+            if (current.endpoint == endpoint)
+                return false;
+
+        _endpoints.emplace_back(entry);
+        Publish();
+
+        connect = _connected;
+    }
+
+    // Connect clients of the connected pool
+    if (connect)
+        for (auto& client : entry.clients)
+            client->Connect();
+
+    return true;
+}
+
+template <class TClient>
+inline bool ClientPool<TClient>::RemoveEndpoint(const asio::ip::tcp::endpoint& endpoint)
+{
+    Clients removed;
+    {
+        std::lock_guard<std::mutex> locker(_endpoints_lock);
+
+        auto it = std::find_if(_endpoints.begin(), _endpoints.end(), [&endpoint](const Endpoint& current) { return current.endpoint == endpoint; });
+        if (it == _endpoints.end())
+            return false;
+
+        removed = std::move(it->clients);
+        _endpoints.erase(it);
+        Publish();
+    }
+
+    // Disconnect removed clients out of the lock, so their handlers could use the pool
+    for (auto& client : removed)
+        client->Disconnect();
+
+    return true;
+}
+
+template <class TClient>
+inline bool ClientPool<TClient>::Connect()
+{
+    std::shared_ptr<const Clients> clients;
+    {
+        std::lock_guard<std::mutex> locker(_endpoints_lock);
+
+        if (_connected)
+            return false;
+
+        _connected = true;
+        clients = Snapshot();
+    }
+
+    for (const auto& client : *clients)
+        client->Connect();
+
+    return true;
+}
+
+template <class TClient>
+inline bool ClientPool<TClient>::Disconnect()
+{
+    std::shared_ptr<const Clients> clients;
+    {
+        std::lock_guard<std::mutex> locker(_endpoints_lock);
+
+        if (!_connected)
+            return false;
+
+        _connected = false;
+        clients = Snapshot();
+    }
+
+    for (const auto& client : *clients)
+        client->Disconnect();
+
+    return true;
+}
+
+template <class TClient>
+inline std::shared_ptr<TClient> ClientPool<TClient>::Select() const
+{
+    auto clients = Snapshot();
+    size_t size = clients->size();
+    if (size == 0)
+        return nullptr;
+
+    auto& random = Random();
+
+    if ((_balancing == LoadBalancing::PowerOfTwo) && (size > 1))
+    {
+        // Compare two different random clients
+        size_t index1 = random() % size;
+        size_t index2 = (index1 + 1 + random() % (size - 1)) % size;
+        const auto& client1 = (*clients)[index1];
+        const auto& client2 = (*clients)[index2];
+        bool ready1 = IsReady(*client1);
+        bool ready2 = IsReady(*client2);
+        if (ready1 && ready2)
+            return (client1->bytes_pending() <= client2->bytes_pending()) ? client1 : client2;
+        if (ready1)
+            return client1;
+        if (ready2)
+            return client2;
+
+        // Both random clients are not connected, so scan all of them
+    }
+
+    // Scan from the random client, so equally loaded clients are selected evenly
+    std::shared_ptr<TClient> result;
+    uint64_t least = std::numeric_limits<uint64_t>::max();
+    size_t start = random() % size;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto& client = (*clients)[(start + i) % size];
+        if (!IsReady(*client))
+            continue;
+
+        uint64_t pending = client->bytes_pending();
+        if (pending < least)
+        {
+            result = client;
+            least = pending;
+
+            // Nothing is less loaded than the idle client
+            if (pending == 0)
+                break;
+        }
+    }
+    return result;
+}
+
+template <class TClient>
+inline size_t ClientPool<TClient>::Send(const void* buffer, size_t size)
+{
+    auto client = Select();
+    size_t pending = (client != nullptr) ? client->Send(buffer, size) : 0;
+
+    // Update the pool statistics
+    if (pending > 0)
+        _statistics.AddSent(size);
+    else
+        _statistics.AddError();
+
+    return pending;
+}
+
+template <class TClient>
+inline size_t ClientPool<TClient>::Send(std::shared_ptr<const Buffer> buffer)
+{
+    size_t size = (buffer != nullptr) ? buffer->size() : 0;
+
+    auto client = Select();
+    size_t pending = (client != nullptr) ? client->Send(std::move(buffer)) : 0;
+
+    // Update the pool statistics
+    if (pending > 0)
+        _statistics.AddSent(size);
+    else
+        _statistics.AddError();
+
+    return pending;
+}
+
+template <class TClient>
+inline void ClientPool<TClient>::Publish()
+{
+    auto clients = std::make_shared<Clients>();
+    clients->reserve(_endpoints.size() * _connections);
+    for (const auto& endpoint : _endpoints)
+        clients->insert(clients->end(), endpoint.clients.begin(), endpoint.clients.end());
+
+    std::atomic_store(&_clients, std::shared_ptr<const Clients>(clients));
+}
+
+template <class TClient>
+inline std::minstd_rand& ClientPool<TClient>::Random()
+{
+    thread_local std::minstd_rand random(std::random_device{}());
+    return random;
+}
+
+} // namespace Asio
+} // namespace CppServer
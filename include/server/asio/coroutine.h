@@ -0,0 +1,142 @@
+/*!
+    \file coroutine.h
+    \brief Asio coroutine awaitables definition
+    \author Ivan Shynkarenka
+    \date 01.04.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_COROUTINE_H
+#define CPPSERVER_ASIO_COROUTINE_H
+
+#include "asio.h"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define CPPSERVER_ASIO_COROUTINES
+#endif
+#endif
+
+#if defined(CPPSERVER_ASIO_COROUTINES)
+#include <coroutine>
+#include <exception>
+#endif
+
+namespace CppServer {
+namespace Asio {
+
+//! Asynchronous operation awaiter
+/*!
+    Awaiter keeps the state of the asynchronous operation awaited by the
+    coroutine. It is placed into the coroutine frame, so awaiting operations
+    does not allocate memory. Clients and sessions complete the awaiter in
+    their IO thread and resume the coroutine right there without any thread
+    hop.
+
+    Awaiter does not depend on C++20 coroutines, so the library keeps its
+    language standard and coroutines are available to applications compiled
+    with C++20.
+
+    Not thread-safe.
+*/
+struct AsyncAwaiter
+{
+    //! Address of the awaiting coroutine
+    void* coroutine;
+    //! Resume function of the awaiting coroutine
+    void (*resume)(void* coroutine);
+    //! Operation buffer
+    void* buffer;
+    //! Operation buffer size
+    size_t size;
+    //! Operation endpoint (datagram operations)
+    asio::ip::udp::endpoint* endpoint;
+    //! Operation target (e.g. count of bytes sent when the operation is completed)
+    uint64_t target;
+    //! Operation result
+    size_t result;
+
+    //! Complete the operation with the given result and resume the awaiting coroutine
+    void Complete(size_t value) { result = value; resume(coroutine); }
+};
+
+//! Asynchronous operation awaitable
+template <class TConnection, typename TResult = size_t>
+class AsyncAwaitable;
+
+#if defined(CPPSERVER_ASIO_COROUTINES)
+
+//! Asynchronous operation awaitable
+/*!
+    Awaitable starts the asynchronous operation of the client or session when
+    it is awaited. If the operation is completed at once (e.g. received data
+    is already buffered) the coroutine continues without suspension.
+
+    Not thread-safe. Operations should be awaited in the IO thread of the
+    client or session (e.g. from coroutines started in onConnected() handler
+    or resumed by previous operations).
+*/
+template <class TConnection, typename TResult>
+class AsyncAwaitable
+{
+public:
+    //! Start the operation
+    /*!
+        \return 'true' if the coroutine should be suspended until the operation is completed, 'false' if the operation is already completed
+    */
+    typedef bool (TConnection::*Start)(AsyncAwaiter& awaiter);
+
+    AsyncAwaitable(TConnection& connection, Start start, void* buffer = nullptr, size_t size = 0, asio::ip::udp::endpoint* endpoint = nullptr) noexcept
+        : _connection(connection),
+          _start(start),
+          _awaiter{ nullptr, nullptr, buffer, size, endpoint, 0, 0 }
+    {}
+    AsyncAwaitable(const AsyncAwaitable&) = delete;
+    AsyncAwaitable(AsyncAwaitable&&) = delete;
+    ~AsyncAwaitable() = default;
+
+    AsyncAwaitable& operator=(const AsyncAwaitable&) = delete;
+    AsyncAwaitable& operator=(AsyncAwaitable&&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> coroutine)
+    {
+        _awaiter.coroutine = coroutine.address();
+        _awaiter.resume = [](void* address) { std::coroutine_handle<>::from_address(address).resume(); };
+        return (_connection.*_start)(_awaiter);
+    }
+    TResult await_resume() const noexcept { return (TResult)_awaiter.result; }
+
+private:
+    TConnection& _connection;
+    Start _start;
+    AsyncAwaiter _awaiter;
+};
+
+//! Detached coroutine task
+/*!
+    Task is the return type of detached coroutines driving clients and
+    sessions. The coroutine starts immediately in the calling thread and its
+    frame is destroyed when the coroutine is finished. The coroutine should
+    keep the client or session alive (e.g. take its shared pointer argument).
+    Unhandled exceptions terminate the process.
+*/
+class Task
+{
+public:
+    struct promise_type
+    {
+        Task get_return_object() const noexcept { return Task(); }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+#endif
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_COROUTINE_H
@@ -0,0 +1,104 @@
+/*!
+    \file framed_ssl_client.h
+    \brief Framed SSL client definition
+    \author Ivan Shynkarenka
+    \date 22.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_FRAMED_SSL_CLIENT_H
+#define CPPSERVER_ASIO_FRAMED_SSL_CLIENT_H
+
+#include "framing.h"
+#include "ssl_client.h"
+
+namespace CppServer {
+namespace Asio {
+
+//! Framed SSL client
+/*!
+    Framed SSL client decodes received data into messages with the given
+    framing codec and encodes sent messages with the same codec.
+
+    All messages completed by a single receive operation are delivered one
+    after another straight from the receive buffer without copying. Only an
+    incomplete frame is kept in the receive buffer until more data arrives.
+
+    Thread-safe.
+*/
+template <class TCodec = LengthPrefixCodec>
+class FramedSSLClient : public SSLClient
+{
+public:
+    //! Initialize SSL client with a given Asio service, server IP address and port number
+    /*!
+        \param service - Asio service
+        \param context - SSL context
+        \param address - Server IP address
+        \param port - Server port number
+    */
+    explicit FramedSSLClient(std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, const std::string& address, int port) : SSLClient(service, context, address, port) {}
+    //! Initialize SSL client with a given Asio service and endpoint
+    /*!
+        \param service - Asio service
+        \param context - SSL context
+        \param endpoint - Server SSL endpoint
+    */
+    explicit FramedSSLClient(std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, const asio::ip::tcp::endpoint& endpoint) : SSLClient(service, context, endpoint) {}
+    FramedSSLClient(const FramedSSLClient&) = delete;
+    FramedSSLClient(FramedSSLClient&&) = default;
+    virtual ~FramedSSLClient() = default;
+
+    FramedSSLClient& operator=(const FramedSSLClient&) = delete;
+    FramedSSLClient& operator=(FramedSSLClient&&) = default;
+
+    //! Get the framing codec
+    /*!
+        The framing codec should be setup before the client is connected.
+    */
+    TCodec& codec() noexcept { return _codec; }
+
+    //! Send the message to the server
+    /*!
+        The message is encoded into a single frame and sent with a single
+        Send() call, so it is never interleaved with other messages.
+
+        \param buffer - Message buffer to send
+        \param size - Message buffer size
+        \return Count of pending bytes in the send buffer or 0 if the message was not sent
+    */
+    size_t SendMessage(const void* buffer, size_t size);
+    //! Send the text message to the server
+    /*!
+        \param text - Text message to send
+        \return Count of pending bytes in the send buffer or 0 if the message was not sent
+    */
+    size_t SendMessage(const std::string& text) { return SendMessage(text.data(), text.size()); }
+
+protected:
+    //! Handle message received notification
+    /*!
+        Notification is called for each complete message received from
+        the server.
+
+        The given buffer is a view of the message payload in the receive
+        buffer. It is valid only until the handler returns.
+
+        \param buffer - Message buffer
+        \param size - Message buffer size
+    */
+    virtual void onMessage(const void* buffer, size_t size) {}
+
+    //! Decode received frames and deliver them into onMessage()
+    size_t onReceived(const void* buffer, size_t size) override;
+
+private:
+    TCodec _codec;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#include "framed_ssl_client.inl"
+
+#endif // CPPSERVER_ASIO_FRAMED_SSL_CLIENT_H
@@ -0,0 +1,62 @@
+/*!
+    \file framed_ssl_session.inl
+    \brief Framed SSL session inline implementation
+    \author Ivan Shynkarenka
+    \date 22.03.2017
+    \copyright MIT License
+*/
+
+namespace CppServer {
+namespace Asio {
+
+template <class TServer, class TSession, class TCodec>
+inline FramedSSLSession<TServer, TSession, TCodec>::FramedSSLSession(std::shared_ptr<SSLServer<TServer, TSession>> server, asio::ip::tcp::socket&& socket, std::shared_ptr<asio::ssl::context> context)
+    : SSLSession<TServer, TSession>(server, std::move(socket), context)
+{
+}
+
+template <class TServer, class TSession, class TCodec>
+inline size_t FramedSSLSession<TServer, TSession, TCodec>::SendMessage(const void* buffer, size_t size)
+{
+    assert((buffer != nullptr) && "Pointer to the buffer should not be equal to 'nullptr'!");
+    if (buffer == nullptr)
+        return 0;
+
+    // Encode the message into the frame buffer reused by the current thread
+    thread_local Buffer frame;
+    frame.clear();
+    _codec.Encode(buffer, size, frame);
+
+    return this->Send(frame.data(), frame.size());
+}
+
+template <class TServer, class TSession, class TCodec>
+inline size_t FramedSSLSession<TServer, TSession, TCodec>::onReceived(const void* buffer, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)buffer;
+    size_t handled = 0;
+
+    // Deliver all frames completed by the received data
+    Frame frame;
+    FrameResult result;
+    while ((result = _codec.Decode(bytes + handled, size - handled, frame)) == FrameResult::Complete)
+    {
+        onMessage(frame.data, frame.size);
+        handled += frame.total;
+    }
+
+    // Disconnect the session with an invalid frame
+    if (result == FrameResult::Invalid)
+    {
+        std::error_code ec = asio::error::message_size;
+        this->onError(ec.value(), ec.category().name(), ec.message());
+        this->Disconnect();
+        return size;
+    }
+
+    // Keep the incomplete frame in the receive buffer
+    return handled;
+}
+
+} // namespace Asio
+} // namespace CppServer
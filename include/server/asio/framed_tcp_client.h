@@ -0,0 +1,102 @@
+/*!
+    \file framed_tcp_client.h
+    \brief Framed TCP client definition
+    \author Ivan Shynkarenka
+    \date 22.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_FRAMED_TCP_CLIENT_H
+#define CPPSERVER_ASIO_FRAMED_TCP_CLIENT_H
+
+#include "framing.h"
+#include "tcp_client.h"
+
+namespace CppServer {
+namespace Asio {
+
+//! Framed TCP client
+/*!
+    Framed TCP client decodes received data into messages with the given
+    framing codec and encodes sent messages with the same codec.
+
+    All messages completed by a single receive operation are delivered one
+    after another straight from the receive buffer without copying. Only an
+    incomplete frame is kept in the receive buffer until more data arrives.
+
+    Thread-safe.
+*/
+template <class TCodec = LengthPrefixCodec>
+class FramedTCPClient : public TCPClient
+{
+public:
+    //! Initialize TCP client with a given Asio service, server IP address and port number
+    /*!
+        \param service - Asio service
+        \param address - Server IP address
+        \param port - Server port number
+    */
+    explicit FramedTCPClient(std::shared_ptr<Service> service, const std::string& address, int port) : TCPClient(service, address, port) {}
+    //! Initialize TCP client with a given Asio service and endpoint
+    /*!
+        \param service - Asio service
+        \param endpoint - Server TCP endpoint
+    */
+    explicit FramedTCPClient(std::shared_ptr<Service> service, const asio::ip::tcp::endpoint& endpoint) : TCPClient(service, endpoint) {}
+    FramedTCPClient(const FramedTCPClient&) = delete;
+    FramedTCPClient(FramedTCPClient&&) = default;
+    virtual ~FramedTCPClient() = default;
+
+    FramedTCPClient& operator=(const FramedTCPClient&) = delete;
+    FramedTCPClient& operator=(FramedTCPClient&&) = default;
+
+    //! Get the framing codec
+    /*!
+        The framing codec should be setup before the client is connected.
+    */
+    TCodec& codec() noexcept { return _codec; }
+
+    //! Send the message to the server
+    /*!
+        The message is encoded into a single frame and sent with a single
+        Send() call, so it is never interleaved with other messages.
+
+        \param buffer - Message buffer to send
+        \param size - Message buffer size
+        \return Count of pending bytes in the send buffer or 0 if the message was not sent
+    */
+    size_t SendMessage(const void* buffer, size_t size);
+    //! Send the text message to the server
+    /*!
+        \param text - Text message to send
+        \return Count of pending bytes in the send buffer or 0 if the message was not sent
+    */
+    size_t SendMessage(const std::string& text) { return SendMessage(text.data(), text.size()); }
+
+protected:
+    //! Handle message received notification
+    /*!
+        Notification is called for each complete message received from
+        the server.
+
+        The given buffer is a view of the message payload in the receive
+        buffer. It is valid only until the handler returns.
+
+        \param buffer - Message buffer
+        \param size - Message buffer size
+    */
+    virtual void onMessage(const void* buffer, size_t size) {}
+
+    //! Decode received frames and deliver them into onMessage()
+    size_t onReceived(const void* buffer, size_t size) override;
+
+private:
+    TCodec _codec;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#include "framed_tcp_client.inl"
+
+#endif // CPPSERVER_ASIO_FRAMED_TCP_CLIENT_H
@@ -0,0 +1,56 @@
+/*!
+    \file framed_tcp_client.inl
+    \brief Framed TCP client inline implementation
+    \author Ivan Shynkarenka
+    \date 22.03.2017
+    \copyright MIT License
+*/
+
+namespace CppServer {
+namespace Asio {
+
+template <class TCodec>
+inline size_t FramedTCPClient<TCodec>::SendMessage(const void* buffer, size_t size)
+{
+    assert((buffer != nullptr) && "Pointer to the buffer should not be equal to 'nullptr'!");
+    if (buffer == nullptr)
+        return 0;
+
+    // Encode the message into the frame buffer reused by the current thread
+    thread_local Buffer frame;
+    frame.clear();
+    _codec.Encode(buffer, size, frame);
+
+    return Send(frame.data(), frame.size());
+}
+
+template <class TCodec>
+inline size_t FramedTCPClient<TCodec>::onReceived(const void* buffer, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)buffer;
+    size_t handled = 0;
+
+    // Deliver all frames completed by the received data
+    Frame frame;
+    FrameResult result;
+    while ((result = _codec.Decode(bytes + handled, size - handled, frame)) == FrameResult::Complete)
+    {
+        onMessage(frame.data, frame.size);
+        handled += frame.total;
+    }
+
+    // Disconnect the client with an invalid frame
+    if (result == FrameResult::Invalid)
+    {
+        std::error_code ec = asio::error::message_size;
+        onError(ec.value(), ec.category().name(), ec.message());
+        Disconnect();
+        return size;
+    }
+
+    // Keep the incomplete frame in the receive buffer
+    return handled;
+}
+
+} // namespace Asio
+} // namespace CppServer
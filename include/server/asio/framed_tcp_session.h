@@ -0,0 +1,95 @@
+/*!
+    \file framed_tcp_session.h
+    \brief Framed TCP session definition
+    \author Ivan Shynkarenka
+    \date 22.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_FRAMED_TCP_SESSION_H
+#define CPPSERVER_ASIO_FRAMED_TCP_SESSION_H
+
+#include "framing.h"
+#include "tcp_server.h"
+
+namespace CppServer {
+namespace Asio {
+
+//! Framed TCP session
+/*!
+    Framed TCP session decodes received data into messages with the given
+    framing codec and encodes sent messages with the same codec.
+
+    All messages completed by a single receive operation are delivered one
+    after another straight from the receive buffer without copying. Only an
+    incomplete frame is kept in the receive buffer until more data arrives.
+
+    Thread-safe.
+*/
+template <class TServer, class TSession, class TCodec = LengthPrefixCodec>
+class FramedTCPSession : public TCPSession<TServer, TSession>
+{
+public:
+    //! Initialize the session with a given server
+    /*!
+        \param server - Connected server
+        \param socket - Connected socket
+    */
+    explicit FramedTCPSession(std::shared_ptr<TCPServer<TServer, TSession>> server, asio::ip::tcp::socket&& socket);
+    FramedTCPSession(const FramedTCPSession&) = delete;
+    FramedTCPSession(FramedTCPSession&&) = default;
+    virtual ~FramedTCPSession() = default;
+
+    FramedTCPSession& operator=(const FramedTCPSession&) = delete;
+    FramedTCPSession& operator=(FramedTCPSession&&) = default;
+
+    //! Get the framing codec
+    /*!
+        The framing codec should be setup before the session is connected.
+    */
+    TCodec& codec() noexcept { return _codec; }
+
+    //! Send the message into the session
+    /*!
+        The message is encoded into a single frame and sent with a single
+        Send() call, so it is never interleaved with other messages.
+
+        \param buffer - Message buffer to send
+        \param size - Message buffer size
+        \return Count of pending bytes in the send buffer or 0 if the message was not sent
+    */
+    size_t SendMessage(const void* buffer, size_t size);
+    //! Send the text message into the session
+    /*!
+        \param text - Text message to send
+        \return Count of pending bytes in the send buffer or 0 if the message was not sent
+    */
+    size_t SendMessage(const std::string& text) { return SendMessage(text.data(), text.size()); }
+
+protected:
+    //! Handle message received notification
+    /*!
+        Notification is called for each complete message received from
+        the client.
+
+        The given buffer is a view of the message payload in the receive
+        buffer. It is valid only until the handler returns.
+
+        \param buffer - Message buffer
+        \param size - Message buffer size
+    */
+    virtual void onMessage(const void* buffer, size_t size) {}
+
+    //! Decode received frames and deliver them into onMessage()
+    size_t onReceived(const void* buffer, size_t size) override;
+
+private:
+    TCodec _codec;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#include "framed_tcp_session.inl"
+
+#endif // CPPSERVER_ASIO_FRAMED_TCP_SESSION_H
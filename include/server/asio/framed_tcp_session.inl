@@ -0,0 +1,62 @@
+/*!
+    \file framed_tcp_session.inl
+    \brief Framed TCP session inline implementation
+    \author Ivan Shynkarenka
+    \date 22.03.2017
+    \copyright MIT License
+*/
+
+namespace CppServer {
+namespace Asio {
+
+template <class TServer, class TSession, class TCodec>
+inline FramedTCPSession<TServer, TSession, TCodec>::FramedTCPSession(std::shared_ptr<TCPServer<TServer, TSession>> server, asio::ip::tcp::socket&& socket)
+    : TCPSession<TServer, TSession>(server, std::move(socket))
+{
+}
+
+template <class TServer, class TSession, class TCodec>
+inline size_t FramedTCPSession<TServer, TSession, TCodec>::SendMessage(const void* buffer, size_t size)
+{
+    assert((buffer != nullptr) && "Pointer to the buffer should not be equal to 'nullptr'!");
+    if (buffer == nullptr)
+        return 0;
+
+    // Encode the message into the frame buffer reused by the current thread
+    thread_local Buffer frame;
+    frame.clear();
+    _codec.Encode(buffer, size, frame);
+
+    return this->Send(frame.data(), frame.size());
+}
+
+template <class TServer, class TSession, class TCodec>
+inline size_t FramedTCPSession<TServer, TSession, TCodec>::onReceived(const void* buffer, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)buffer;
+    size_t handled = 0;
+
+    // Deliver all frames completed by the received data
+    Frame frame;
+    FrameResult result;
+    while ((result = _codec.Decode(bytes + handled, size - handled, frame)) == FrameResult::Complete)
+    {
+        onMessage(frame.data, frame.size);
+        handled += frame.total;
+    }
+
+    // Disconnect the session with an invalid frame
+    if (result == FrameResult::Invalid)
+    {
+        std::error_code ec = asio::error::message_size;
+        this->onError(ec.value(), ec.category().name(), ec.message());
+        this->Disconnect();
+        return size;
+    }
+
+    // Keep the incomplete frame in the receive buffer
+    return handled;
+}
+
+} // namespace Asio
+} // namespace CppServer
@@ -0,0 +1,158 @@
+/*!
+    \file framing.h
+    \brief Message framing codecs definition
+    \author Ivan Shynkarenka
+    \date 22.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_FRAMING_H
+#define CPPSERVER_ASIO_FRAMING_H
+
+#include "asio.h"
+
+#include <string>
+
+namespace CppServer {
+namespace Asio {
+
+//! Frame decode result
+enum class FrameResult
+{
+    Complete,           //!< Complete frame was decoded
+    Incomplete,         //!< More data is required to decode the frame
+    Invalid             //!< Frame is invalid (e.g. exceeds the frame size limit)
+};
+
+//! Decoded frame
+/*!
+    Decoded frame is a view into the decoded buffer.
+*/
+struct Frame
+{
+    const uint8_t* data;    //!< Frame payload
+    size_t size;            //!< Frame payload size
+    size_t total;           //!< Whole frame size including the frame header or delimiter
+};
+
+//! Length-prefixed framing codec
+/*!
+    Each frame is a 32-bit payload size in network byte order followed by
+    the payload.
+
+    Codec is used by framed sessions and clients to decode frames from the
+    receive buffer and to encode messages to send. Any other codec should
+    provide the same Decode() and Encode() methods.
+
+    Not thread-safe.
+*/
+class LengthPrefixCodec
+{
+public:
+    //! Initialize length-prefixed codec with a given frame size limit
+    /*!
+        \param limit - Frame payload size limit in bytes (default is 16 MB)
+    */
+    explicit LengthPrefixCodec(size_t limit = 16777216) : _limit(limit) {}
+    LengthPrefixCodec(const LengthPrefixCodec&) = default;
+    LengthPrefixCodec(LengthPrefixCodec&&) = default;
+    ~LengthPrefixCodec() = default;
+
+    LengthPrefixCodec& operator=(const LengthPrefixCodec&) = default;
+    LengthPrefixCodec& operator=(LengthPrefixCodec&&) = default;
+
+    //! Get the frame payload size limit
+    size_t limit() const noexcept { return _limit; }
+
+    //! Setup the frame payload size limit
+    /*!
+        \param limit - Frame payload size limit in bytes
+    */
+    void SetupLimit(size_t limit) noexcept { _limit = limit; }
+
+    //! Decode the first frame of the given buffer
+    /*!
+        \param buffer - Buffer to decode
+        \param size - Buffer size
+        \param frame - Decoded frame
+        \return Frame decode result
+    */
+    FrameResult Decode(const uint8_t* buffer, size_t size, Frame& frame) const;
+    //! Encode the given message as a new frame and append it to the output buffer
+    /*!
+        \param buffer - Message buffer
+        \param size - Message buffer size
+        \param output - Output buffer
+    */
+    void Encode(const void* buffer, size_t size, Buffer& output) const;
+
+private:
+    static const size_t HEADER = 4;
+
+    size_t _limit;
+};
+
+//! Delimiter framing codec
+/*!
+    Each frame is a payload followed by the delimiter (e.g. a text line
+    followed by "\n").
+
+    Not thread-safe.
+*/
+class DelimiterCodec
+{
+public:
+    //! Initialize delimiter codec with a given delimiter and frame size limit
+    /*!
+        \param delimiter - Frame delimiter (default is "\n")
+        \param limit - Frame payload size limit in bytes (default is 16 MB)
+    */
+    explicit DelimiterCodec(const std::string& delimiter = "\n", size_t limit = 16777216);
+    DelimiterCodec(const DelimiterCodec&) = default;
+    DelimiterCodec(DelimiterCodec&&) = default;
+    ~DelimiterCodec() = default;
+
+    DelimiterCodec& operator=(const DelimiterCodec&) = default;
+    DelimiterCodec& operator=(DelimiterCodec&&) = default;
+
+    //! Get the frame delimiter
+    const std::string& delimiter() const noexcept { return _delimiter; }
+    //! Get the frame payload size limit
+    size_t limit() const noexcept { return _limit; }
+
+    //! Setup the frame delimiter
+    /*!
+        \param delimiter - Frame delimiter
+    */
+    void SetupDelimiter(const std::string& delimiter);
+    //! Setup the frame payload size limit
+    /*!
+        \param limit - Frame payload size limit in bytes
+    */
+    void SetupLimit(size_t limit) noexcept { _limit = limit; }
+
+    //! Decode the first frame of the given buffer
+    /*!
+        \param buffer - Buffer to decode
+        \param size - Buffer size
+        \param frame - Decoded frame
+        \return Frame decode result
+    */
+    FrameResult Decode(const uint8_t* buffer, size_t size, Frame& frame) const;
+    //! Encode the given message as a new frame and append it to the output buffer
+    /*!
+        \param buffer - Message buffer
+        \param size - Message buffer size
+        \param output - Output buffer
+    */
+    void Encode(const void* buffer, size_t size, Buffer& output) const;
+
+private:
+    std::string _delimiter;
+    size_t _limit;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_FRAMING_H
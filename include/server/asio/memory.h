@@ -0,0 +1,162 @@
+/*!
+    \file memory.h
+    \brief Asio handler memory definition
+    \author Ivan Shynkarenka
+    \date 31.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_MEMORY_H
+#define CPPSERVER_ASIO_MEMORY_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace CppServer {
+namespace Asio {
+
+//! Asio handler storage
+/*!
+    Handler storage is a small memory block to recycle memory of asynchronous
+    operations. Clients and sessions own a storage for each chain of their
+    asynchronous operations (e.g. receive and send), so the next operation of
+    the chain reuses the memory of the previous one and steady-state IO does
+    not allocate heap memory. If the storage is in use or the operation does
+    not fit into it, memory is allocated from the heap.
+
+    Not thread-safe. Operations of the same storage should not overlap.
+*/
+class HandlerStorage
+{
+public:
+    //! Storage size in bytes
+    static const size_t SIZE = 1024;
+
+    HandlerStorage() noexcept : _in_use(false) {}
+    HandlerStorage(const HandlerStorage&) = delete;
+    HandlerStorage(HandlerStorage&&) = delete;
+    ~HandlerStorage() = default;
+
+    HandlerStorage& operator=(const HandlerStorage&) = delete;
+    HandlerStorage& operator=(HandlerStorage&&) = delete;
+
+    //! Allocate memory for the asynchronous operation
+    /*!
+        \param size - Size of the memory block
+        \return Pointer to the allocated memory block
+    */
+    void* allocate(size_t size);
+    //! Deallocate memory of the asynchronous operation
+    /*!
+        \param ptr - Pointer to the memory block
+    */
+    void deallocate(void* ptr);
+
+private:
+    typename std::aligned_storage<SIZE>::type _storage;
+    bool _in_use;
+};
+
+//! Asio handler allocator
+/*!
+    Handler allocator is a standard allocator over the handler storage.
+
+    Not thread-safe.
+*/
+template <typename T>
+class HandlerAllocator
+{
+    template <typename>
+    friend class HandlerAllocator;
+
+public:
+    typedef T value_type;
+
+    explicit HandlerAllocator(HandlerStorage& storage) noexcept : _storage(storage) {}
+    template <typename U>
+    HandlerAllocator(const HandlerAllocator<U>& allocator) noexcept : _storage(allocator._storage) {}
+    HandlerAllocator(const HandlerAllocator&) noexcept = default;
+    HandlerAllocator(HandlerAllocator&&) noexcept = default;
+    ~HandlerAllocator() = default;
+
+    HandlerAllocator& operator=(const HandlerAllocator&) noexcept = delete;
+    HandlerAllocator& operator=(HandlerAllocator&&) noexcept = delete;
+
+    //! Allocate memory for the given count of values
+    T* allocate(size_t n) { return static_cast<T*>(_storage.allocate(sizeof(T) * n)); }
+    //! Deallocate memory of values
+    void deallocate(T* ptr, size_t) { _storage.deallocate(ptr); }
+
+    template <typename U>
+    friend bool operator==(const HandlerAllocator<T>& a1, const HandlerAllocator<U>& a2) noexcept
+    { return &a1._storage == &a2._storage; }
+    template <typename U>
+    friend bool operator!=(const HandlerAllocator<T>& a1, const HandlerAllocator<U>& a2) noexcept
+    { return &a1._storage != &a2._storage; }
+
+private:
+    HandlerStorage& _storage;
+};
+
+//! Asio allocate handler wrapper
+/*!
+    Allocate handler wrapper places memory of the asynchronous operation into
+    the handler storage. It supports both Asio allocation customization points:
+    the associated allocator and asio_handler_allocate() hooks which are also
+    forwarded by strand wrapped handlers and SSL stream operations.
+
+    Not thread-safe.
+*/
+template <typename THandler>
+class AllocateHandler
+{
+public:
+    typedef HandlerAllocator<THandler> allocator_type;
+
+    AllocateHandler(HandlerStorage& storage, THandler handler) noexcept
+        : _storage(storage),
+          _handler(std::move(handler))
+    {}
+    AllocateHandler(const AllocateHandler&) = default;
+    AllocateHandler(AllocateHandler&&) = default;
+    ~AllocateHandler() = default;
+
+    AllocateHandler& operator=(const AllocateHandler&) = delete;
+    AllocateHandler& operator=(AllocateHandler&&) = delete;
+
+    //! Get the handler allocator
+    allocator_type get_allocator() const noexcept { return allocator_type(_storage); }
+
+    //! Wrap the handler
+    template <typename ...Args>
+    void operator()(Args&&... args) { _handler(std::forward<Args>(args)...); }
+
+    //! Allocate memory of the asynchronous operation (Asio allocation hook)
+    friend void* asio_handler_allocate(std::size_t size, AllocateHandler<THandler>* handler)
+    { return handler->_storage.allocate(size); }
+    //! Deallocate memory of the asynchronous operation (Asio allocation hook)
+    friend void asio_handler_deallocate(void* ptr, std::size_t, AllocateHandler<THandler>* handler)
+    { handler->_storage.deallocate(ptr); }
+
+private:
+    HandlerStorage& _storage;
+    THandler _handler;
+};
+
+//! Helper function to wrap a handler object to add custom allocation
+/*!
+    \param storage - Handler storage
+    \param handler - Handler object
+    \return Allocate handler wrapper
+*/
+template <typename THandler>
+AllocateHandler<THandler> make_alloc_handler(HandlerStorage& storage, THandler handler);
+
+} // namespace Asio
+} // namespace CppServer
+
+#include "memory.inl"
+
+#endif // CPPSERVER_ASIO_MEMORY_H
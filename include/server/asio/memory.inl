@@ -0,0 +1,41 @@
+/*!
+    \file memory.inl
+    \brief Asio handler memory inline implementation
+    \author Ivan Shynkarenka
+    \date 31.03.2017
+    \copyright MIT License
+*/
+
+namespace CppServer {
+namespace Asio {
+
+inline void* HandlerStorage::allocate(size_t size)
+{
+    // Use the storage if it is free and large enough
+    if (!_in_use && (size <= sizeof(_storage)))
+    {
+        _in_use = true;
+        return &_storage;
+    }
+
+    // Otherwise fall back to the heap
+    return ::operator new(size);
+}
+
+inline void HandlerStorage::deallocate(void* ptr)
+{
+    // Free the storage or release the heap memory
+    if (ptr == &_storage)
+        _in_use = false;
+    else
+        ::operator delete(ptr);
+}
+
+template <typename THandler>
+inline AllocateHandler<THandler> make_alloc_handler(HandlerStorage& storage, THandler handler)
+{
+    return AllocateHandler<THandler>(storage, std::move(handler));
+}
+
+} // namespace Asio
+} // namespace CppServer
@@ -0,0 +1,84 @@
+/*!
+    \file reconnect.h
+    \brief Reconnect policy definition
+    \author Ivan Shynkarenka
+    \date 03.04.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_RECONNECT_H
+#define CPPSERVER_ASIO_RECONNECT_H
+
+#include <chrono>
+#include <cstddef>
+#include <random>
+
+namespace CppServer {
+namespace Asio {
+
+//! Reconnect policy
+/*!
+    Reconnect policy computes delays of automatic reconnect attempts of the
+    client. The backoff of the attempt starts from the minimal delay and is
+    doubled with each next attempt in a row up to the maximal delay. The delay
+    of the attempt is a random value between a half and the whole backoff, so
+    clients disconnected at once (e.g. by the restarted server) do not come
+    back at once.
+
+    Not thread-safe.
+*/
+class ReconnectPolicy
+{
+public:
+    ReconnectPolicy();
+    ReconnectPolicy(const ReconnectPolicy&) = delete;
+    ReconnectPolicy(ReconnectPolicy&&) = default;
+    ~ReconnectPolicy() = default;
+
+    ReconnectPolicy& operator=(const ReconnectPolicy&) = delete;
+    ReconnectPolicy& operator=(ReconnectPolicy&&) = default;
+
+    //! Get the minimal reconnect delay
+    const std::chrono::steady_clock::duration& delay_min() const noexcept { return _delay_min; }
+    //! Get the maximal reconnect delay
+    const std::chrono::steady_clock::duration& delay_max() const noexcept { return _delay_max; }
+    //! Get the limit of reconnect attempts in a row
+    size_t attempts() const noexcept { return _attempts; }
+    //! Get the count of reconnect attempts in a row
+    size_t attempt() const noexcept { return _attempt; }
+
+    //! Is automatic reconnect enabled?
+    bool enabled() const noexcept { return _delay_min.count() > 0; }
+
+    //! Setup the reconnect policy
+    /*!
+        \param min - Minimal reconnect delay (0 - automatic reconnect is disabled)
+        \param max - Maximal reconnect delay
+        \param attempts - Limit of reconnect attempts in a row (0 - unlimited)
+    */
+    void Setup(const std::chrono::steady_clock::duration& min, const std::chrono::steady_clock::duration& max, size_t attempts) noexcept;
+
+    //! Get the delay of the next reconnect attempt
+    /*!
+        When the limit of reconnect attempts is reached the policy is reset,
+        so the next connect starts reconnect attempts from the beginning.
+
+        \param delay - Delay of the next reconnect attempt
+        \return 'true' if the client should reconnect after the delay, 'false' if automatic reconnect is disabled or the limit of attempts is reached
+    */
+    bool Next(std::chrono::steady_clock::duration& delay);
+    //! Reset reconnect attempts (e.g. when the client is connected)
+    void Reset() noexcept { _attempt = 0; }
+
+private:
+    std::chrono::steady_clock::duration _delay_min;
+    std::chrono::steady_clock::duration _delay_max;
+    size_t _attempts;
+    size_t _attempt;
+    std::minstd_rand _random;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_RECONNECT_H
@@ -0,0 +1,254 @@
+/*!
+    \file send_queue.h
+    \brief Lock-free send queue definition
+    \author Ivan Shynkarenka
+    \date 24.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_SEND_QUEUE_H
+#define CPPSERVER_ASIO_SEND_QUEUE_H
+
+#include "asio.h"
+
+#include <atomic>
+#include <vector>
+
+namespace CppServer {
+namespace Asio {
+
+//! @cond INTERNALS
+
+//! Send queue node
+/*!
+    Send queue node refers either to the copied data placed in the same
+    allocation right after the node (shared == nullptr) or to the content
+    of the shared buffer. Producers append copied data into the open node
+    of the queue head by reserving its space and committing it after the
+    copy, until the consumer closes the node to dequeue it.
+*/
+struct SendNode
+{
+    std::atomic<SendNode*> next;
+    std::shared_ptr<const Buffer> shared;
+    const uint8_t* data;
+    size_t size;
+    size_t capacity;
+    std::atomic<size_t> reserved;
+    std::atomic<size_t> committed;
+};
+
+//! Send queue
+/*!
+    Send queue is a lock-free multi-producer single-consumer queue of send
+    segments. It is an intrusive linked list with a stub node by Dmitry Vyukov:
+    producers enqueue nodes from any thread with a single atomic exchange and
+    the only consumer (the IO thread of the session or client) dequeues them.
+
+    Copied buffers are appended into the node of the queue head while it
+    has enough room, so a burst of small sends takes a few nodes instead of
+    a node per send. The node following a filled one has the doubled
+    capacity up to APPEND_CAPACITY.
+
+    Dequeue() could return nullptr while a producer has exchanged the queue
+    head but not yet linked its node or has not yet copied its appended
+    data. The consumer should try again later.
+
+    Last released nodes are kept as spare ones and reused by next enqueued
+    buffers which fit into them, so the steady flow of sends does not
+    allocate heap memory. Released nodes are reused only when no producer
+    is appending, because producers could still refer them as the head.
+
+    Thread-safe for producers, not thread-safe for the consumer.
+*/
+class SendQueue
+{
+public:
+    //! Maximal capacity of nodes grown by appended buffers
+    static const size_t APPEND_CAPACITY = 16 * 1024;
+
+    SendQueue();
+    SendQueue(const SendQueue&) = delete;
+    SendQueue(SendQueue&&) = delete;
+    ~SendQueue();
+
+    SendQueue& operator=(const SendQueue&) = delete;
+    SendQueue& operator=(SendQueue&&) = delete;
+
+    //! Enqueue a copy of the given buffer (producers)
+    /*!
+        \param buffer - Buffer to enqueue
+        \param size - Buffer size
+    */
+    void Enqueue(const void* buffer, size_t size);
+    //! Enqueue the shared buffer without copying its content (producers)
+    /*!
+        \param buffer - Shared buffer to enqueue
+    */
+    void Enqueue(std::shared_ptr<const Buffer> buffer);
+
+    //! Dequeue the next node (consumer)
+    /*!
+        Dequeued node should be released with Release() method.
+
+        \return Dequeued node or nullptr if no node is ready to dequeue
+    */
+    SendNode* Dequeue();
+
+    //! Release the dequeued node (consumer)
+    /*!
+        \param node - Node to release
+    */
+    void Release(SendNode* node);
+
+private:
+    // Producers push into the head, the consumer pops from the tail
+    std::atomic<SendNode*> _head;
+    SendNode* _tail;
+    SendNode _stub;
+    // Spare nodes released by the consumer and reused by producers
+    static const size_t SPARES = 4;
+    std::atomic<SendNode*> _spares[SPARES];
+    // Count of producers appending into the head node and nodes released
+    // while they could refer them
+    std::atomic<size_t> _appenders;
+    SendNode* _retired;
+
+    // Reserved size flag of the node closed for appending
+    static const size_t CLOSED = ~(~size_t(0) >> 1);
+
+    //! Acquire a spare node or allocate a new node with the given data capacity
+    SendNode* Acquire(size_t capacity);
+    //! Push the node into the queue head
+    void Push(SendNode* node);
+    //! Close the node for appending before it is dequeued
+    /*!
+        \param node - Node to close
+        \return 'true' if all data appended into the node is copied, 'false' if some producer is still copying it
+    */
+    bool Close(SendNode* node);
+    //! Reuse retired nodes if no producer is appending
+    void Reclaim();
+    //! Keep the node as a spare one or free it
+    void Recycle(SendNode* node);
+    //! Free the node memory
+    static void Free(SendNode* node);
+};
+
+//! Send buffers
+/*!
+    Send buffers is a buffer sequence which refers to gathered send segments
+    without copying them. Asynchronous send operations copy their buffer
+    sequence, so the send buffers keep them from allocating a copy of the
+    segments vector. Segments should stay unchanged until the send operation
+    is completed.
+
+    Not thread-safe.
+*/
+class SendBuffers
+{
+public:
+    typedef asio::const_buffer value_type;
+    typedef std::vector<asio::const_buffer>::const_iterator const_iterator;
+
+    explicit SendBuffers(const std::vector<asio::const_buffer>& buffers) noexcept : _buffers(&buffers) {}
+
+    //! Get the first segment iterator
+    const_iterator begin() const noexcept { return _buffers->begin(); }
+    //! Get the last segment iterator
+    const_iterator end() const noexcept { return _buffers->end(); }
+
+private:
+    const std::vector<asio::const_buffer>* _buffers;
+};
+
+//! Send flush list
+/*!
+    Send flush list keeps nodes dequeued from the send queue until they are
+    completely sent and gathers pending segments from its head into buffers
+    of a single send operation. Each send operation gathers a bounded part
+    of the pending data, so a long backlog of small sends is never walked
+    as a whole:
+    - at most MAX_SEGMENTS segments, because Asio does not gather more
+      buffers into a single socket operation;
+    - segments smaller than COALESCE_SIZE are copied together into the
+      coalesce buffer of COALESCE_CAPACITY bytes, so small sends take a few
+      large socket operations (and SSL records) instead of one per send.
+    Larger segments are referred without copying.
+
+    Not thread-safe (the consumer of the send queue only).
+*/
+class SendFlush
+{
+public:
+    //! Maximal count of segments gathered for a single send operation
+    static const size_t MAX_SEGMENTS = 64;
+    //! Segments smaller than this size are copied into the coalesce buffer
+    static const size_t COALESCE_SIZE = 1024;
+    //! Capacity of the coalesce buffer
+    static const size_t COALESCE_CAPACITY = 64 * 1024;
+
+    SendFlush() noexcept : _index(0), _offset(0) {}
+    SendFlush(const SendFlush&) = delete;
+    SendFlush(SendFlush&&) = delete;
+    ~SendFlush() = default;
+
+    SendFlush& operator=(const SendFlush&) = delete;
+    SendFlush& operator=(SendFlush&&) = delete;
+
+    //! Is the flush list empty?
+    bool empty() const noexcept { return _index == _nodes.size(); }
+
+    //! Dequeue all nodes enqueued by producers into the flush list
+    /*!
+        \param queue - Send queue
+    */
+    void Fetch(SendQueue& queue);
+
+    //! Gather pending segments for a single send operation
+    /*!
+        Gathered segments stay valid until the next call of Gather(), so
+        it should not be called until the send operation is completed.
+
+        \param limit - Send size limit (0 - unlimited)
+        \return Send buffers with gathered segments
+    */
+    SendBuffers Gather(size_t limit);
+
+    //! Consume sent bytes and release completely sent nodes
+    /*!
+        \param queue - Send queue
+        \param size - Sent size
+    */
+    void Consume(SendQueue& queue, size_t size);
+
+    //! Release all unsent nodes of the flush list and the send queue
+    /*!
+        \param queue - Send queue
+        \return Unsent size
+    */
+    size_t Clear(SendQueue& queue);
+
+    //! Keep the capacity of flush buffers only up to the given size
+    /*!
+        \param size - Maximal buffer size
+    */
+    void Shrink(size_t size);
+
+private:
+    // Dequeued nodes. Completely sent nodes before the head index are
+    // removed from the front of the list once they take its half.
+    std::vector<SendNode*> _nodes;
+    size_t _index;
+    size_t _offset;
+    // Gathered segments and the coalesce buffer
+    std::vector<asio::const_buffer> _buffers;
+    std::vector<uint8_t> _coalesce;
+};
+
+//! @endcond
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_SEND_QUEUE_H
@@ -9,14 +9,20 @@
 #ifndef CPPSERVER_ASIO_SERVICE_H
 #define CPPSERVER_ASIO_SERVICE_H
 
+#include "affinity.h"
 #include "asio.h"
+#include "timer_wheel.h"
 
 #include "threads/thread.h"
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace CppServer {
 namespace Asio {
@@ -24,8 +30,27 @@ namespace Asio {
 //! Asio service
 /*!
     Asio service is used to host all clients/servers based on Asio C++ library.
-    It is implemented based on Asio C++ Library and use a separate thread to
-    perform all asynchronous IO operations and communications.
+    It is implemented based on Asio C++ Library and use one or several working
+    threads to perform all asynchronous IO operations and communications.
+
+    Polling loop mode could be adaptive. Adaptive polling loop busy-polls
+    pending handlers for the spin budget, then yields the working thread for
+    the yield budget and finally blocks until the next handler is ready. So it
+    keeps the latency of the polling loop under load and does not burn the CPU
+    core when the service is idle.
+
+    Asio service also hosts the hierarchical timer wheel which schedules
+    handlers with O(1) schedule and cancel operations. The wheel is turned by
+    a single Asio timer, so it stays cheap with millions of armed timers.
+
+    Working threads of the service could be pinned to the given CPUs and
+    NUMA node, so session buffers allocated by them are node-local.
+
+    IO backend of the service is the default Asio reactor of the platform
+    (epoll on Linux, kqueue on OSX, IOCP on Windows). On Linux io_uring
+    backend could be selected with CPPSERVER_IO_URING build option. Asio
+    selects its backend for the whole process, so all services, clients,
+    servers and sessions use the same backend without any changes.
 
     Thread-safe.
 
@@ -51,22 +76,116 @@ public:
     //! Get the Asio service
     std::shared_ptr<asio::io_service>& service() noexcept { return _service; }
 
+    //! Get the IO backend name (e.g. "epoll" or "io_uring")
+    static std::string backend();
+
+    //! Get the number of working threads
+    size_t threads() const noexcept { return _threads.size(); }
+
     //! Is the service started?
     bool IsStarted() const noexcept { return _started; }
+    //! Is the service started in polling loop mode?
+    bool IsPolling() const noexcept { return _polling; }
+
+    //! Get the number of empty polls spent by the adaptive polling loop in the spin phase
+    uint64_t idle_spins() const noexcept { return _idle_spins; }
+    //! Get the number of thread yields performed by the adaptive polling loop in the yield phase
+    uint64_t idle_yields() const noexcept { return _idle_yields; }
+    //! Get the number of blocking waits performed by the adaptive polling loop in the block phase
+    uint64_t idle_blocks() const noexcept { return _idle_blocks; }
+
+    //! Get the option: adaptive polling spin budget
+    size_t option_adaptive_spins() const noexcept { return _adaptive_spins; }
+    //! Get the option: adaptive polling yield budget
+    size_t option_adaptive_yields() const noexcept { return _adaptive_yields; }
+
+    //! Setup option: adaptive polling
+    /*!
+        Adaptive polling applies to the polling loop mode. When polling finds
+        no pending handlers the working thread busy-polls again up to the spin
+        budget, then calls the idle handler (yields by default) up to the yield
+        budget and then blocks until the next handler is ready. Any executed
+        handler starts the idle phases over again.
+
+        Default budgets are 0 (adaptive polling is disabled and the polling
+        loop calls the idle handler after each poll).
+
+        Option should be setup before the service is started.
+
+        \param spins - Count of empty polls in the spin phase
+        \param yields - Count of idle handler calls in the yield phase
+    */
+    void SetupAdaptivePolling(size_t spins, size_t yields) noexcept { _adaptive_spins = spins; _adaptive_yields = yields; }
+
+    //! Get the option: CPU affinity
+    const std::vector<int>& option_cpu_affinity() const noexcept { return _cpu_affinity; }
+    //! Get the option: NUMA node
+    int option_numa_node() const noexcept { return _numa_node; }
+
+    //! Setup option: CPU affinity
+    /*!
+        Working threads are pinned to the given CPUs in round-robin order, one
+        CPU per thread. Threads are pinned before the initialize thread handler
+        is called, so it could still override the affinity.
+
+        Default CPU affinity is empty (working threads are not pinned).
+
+        Option should be setup before the service is started.
+
+        \param cpus - CPUs to pin working threads
+    */
+    void SetupCpuAffinity(const std::vector<int>& cpus) { _cpu_affinity = cpus; }
+    //! Setup option: NUMA node
+    /*!
+        Working threads prefer the memory of the given NUMA node, so session
+        buffers allocated in them are node-local. If CPU affinity is not set
+        working threads are pinned to all CPUs of the NUMA node.
+
+        Default NUMA node is -1 (memory placement is not changed).
+
+        Option should be setup before the service is started.
+
+        \param node - NUMA node
+    */
+    void SetupNumaNode(int node) noexcept { _numa_node = node; }
+
+    //! Get the option: timer resolution
+    std::chrono::steady_clock::duration option_timer_resolution() const noexcept { return _timers_resolution; }
+
+    //! Setup option: timer resolution
+    /*!
+        Timer resolution is the duration of a single tick of the service timer
+        wheel. Scheduled handlers are never called before their delay expires
+        and are called late at most by the timer resolution. The wheel is not
+        turned while no timers are armed.
+
+        Default timer resolution is 1 millisecond.
+
+        \param resolution - Timer resolution
+    */
+    void SetupTimerResolution(const std::chrono::steady_clock::duration& resolution);
 
     //! Start the service
     /*!
+        All working threads run the same Asio service, so its handlers may be
+        executed concurrently in different threads.
+
         \param polling - Polling loop mode with idle handler call (default is false)
+        \param threads - Count of working threads (default is 1)
         \return 'true' if the service was successfully started, 'false' if the service failed to start
     */
-    bool Start(bool polling = false);
+    bool Start(bool polling = false, int threads = 1);
     //! Stop the service
     /*!
+        Method will wait for all working threads to finish.
+
         \return 'true' if the service was successfully stopped, 'false' if the service is already stopped
     */
     bool Stop();
     //! Restart the service
     /*!
+        Service will be restarted with the same polling mode and count of working threads.
+
         \return 'true' if the service was successfully restarted, 'false' if the service failed to restart
     */
     bool Restart();
@@ -94,15 +213,34 @@ public:
     ASIO_INITFN_RESULT_TYPE(CompletionHandler, void()) Post(ASIO_MOVE_ARG(CompletionHandler) handler)
     { return _service->post(handler); }
 
+    //! Schedule the given handler to be called after the given delay
+    /*!
+        The given handler will be called in one of the service working threads.
+        All scheduled handlers are cancelled when the service is stopped.
+
+        \param delay - Delay to call the handler
+        \param handler - Handler to schedule
+        \return Timer Id to cancel the scheduled handler
+    */
+    TimerId Schedule(const std::chrono::steady_clock::duration& delay, TimerWheel::Handler handler);
+    //! Cancel the scheduled handler
+    /*!
+        \param id - Timer Id
+        \return 'true' if the handler was successfully cancelled, 'false' if the handler was already called or cancelled
+    */
+    bool Cancel(TimerId id);
+
 protected:
     //! Initialize thread handler
     /*!
          This handler can be used to initialize priority or affinity of the service thread.
+         It is called in each working thread.
     */
     virtual void onThreadInitialize() {}
     //! Cleanup thread handler
     /*!
          This handler can be used to cleanup priority or affinity of the service thread.
+         It is called in each working thread.
     */
     virtual void onThreadCleanup() {}
 
@@ -125,11 +263,50 @@ protected:
 private:
     // Asio service
     std::shared_ptr<asio::io_service> _service;
-    std::thread _thread;
+    std::vector<std::thread> _threads;
     std::atomic<bool> _started;
+    bool _polling;
+    // Adaptive polling loop
+    size_t _adaptive_spins;
+    size_t _adaptive_yields;
+    std::atomic<uint64_t> _idle_spins;
+    std::atomic<uint64_t> _idle_yields;
+    std::atomic<uint64_t> _idle_blocks;
+    // Thread placement
+    std::vector<int> _cpu_affinity;
+    int _numa_node;
+    // Service timers
+    std::mutex _timers_lock;
+    TimerWheel _timers;
+    std::unique_ptr<asio::steady_timer> _timers_tick;
+    std::chrono::steady_clock::time_point _timers_base;
+    std::chrono::steady_clock::duration _timers_resolution;
+    bool _timers_ticking;
 
     //! Service loop
-    void ServiceLoop(bool polling);
+    /*!
+        \param polling - Polling loop mode
+        \param cpus - CPUs to pin the working thread (empty to keep the thread unpinned)
+    */
+    void ServiceLoop(bool polling, const std::vector<int>& cpus);
+    //! Pin the current working thread to the given CPUs and the NUMA node
+    void PinThread(const std::vector<int>& cpus);
+    //! Adaptive polling loop iteration
+    /*!
+        \param idle - Count of idle iterations since the last executed handler
+        \param spins - Count of spins not yet added to the counter
+        \param yields - Count of yields not yet added to the counter
+    */
+    void AdaptivePoll(size_t& idle, uint64_t& spins, uint64_t& yields);
+    //! Add counts of the idle period to adaptive polling counters
+    void UpdateIdleCounters(uint64_t& spins, uint64_t& yields, uint64_t blocks);
+
+    //! Get the timer wheel tick of the given time
+    uint64_t TimerTick(const std::chrono::steady_clock::time_point& time) const noexcept;
+    //! Wait for the next tick of the timer wheel
+    void WaitTimers();
+    //! Turn the timer wheel and call expired handlers
+    void ExpireTimers();
 
     //! Send error notification
     void SendError(std::error_code ec);
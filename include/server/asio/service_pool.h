@@ -0,0 +1,126 @@
+/*!
+    \file service_pool.h
+    \brief Asio service pool definition
+    \author Ivan Shynkarenka
+    \date 20.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_SERVICE_POOL_H
+#define CPPSERVER_ASIO_SERVICE_POOL_H
+
+#include "service.h"
+
+#include "system/cpu.h"
+
+#include <vector>
+
+namespace CppServer {
+namespace Asio {
+
+//! Asio service pool
+/*!
+    Asio service pool owns several Asio services, usually one per CPU core.
+    Each service is started with a single working thread, so all handlers
+    of a client/session placed into the pool service are executed in the
+    same thread without any cross-core bouncing.
+
+    Servers use the service pool to place accepted sessions in round-robin
+    order while the server acceptor stays on its own service.
+
+    Services of the pool could be pinned one per CPU of the given CPU set or
+    NUMA node, so each session stays on its core and node-local memory.
+
+    Thread-safe.
+*/
+class ServicePool
+{
+public:
+    //! Initialize Asio service pool with a given count of services
+    /*!
+        \param services - Count of services (default is CPU logical cores count)
+    */
+    explicit ServicePool(int services = CppCommon::CPU::LogicalCores());
+    //! Initialize Asio service pool with given Asio services
+    /*!
+        \param services - Asio services
+    */
+    explicit ServicePool(const std::vector<std::shared_ptr<Service>>& services);
+    ServicePool(const ServicePool&) = delete;
+    ServicePool(ServicePool&&) = delete;
+    virtual ~ServicePool() = default;
+
+    ServicePool& operator=(const ServicePool&) = delete;
+    ServicePool& operator=(ServicePool&&) = delete;
+
+    //! Get the count of services in the pool
+    size_t size() const noexcept { return _services.size(); }
+    //! Get the Asio services
+    std::vector<std::shared_ptr<Service>>& services() noexcept { return _services; }
+
+    //! Get the option: CPU affinity
+    const std::vector<int>& option_cpu_affinity() const noexcept { return _cpu_affinity; }
+    //! Get the option: NUMA node
+    int option_numa_node() const noexcept { return _numa_node; }
+
+    //! Setup option: CPU affinity
+    /*!
+        Services of the pool are pinned to the given CPUs in round-robin order,
+        one CPU per service.
+
+        Option should be setup before the service pool is started.
+
+        \param cpus - CPUs to pin services of the pool
+    */
+    void SetupCpuAffinity(const std::vector<int>& cpus) { _cpu_affinity = cpus; }
+    //! Setup option: NUMA node
+    /*!
+        Services of the pool prefer the memory of the given NUMA node. If CPU
+        affinity is not set services are pinned to CPUs of the NUMA node in
+        round-robin order, one CPU per service.
+
+        Option should be setup before the service pool is started.
+
+        \param node - NUMA node
+    */
+    void SetupNumaNode(int node) noexcept { _numa_node = node; }
+
+    //! Is the service pool started?
+    /*!
+        \return 'true' if all services of the pool are started, 'false' otherwise
+    */
+    bool IsStarted() const noexcept;
+
+    //! Start all services of the pool
+    /*!
+        \param polling - Polling loop mode with idle handler call (default is false)
+        \return 'true' if the service pool was successfully started, 'false' if the service pool failed to start
+    */
+    bool Start(bool polling = false);
+    //! Stop all services of the pool
+    /*!
+        \return 'true' if the service pool was successfully stopped, 'false' if the service pool is already stopped
+    */
+    bool Stop();
+    //! Restart all services of the pool
+    /*!
+        \return 'true' if the service pool was successfully restarted, 'false' if the service pool failed to restart
+    */
+    bool Restart();
+
+    //! Get the next Asio service of the pool in round-robin order
+    std::shared_ptr<Service>& GetNextService() noexcept;
+
+private:
+    // Asio services
+    std::vector<std::shared_ptr<Service>> _services;
+    std::atomic<size_t> _round_robin_index;
+    // Services placement
+    std::vector<int> _cpu_affinity;
+    int _numa_node;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_SERVICE_POOL_H
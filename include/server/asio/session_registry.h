@@ -0,0 +1,113 @@
+/*!
+    \file session_registry.h
+    \brief Session registry definition
+    \author Ivan Shynkarenka
+    \date 25.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_SESSION_REGISTRY_H
+#define CPPSERVER_ASIO_SESSION_REGISTRY_H
+
+#include "asio.h"
+
+namespace CppServer {
+namespace Asio {
+
+//! Session Id
+/*!
+    Session Id is a compact identifier of the session registered in the
+    server. Low 32 bits are the registry slot index and high 32 bits are
+    the slot generation. Generation is incremented each time the slot is
+    reused, so the Id of a disconnected session never refers to a new one.
+
+    Zero Id is never assigned to registered sessions.
+*/
+typedef uint64_t SessionId;
+
+//! Session registry
+/*!
+    Session registry keeps registered sessions in a dense vector and maps
+    session Ids to them with the generation-tagged slot table. Register,
+    unregister and find operations take O(1) time and iterating over all
+    sessions is a plain vector traversal.
+
+    Unregistering a session moves the last session into its place, so the
+    iteration order is not stable.
+
+    Not thread-safe.
+*/
+template <class TSession>
+class SessionRegistry
+{
+public:
+    SessionRegistry() = default;
+    SessionRegistry(const SessionRegistry&) = delete;
+    SessionRegistry(SessionRegistry&&) = default;
+    ~SessionRegistry() = default;
+
+    SessionRegistry& operator=(const SessionRegistry&) = delete;
+    SessionRegistry& operator=(SessionRegistry&&) = default;
+
+    //! Is the registry empty?
+    bool empty() const noexcept { return _sessions.empty(); }
+    //! Get the count of registered sessions
+    size_t size() const noexcept { return _sessions.size(); }
+
+    //! Get the begin iterator of registered sessions
+    typename std::vector<std::shared_ptr<TSession>>::const_iterator begin() const noexcept { return _sessions.begin(); }
+    //! Get the end iterator of registered sessions
+    typename std::vector<std::shared_ptr<TSession>>::const_iterator end() const noexcept { return _sessions.end(); }
+
+    //! Register the given session
+    /*!
+        \param session - Session to register
+        \return Id of the registered session
+    */
+    SessionId Register(const std::shared_ptr<TSession>& session);
+    //! Unregister the session with the given Id
+    /*!
+        \param id - Session Id
+        \return Unregistered session or nullptr if the session was not found
+    */
+    std::shared_ptr<TSession> Unregister(SessionId id);
+
+    //! Find the session with the given Id
+    /*!
+        \param id - Session Id
+        \return Found session or nullptr if the session was not found
+    */
+    std::shared_ptr<TSession> Find(SessionId id) const;
+
+    //! Clear the registry
+    void Clear();
+
+private:
+    static const uint32_t FREE = 0xFFFFFFFF;
+
+    // Slot table: session generation and index in the dense vector (FREE for free slots)
+    struct Slot
+    {
+        uint32_t generation;
+        uint32_t index;
+    };
+    std::vector<Slot> _slots;
+    std::vector<uint32_t> _free;
+    // Dense vector of registered sessions and their slots
+    std::vector<std::shared_ptr<TSession>> _sessions;
+    std::vector<uint32_t> _owners;
+
+    //! Find the slot of the registered session with the given Id
+    /*!
+        \param id - Session Id
+        \return Pointer to the found slot or nullptr
+    */
+    const Slot* FindSlot(SessionId id) const;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#include "session_registry.inl"
+
+#endif // CPPSERVER_ASIO_SESSION_REGISTRY_H
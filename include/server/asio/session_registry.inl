@@ -0,0 +1,107 @@
+/*!
+    \file session_registry.inl
+    \brief Session registry inline implementation
+    \author Ivan Shynkarenka
+    \date 25.03.2017
+    \copyright MIT License
+*/
+
+namespace CppServer {
+namespace Asio {
+
+template <class TSession>
+const uint32_t SessionRegistry<TSession>::FREE;
+
+template <class TSession>
+inline SessionId SessionRegistry<TSession>::Register(const std::shared_ptr<TSession>& session)
+{
+    // Reuse the free slot or create a new one
+    uint32_t slot;
+    if (!_free.empty())
+    {
+        slot = _free.back();
+        _free.pop_back();
+    }
+    else
+    {
+        slot = (uint32_t)_slots.size();
+        _slots.push_back({ 0, FREE });
+    }
+
+    // Start a new slot generation. Zero generation is skipped to keep all Ids non-zero.
+    Slot& current = _slots[slot];
+    if (++current.generation == 0)
+        ++current.generation;
+    current.index = (uint32_t)_sessions.size();
+
+    _sessions.push_back(session);
+    _owners.push_back(slot);
+
+    return ((SessionId)current.generation << 32) | slot;
+}
+
+template <class TSession>
+inline std::shared_ptr<TSession> SessionRegistry<TSession>::Unregister(SessionId id)
+{
+    if (FindSlot(id) == nullptr)
+        return nullptr;
+
+    uint32_t slot = (uint32_t)id;
+    uint32_t index = _slots[slot].index;
+    std::shared_ptr<TSession> session = std::move(_sessions[index]);
+
+    // Move the last session into the place of the unregistered one
+    uint32_t last = (uint32_t)(_sessions.size() - 1);
+    if (index != last)
+    {
+        _sessions[index] = std::move(_sessions[last]);
+        _owners[index] = _owners[last];
+        _slots[_owners[index]].index = index;
+    }
+    _sessions.pop_back();
+    _owners.pop_back();
+
+    // Free the slot
+    _slots[slot].index = FREE;
+    _free.push_back(slot);
+
+    return session;
+}
+
+template <class TSession>
+inline std::shared_ptr<TSession> SessionRegistry<TSession>::Find(SessionId id) const
+{
+    const Slot* slot = FindSlot(id);
+    return (slot != nullptr) ? _sessions[slot->index] : nullptr;
+}
+
+template <class TSession>
+inline void SessionRegistry<TSession>::Clear()
+{
+    // Free all slots and keep their generations
+    for (uint32_t slot : _owners)
+    {
+        _slots[slot].index = FREE;
+        _free.push_back(slot);
+    }
+    _sessions.clear();
+    _owners.clear();
+}
+
+template <class TSession>
+inline const typename SessionRegistry<TSession>::Slot* SessionRegistry<TSession>::FindSlot(SessionId id) const
+{
+    uint32_t slot = (uint32_t)id;
+    uint32_t generation = (uint32_t)(id >> 32);
+    if (slot >= _slots.size())
+        return nullptr;
+
+    const Slot& current = _slots[slot];
+    if ((current.index == FREE) || (current.generation != generation))
+        return nullptr;
+
+    return &current;
+}
+
+} // namespace Asio
+} // namespace CppServer
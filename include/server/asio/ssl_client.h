@@ -9,11 +9,14 @@
 #ifndef CPPSERVER_ASIO_SSL_CLIENT_H
 #define CPPSERVER_ASIO_SSL_CLIENT_H
 
+#include "coroutine.h"
+#include "reconnect.h"
 #include "service.h"
 
 #include "system/uuid.h"
 
 #include <memory>
+#include <mutex>
 
 namespace CppServer {
 namespace Asio {
@@ -22,7 +25,8 @@ namespace Asio {
 /*!
     SSL client is used to read/write data from/into the connected SSL server.
 
-    Thread-safe.
+    Thread-safe. If the Asio service runs several working threads all client
+    handlers are serialized by the client strand.
 */
 class SSLClient : public std::enable_shared_from_this<SSLClient>
 {
@@ -50,7 +54,11 @@ public:
     SSLClient& operator=(SSLClient&& client);
 
     //! Get the client Id
-    const CppCommon::UUID& id() const noexcept { return _id; }
+    /*!
+        Client Id is generated on the first call, so clients that never use
+        it do not pay for the UUID generation.
+    */
+    const CppCommon::UUID& id() const;
 
     //! Get the Asio service
     std::shared_ptr<Service>& service() noexcept;
@@ -67,12 +75,102 @@ public:
     uint64_t bytes_sent() const noexcept;
     //! Get the number of bytes received by this client
     uint64_t bytes_received() const noexcept;
+    //! Get the number of bytes pending in the send buffer of this client
+    uint64_t bytes_pending() const noexcept;
 
     //! Is the client connected?
     bool IsConnected() const noexcept;
     //! Is the session handshaked?
     bool IsHandshaked() const noexcept;
 
+    //! Get the option: send size limit
+    size_t option_send_size_limit() const noexcept;
+
+    //! Setup option: send size limit
+    /*!
+        All pending data is passed to the SSL stream with a single send operation.
+        This option limits the size of such operation (0 - unlimited).
+
+        \param limit - Send size limit in bytes
+    */
+    void SetupSendSizeLimit(size_t limit) noexcept;
+
+    //! Get the option: minimal buffer size
+    size_t option_buffer_min() const noexcept;
+    //! Get the option: maximal buffer size
+    size_t option_buffer_max() const noexcept;
+
+    //! Setup option: buffer limits
+    /*!
+        The client reads up to the adaptive receive size. It starts from the
+        minimal buffer size, doubles while receive operations fill it up and
+        falls back when they return less than a half of it. The receive buffer
+        above the receive size is released once all received data is handled.
+        Send buffers keep their capacity between sends only up to the maximal
+        buffer size.
+
+        Default limits are 4 KB and 1 MB.
+
+        \param min - Minimal buffer size in bytes
+        \param max - Maximal buffer size in bytes
+    */
+    void SetupBufferLimits(size_t min, size_t max) noexcept;
+
+    //! Get the option: send buffer high watermark
+    size_t option_send_buffer_high() const noexcept;
+    //! Get the option: send buffer low watermark
+    size_t option_send_buffer_low() const noexcept;
+    //! Get the option: pause receiving while the send buffer is full
+    bool option_receive_pause() const noexcept;
+
+    //! Setup option: send buffer watermarks
+    /*!
+        When pending data of the client send buffer reaches the high watermark
+        the client calls onSendBufferFull() and rejects new data to send until
+        the send buffer is drained down to the low watermark. Then it calls
+        onSendBufferDrained().
+
+        \param high - High watermark in bytes (0 - unlimited)
+        \param low - Low watermark in bytes
+    */
+    void SetupSendBufferWatermarks(size_t high, size_t low) noexcept;
+
+    //! Setup option: pause receiving while the send buffer is full
+    /*!
+        This option stops reading from the client socket while its send buffer
+        is full, so the peer that does not drain sent data could not make the
+        client produce more of it. Receiving is resumed when the send buffer is
+        drained.
+
+        \param enable - Enable/disable option
+    */
+    void SetupReceivePause(bool enable) noexcept;
+
+    //! Get the option: minimal reconnect delay
+    std::chrono::steady_clock::duration option_reconnect_delay_min() const noexcept;
+    //! Get the option: maximal reconnect delay
+    std::chrono::steady_clock::duration option_reconnect_delay_max() const noexcept;
+    //! Get the option: limit of reconnect attempts
+    size_t option_reconnect_attempts() const noexcept;
+
+    //! Setup option: automatic reconnect
+    /*!
+        The client which failed to connect, failed to handshake or lost its
+        connection is connected again after the reconnect delay scheduled in
+        the timer wheel of the client Asio service, so no thread waits for the
+        reconnect. The delay grows exponentially from the minimal to the
+        maximal delay with each attempt in a row and is randomized by the
+        jitter (see ReconnectPolicy). Reconnect attempts are reset when the
+        client is handshaked and stopped by Disconnect().
+
+        Default minimal delay is 0 (automatic reconnect is disabled).
+
+        \param min - Minimal reconnect delay
+        \param max - Maximal reconnect delay
+        \param attempts - Limit of reconnect attempts in a row (0 - unlimited, default is 0)
+    */
+    void SetupReconnect(const std::chrono::steady_clock::duration& min, const std::chrono::steady_clock::duration& max, size_t attempts = 0) noexcept;
+
     //! Connect the client
     /*!
         \return 'true' if the client was successfully connected, 'false' if the client failed to connect
@@ -80,12 +178,17 @@ public:
     bool Connect();
     //! Disconnect the client
     /*!
+        Disconnects the client and stops its automatic reconnect.
+
         \return 'true' if the client was successfully disconnected, 'false' if the client is already disconnected
     */
-    bool Disconnect() { return Disconnect(false); }
+    bool Disconnect();
     //! Reconnect the client
     /*!
-        \return 'true' if the client was successfully reconnected, 'false' if the client is already reconnected
+        Disconnects and connects the client again in its IO thread, so the
+        calling thread does not wait for the disconnect.
+
+        \return 'true' if the client was successfully reconnected, 'false' if the client is not connected
     */
     bool Reconnect();
 
@@ -93,15 +196,64 @@ public:
     /*!
         \param buffer - Buffer to send
         \param size - Buffer size
-        \return Count of pending bytes in the send buffer
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
     */
     size_t Send(const void* buffer, size_t size);
     //! Send a text string to the server
     /*!
         \param text - Text string to send
-        \return Count of pending bytes in the send buffer
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
     */
     size_t Send(const std::string& text) { return Send(text.data(), text.size()); }
+    //! Send the shared buffer to the server
+    /*!
+        The shared buffer is queued by reference without copying its content,
+        so the same buffer could be sent by many sessions or clients at once.
+        The buffer content must not be changed until it is sent.
+
+        \param buffer - Shared buffer to send
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
+    */
+    size_t Send(std::shared_ptr<const Buffer> buffer);
+
+    //! Connect the client asynchronously (C++20 coroutines)
+    /*!
+        Connects the client as Connect() does and awaits until the client is
+        handshaked or failed to connect. The client should not be already
+        connecting. The coroutine is resumed in the IO thread of the client
+        right after onHandshaked() handler, so all next operations of the
+        client could be awaited there.
+
+        \return Awaitable 'true' if the client was successfully handshaked, 'false' if the client failed to connect
+    */
+    AsyncAwaitable<SSLClient, bool> ConnectAsync();
+    //! Receive data from the server asynchronously (C++20 coroutines)
+    /*!
+        Awaits the next chunk of data received from the server and copies it
+        into the given buffer. Unread data of the receive buffer is returned
+        at once. Once the data is awaited the client stops calling onReceived()
+        handler and receives only when the next chunk is awaited, so a slow
+        coroutine applies backpressure to the server.
+
+        Should be awaited in the IO thread of the handshaked client.
+
+        \param buffer - Buffer to receive
+        \param size - Buffer size
+        \return Awaitable count of received bytes or 0 if the client was disconnected
+    */
+    AsyncAwaitable<SSLClient> ReceiveAsync(void* buffer, size_t size);
+    //! Send data to the server asynchronously (C++20 coroutines)
+    /*!
+        Enqueues the data as Send() does and awaits until all pending data
+        including the given buffer is sent to the server.
+
+        Should be awaited in the IO thread of the handshaked client.
+
+        \param buffer - Buffer to send
+        \param size - Buffer size
+        \return Awaitable count of sent bytes or 0 if the data was not sent
+    */
+    AsyncAwaitable<SSLClient> SendAsync(const void* buffer, size_t size);
 
 protected:
     //! Handle client connected notification
@@ -110,6 +262,16 @@ protected:
     virtual void onHandshaked() {}
     //! Handle client disconnected notification
     virtual void onDisconnected() {}
+    //! Handle client reconnecting notification
+    /*!
+        Notification is called right after onDisconnected() handler when the
+        next automatic reconnect attempt is scheduled. Disconnect() called
+        from this handler stops reconnecting.
+
+        \param attempt - Reconnect attempt in a row (starting from 1)
+        \param delay - Delay of the reconnect attempt
+    */
+    virtual void onReconnecting(size_t attempt, const std::chrono::steady_clock::duration& delay) {}
 
     //! Handle buffer received notification
     /*!
@@ -120,6 +282,9 @@ protected:
         If you want to wait for some more bytes from the server return the
         size of the buffer you want to keep until another chunk is received.
 
+        The given buffer is a view of all unread data in the receive buffer.
+        It is valid only until the handler returns.
+
         \param buffer - Received buffer
         \param size - Received buffer size
         \return Count of handled bytes
@@ -147,6 +312,20 @@ protected:
     */
     virtual void onEmpty() {}
 
+    //! Handle send buffer full notification
+    /*!
+        Notification is called when pending data of the send buffer reaches
+        the high watermark. New data to send is rejected until the send buffer
+        is drained down to the low watermark.
+    */
+    virtual void onSendBufferFull() {}
+    //! Handle send buffer drained notification
+    /*!
+        Notification is called when the full send buffer was drained down to
+        the low watermark and is ready for a new data to send.
+    */
+    virtual void onSendBufferDrained() {}
+
     //! Handle error notification
     /*!
         \param error - Error code
@@ -156,12 +335,17 @@ protected:
     virtual void onError(int error, const std::string& category, const std::string& message) {}
 
 private:
-    // Client Id
-    CppCommon::UUID _id;
+    // Client Id (lazily generated)
+    mutable std::once_flag _id_flag;
+    mutable CppCommon::UUID _id;
 
     friend class Impl;
     class Impl;
     std::shared_ptr<Impl> _pimpl;
+    // Automatic reconnect (kept by the client when its implementation is reset)
+    std::atomic<bool> _reconnect;
+    std::atomic<TimerId> _reconnect_timer;
+    ReconnectPolicy _reconnect_policy;
 
     //! Disconnect the client
     /*!
@@ -170,12 +354,55 @@ private:
     */
     bool Disconnect(bool dispatch);
 
+    //! Schedule the next automatic reconnect attempt of the disconnected client
+    void ScheduleReconnect();
+    //! Cancel the scheduled reconnect attempt
+    void CancelReconnect();
+
+    //! Start to await the client handshake
+    /*!
+        \param awaiter - Connect awaiter
+        \return 'true' if the awaiter is registered, 'false' if the client is already handshaked or connecting
+    */
+    bool StartConnectAsync(AsyncAwaiter& awaiter);
+    //! Start to await received data
+    /*!
+        \param awaiter - Receive awaiter
+        \return 'true' if the awaiter is registered, 'false' if the receive is already completed
+    */
+    bool StartReceiveAsync(AsyncAwaiter& awaiter);
+    //! Start to await sent data
+    /*!
+        \param awaiter - Send awaiter
+        \return 'true' if the awaiter is registered, 'false' if the send is already completed
+    */
+    bool StartSendAsync(AsyncAwaiter& awaiter);
+
     //! Handle client reset notification
     void onReset();
 };
 
 /*! \example ssl_chat_client.cpp SSL chat client example */
 
+#if defined(CPPSERVER_ASIO_COROUTINES)
+
+inline AsyncAwaitable<SSLClient, bool> SSLClient::ConnectAsync()
+{
+    return AsyncAwaitable<SSLClient, bool>(*this, &SSLClient::StartConnectAsync);
+}
+
+inline AsyncAwaitable<SSLClient> SSLClient::ReceiveAsync(void* buffer, size_t size)
+{
+    return AsyncAwaitable<SSLClient>(*this, &SSLClient::StartReceiveAsync, buffer, size);
+}
+
+inline AsyncAwaitable<SSLClient> SSLClient::SendAsync(const void* buffer, size_t size)
+{
+    return AsyncAwaitable<SSLClient>(*this, &SSLClient::StartSendAsync, const_cast<void*>(buffer), size);
+}
+
+#endif
+
 } // namespace Asio
 } // namespace CppServer
 
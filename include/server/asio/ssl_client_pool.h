@@ -0,0 +1,66 @@
+/*!
+    \file ssl_client_pool.h
+    \brief SSL client pool definition
+    \author Ivan Shynkarenka
+    \date 05.04.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_SSL_CLIENT_POOL_H
+#define CPPSERVER_ASIO_SSL_CLIENT_POOL_H
+
+#include "client_pool.h"
+#include "ssl_client.h"
+
+namespace CppServer {
+namespace Asio {
+
+//! SSL client pool
+/*!
+    SSL client pool keeps handshaked SSL clients of several servers and
+    balances sent data between them (see ClientPool). All clients of the
+    pool share the same SSL context.
+
+    Thread-safe.
+*/
+template <class TClient = SSLClient>
+class SSLClientPool : public ClientPool<TClient>
+{
+public:
+    //! Initialize SSL client pool with a given Asio service, SSL context and count of connections per endpoint
+    /*!
+        \param service - Asio service
+        \param context - SSL context
+        \param connections - Count of connections per endpoint (default is 1)
+    */
+    explicit SSLClientPool(std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, size_t connections = 1) : ClientPool<TClient>(service, connections), _context(context)
+    {
+        assert((context != nullptr) && "SSL context is invalid!");
+        if (context == nullptr)
+            throw CppCommon::ArgumentException("SSL context is invalid!");
+    }
+    SSLClientPool(const SSLClientPool&) = delete;
+    SSLClientPool(SSLClientPool&&) = delete;
+    virtual ~SSLClientPool() = default;
+
+    SSLClientPool& operator=(const SSLClientPool&) = delete;
+    SSLClientPool& operator=(SSLClientPool&&) = delete;
+
+    //! Get the SSL context of pool clients
+    std::shared_ptr<asio::ssl::context>& context() noexcept { return _context; }
+
+protected:
+    //! Create a new SSL client of the given server endpoint
+    std::shared_ptr<TClient> CreateClient(std::shared_ptr<Service>& service, const asio::ip::tcp::endpoint& endpoint) override { return std::make_shared<TClient>(service, _context, endpoint); }
+    //! Is the given SSL client handshaked?
+    bool IsReady(const TClient& client) const noexcept override { return client.IsHandshaked(); }
+
+private:
+    // SSL context
+    std::shared_ptr<asio::ssl::context> _context;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_SSL_CLIENT_POOL_H
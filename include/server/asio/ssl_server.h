@@ -9,9 +9,12 @@
 #ifndef CPPSERVER_ASIO_SSL_SERVER_H
 #define CPPSERVER_ASIO_SSL_SERVER_H
 
+#include "service_pool.h"
+#include "session_registry.h"
+#include "statistics.h"
 #include "ssl_session.h"
 
-#include <map>
+#include <condition_variable>
 #include <mutex>
 #include <vector>
 
@@ -66,6 +69,8 @@ public:
 
     //! Get the Asio service
     std::shared_ptr<Service>& service() noexcept { return _service; }
+    //! Get the Asio service pool used to host connected sessions
+    std::shared_ptr<ServicePool>& pool() noexcept { return _pool; }
     //! Get the server SSL context
     std::shared_ptr<asio::ssl::context>& context() noexcept { return _context; }
     //! Get the server endpoint
@@ -76,12 +81,182 @@ public:
     //! Get the number of sessions currently connected to this server
     uint64_t current_sessions() const noexcept { return _sessions.size(); }
     //! Get the number of bytes sent by this server
-    uint64_t bytes_sent() const noexcept { return _bytes_sent; }
+    uint64_t bytes_sent() const noexcept { return _statistics.bytes_sent(); }
     //! Get the number of bytes received by this server
-    uint64_t bytes_received() const noexcept { return _bytes_received; }
+    uint64_t bytes_received() const noexcept { return _statistics.bytes_received(); }
+    //! Get the server statistics
+    /*!
+        Messages of the server statistics are send and receive operations of
+        its sessions.
+    */
+    const Statistics& statistics() const noexcept { return _statistics; }
 
     //! Is the server started?
     bool IsStarted() const noexcept { return _started; }
+    //! Is the server draining its sessions to stop?
+    bool IsDraining() const noexcept { return _draining; }
+
+    //! Setup the Asio service pool to host connected sessions
+    /*!
+        Each accepted session is placed into the next service of the pool in
+        round-robin order, so all its handlers stay in the same thread. The
+        server acceptor stays on the server Asio service. Without the service
+        pool all sessions are hosted by the server Asio service.
+
+        The service pool should be setup before the server is started.
+
+        \param pool - Asio service pool
+    */
+    void SetupServicePool(std::shared_ptr<ServicePool> pool) noexcept { _pool = pool; }
+
+    //! Get the option: reuse port
+    bool option_reuse_port() const noexcept { return _reuse_port; }
+
+    //! Setup option: reuse port
+    /*!
+        This option will enable SO_REUSEPORT if the OS support this feature.
+
+        If the service pool is setup the server opens one acceptor bound with
+        SO_REUSEPORT per pool service instead of the single server acceptor.
+        The kernel spreads new connections across these acceptors and each of
+        them registers accepted sessions in its own service.
+
+        The option should be setup before the server is started.
+
+        \param enable - Enable/disable option
+    */
+    void SetupReusePort(bool enable) noexcept { _reuse_port = enable; }
+
+    //! Get the option: accept backlog
+    int option_accept_backlog() const noexcept { return _accept_backlog; }
+    //! Get the option: count of outstanding accepts
+    size_t option_accept_concurrency() const noexcept { return _accept_concurrency; }
+
+    //! Setup option: accept backlog
+    /*!
+        Accept backlog is the maximal length of the queue of connections
+        pending on the server acceptor. Each time the accept operation wakes
+        up the server accepts all connections ready in this queue (up to the
+        backlog) without waiting for another wakeup.
+
+        Default backlog is the system maximum (SOMAXCONN).
+
+        The option should be setup before the server is started.
+
+        \param backlog - Accept backlog
+    */
+    void SetupAcceptBacklog(int backlog) noexcept { _accept_backlog = backlog; }
+    //! Setup option: count of outstanding accepts
+    /*!
+        Each server acceptor keeps this count of accept operations in flight,
+        each one with its own socket. Connections are accepted while sessions
+        accepted before are still being registered.
+
+        Default count is 1.
+
+        The option should be setup before the server is started.
+
+        \param accepts - Count of outstanding accepts
+    */
+    void SetupAcceptConcurrency(size_t accepts) noexcept { _accept_concurrency = std::max(accepts, (size_t)1); }
+
+    //! Get the option: send size limit
+    size_t option_send_size_limit() const noexcept { return _send_size_limit; }
+
+    //! Setup option: send size limit
+    /*!
+        Sessions pass all pending data to the socket with a single send operation.
+        This option limits the size of such operation (0 - unlimited).
+
+        \param limit - Send size limit in bytes
+    */
+    void SetupSendSizeLimit(size_t limit) noexcept { _send_size_limit = limit; }
+
+    //! Get the option: minimal buffer size
+    size_t option_buffer_min() const noexcept { return _buffer_min; }
+    //! Get the option: maximal buffer size
+    size_t option_buffer_max() const noexcept { return _buffer_max; }
+
+    //! Setup option: buffer limits
+    /*!
+        Sessions read up to the adaptive receive size. It starts from the
+        minimal buffer size, doubles while receive operations fill it up and
+        falls back when they return less than a half of it. The receive buffer
+        above the receive size is released once all received data is handled,
+        so idle sessions keep only a small buffer. Send buffers keep their capacity
+        between sends only up to the maximal buffer size.
+
+        Default limits are 4 KB and 1 MB.
+
+        \param min - Minimal buffer size in bytes
+        \param max - Maximal buffer size in bytes
+    */
+    void SetupBufferLimits(size_t min, size_t max) noexcept { _buffer_min = min; _buffer_max = std::max(min, max); }
+
+    //! Get the option: send buffer high watermark
+    size_t option_send_buffer_high() const noexcept { return _send_buffer_high; }
+    //! Get the option: send buffer low watermark
+    size_t option_send_buffer_low() const noexcept { return _send_buffer_low; }
+    //! Get the option: pause receiving while the send buffer is full
+    bool option_receive_pause() const noexcept { return _receive_pause; }
+
+    //! Setup option: send buffer watermarks
+    /*!
+        When pending data of the session send buffer reaches the high watermark
+        the session calls onSendBufferFull() and rejects new data to send until
+        the send buffer is drained down to the low watermark. Then it calls
+        onSendBufferDrained().
+
+        Multicast data is not queued into sessions with the full send buffer.
+
+        \param high - High watermark in bytes (0 - unlimited)
+        \param low - Low watermark in bytes
+    */
+    void SetupSendBufferWatermarks(size_t high, size_t low) noexcept { _send_buffer_high = high; _send_buffer_low = std::min(low, high); }
+
+    //! Setup option: pause receiving while the send buffer is full
+    /*!
+        This option stops reading from the session socket while its send buffer
+        is full, so the peer that does not drain sent data could not make the
+        session produce more of it. Receiving is resumed when the send buffer is
+        drained.
+
+        \param enable - Enable/disable option
+    */
+    void SetupReceivePause(bool enable) noexcept { _receive_pause = enable; }
+
+    //! Get the option: session pool size
+    size_t option_session_pool() const noexcept { return _session_pool_size; }
+
+    //! Setup option: session pool size
+    /*!
+        Disconnected sessions are released into the session pool instead of
+        being destroyed once they are not referred anymore. New connections
+        reuse pooled sessions together with the capacity of their receive &
+        send buffers, so the connection churn does not allocate sessions over
+        and over again. Pooled session calls onReset() handler to clear its
+        user state.
+
+        Default size is 0 (session pool is disabled).
+
+        \param size - Maximal count of pooled sessions
+    */
+    void SetupSessionPool(size_t size) noexcept { _session_pool_size = size; }
+
+    //! Get the option: idle timeout
+    std::chrono::steady_clock::duration option_idle_timeout() const noexcept { return _idle_timeout; }
+
+    //! Setup option: idle timeout
+    /*!
+        Sessions which neither receive nor send anything during the idle
+        timeout are disconnected. Idle timeouts are scheduled in the timer
+        wheel of the session Asio service.
+
+        Default idle timeout is 0 (idle timeout is disabled).
+
+        \param timeout - Idle timeout
+    */
+    void SetupIdleTimeout(const std::chrono::steady_clock::duration& timeout) noexcept { _idle_timeout = timeout; }
 
     //! Start the server
     /*!
@@ -90,15 +265,43 @@ public:
     bool Start();
     //! Stop the server
     /*!
+        Stops accepting new connections and disconnects all sessions at once.
+        Unsent data of sessions is dropped.
+
         \return 'true' if the server was successfully stopped, 'false' if the server is already stopped
     */
-    bool Stop();
+    bool Stop() { return Stop(std::chrono::steady_clock::duration::zero()); }
+    //! Stop the server gracefully with the given drain timeout
+    /*!
+        Stops accepting new connections and drains connected sessions. Idle
+        sessions are disconnected at once, busy sessions are disconnected as
+        soon as all pending data of their send buffers is sent. Drained session
+        performs SSL shutdown, so the client reads all sent data and receives
+        SSL close notification. Sessions which are not drained until the
+        timeout are aborted by closing their sockets.
+
+        The server is stopped when the last session is drained or the drain
+        timeout expires. Then the server stopped handler is called and threads
+        waiting for the server to be stopped are woken up.
+
+        \param timeout - Drain timeout (0 - disconnect all sessions at once)
+        \return 'true' if the server was successfully stopped, 'false' if the server is already stopped
+    */
+    bool Stop(const std::chrono::steady_clock::duration& timeout);
     //! Restart the server
     /*!
         \return 'true' if the server was successfully restarted, 'false' if the server failed to restart
     */
     bool Restart();
 
+    //! Wait for the server to be stopped
+    /*!
+        Blocks the calling thread until the server stop routine is completed
+        instead of spinning on IsStarted(). Should not be called from working
+        threads of the server Asio service.
+    */
+    void WaitStopped();
+
     //! Multicast data to all connected sessions
     /*!
         \param buffer - Buffer to multicast
@@ -112,6 +315,15 @@ public:
         \return 'true' if the text string was successfully multicast, 'false' if the server it not started
     */
     bool Multicast(const std::string& text) { return Multicast(text.data(), text.size()); }
+    //! Multicast the shared buffer to all connected sessions
+    /*!
+        The shared buffer is queued into send buffers of all connected sessions
+        by reference, so its content is not copied for each session.
+
+        \param buffer - Shared buffer to multicast
+        \return 'true' if the shared buffer was successfully multicast, 'false' if the server it not started
+    */
+    bool Multicast(std::shared_ptr<const Buffer> buffer);
 
     //! Disconnect all connected sessions
     /*!
@@ -119,6 +331,13 @@ public:
     */
     bool DisconnectAll();
 
+    //! Find the connected session with the given Id
+    /*!
+        \param id - Session Id
+        \return Found session or nullptr if the session was not found
+    */
+    std::shared_ptr<TSession> FindSession(SessionId id);
+
 protected:
     //! Handle server started notification
     virtual void onStarted() {}
@@ -145,33 +364,129 @@ protected:
     virtual void onError(int error, const std::string& category, const std::string& message) {}
 
 private:
-    // Asio service
+    // Asio service & service pool
     std::shared_ptr<Service> _service;
-    // Server SSL context, endpoint, acceptor and socket
+    std::shared_ptr<ServicePool> _pool;
+    // Server SSL context, endpoint and acceptor. Accept handlers of the multi-threaded service are serialized by the acceptor strand.
     std::shared_ptr<asio::ssl::context> _context;
     asio::ip::tcp::endpoint _endpoint;
     asio::ip::tcp::acceptor _acceptor;
-    asio::ip::tcp::socket _socket;
+    std::unique_ptr<asio::io_service::strand> _acceptor_strand;
     std::atomic<bool> _started;
-    // Server statistic
-    uint64_t _bytes_sent;
-    uint64_t _bytes_received;
+    // Graceful stop: drain state, drain timeout & stopped event
+    std::atomic<bool> _draining;
+    TimerId _drain_timer;
+    std::mutex _stopped_lock;
+    std::condition_variable _stopped_event;
+    // Server acceptors hosted by the service pool (SO_REUSEPORT mode)
+    struct ServiceAcceptor
+    {
+        std::shared_ptr<Service> service;
+        asio::ip::tcp::acceptor acceptor;
+
+        explicit ServiceAcceptor(std::shared_ptr<Service> s) : service(s), acceptor(*s->service()) {}
+    };
+    std::vector<std::shared_ptr<ServiceAcceptor>> _service_acceptors;
+    // Outstanding accept operation with its own socket. Service acceptor is
+    // nullptr for accept operations of the server acceptor.
+    struct AcceptOperation
+    {
+        std::shared_ptr<ServiceAcceptor> acceptor;
+        std::shared_ptr<Service> service;
+        asio::ip::tcp::socket socket;
+
+        explicit AcceptOperation(std::shared_ptr<ServiceAcceptor> a, std::shared_ptr<Service> s) : acceptor(a), service(s), socket(*s->service()) {}
+    };
+    // Server options
+    bool _reuse_port;
+    int _accept_backlog;
+    size_t _accept_concurrency;
+    size_t _send_size_limit;
+    size_t _buffer_min;
+    size_t _buffer_max;
+    size_t _send_buffer_high;
+    size_t _send_buffer_low;
+    bool _receive_pause;
+    size_t _session_pool_size;
+    std::chrono::steady_clock::duration _idle_timeout;
+    // Server statistic (updated by sessions from different threads)
+    Statistics _statistics;
     // Server sessions
-    std::map<CppCommon::UUID, std::shared_ptr<TSession>> _sessions;
+    std::mutex _sessions_lock;
+    SessionRegistry<TSession> _sessions;
+    // Session pool
+    std::mutex _session_pool_lock;
+    std::vector<std::unique_ptr<TSession>> _session_pool;
     // Multicast buffer
     std::mutex _multicast_lock;
     std::vector<uint8_t> _multicast_buffer;
 
-    //! Accept new connections
-    void Accept();
+    //! Open a new server acceptor in the given Asio service
+    /*!
+        \param service - Asio service
+        \return Opened and listening server acceptor
+    */
+    asio::ip::tcp::acceptor OpenAcceptor(std::shared_ptr<Service>& service);
+
+    //! Accept new connections with the given accept operation
+    /*!
+        \param operation - Accept operation
+    */
+    void Accept(std::shared_ptr<AcceptOperation> operation);
+    //! Accept all connections ready without waiting with the given accept operation
+    /*!
+        \param operation - Accept operation
+    */
+    void AcceptReady(AcceptOperation& operation);
+    //! Prepare a new socket of the given accept operation
+    /*!
+        The socket is placed into the next service of the pool or into the
+        service of the SO_REUSEPORT acceptor.
+
+        \param operation - Accept operation
+    */
+    void PrepareAccept(AcceptOperation& operation);
+
+    //! Create a new session or reuse the pooled one
+    /*!
+        \param socket - Accepted socket
+        \return Created session
+    */
+    std::shared_ptr<TSession> CreateSession(asio::ip::tcp::socket&& socket);
+    //! Release the session which is not referred anymore into the session pool
+    /*!
+        \param session - Released session
+    */
+    void ReleaseSession(TSession* session);
 
     //! Register a new session
-    std::shared_ptr<TSession> RegisterSession();
+    /*!
+        \param socket - Accepted socket
+        \param service - Asio service to host the session
+        \return Registered session
+    */
+    std::shared_ptr<TSession> RegisterSession(asio::ip::tcp::socket&& socket, std::shared_ptr<Service>& service);
     //! Unregister the given session
     /*!
         \param id - Session Id
     */
-    void UnregisterSession(const CppCommon::UUID& id);
+    void UnregisterSession(SessionId id);
+    //! Copy all registered sessions
+    /*!
+        Sessions are called outside of the sessions lock, because their
+        calls could unregister them or call server handlers in place.
+
+        \return Copy of registered sessions
+    */
+    std::vector<std::shared_ptr<TSession>> CopySessions();
+
+    //! Complete the graceful stop of the server
+    /*!
+        Called once by the last drained session or by the drain timeout.
+    */
+    void CompleteDrain();
+    //! Update the server state stopped and signal threads waiting for it
+    void Stopped();
 
     //! Clear multicast buffer
     void ClearBuffers();
@@ -14,10 +14,20 @@ inline SSLServer<TServer, TSession>::SSLServer(std::shared_ptr<Service> service,
     : _service(service),
       _context(context),
       _acceptor(*_service->service()),
-      _socket(*_service->service()),
       _started(false),
-      _bytes_sent(0),
-      _bytes_received(0)
+      _draining(false),
+      _drain_timer(0),
+      _reuse_port(false),
+      _accept_backlog(asio::socket_base::max_connections),
+      _accept_concurrency(1),
+      _send_size_limit(0),
+      _buffer_min(4096),
+      _buffer_max(1048576),
+      _send_buffer_high(0),
+      _send_buffer_low(0),
+      _receive_pause(false),
+      _session_pool_size(0),
+      _idle_timeout(std::chrono::steady_clock::duration::zero())
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -43,10 +53,20 @@ inline SSLServer<TServer, TSession>::SSLServer(std::shared_ptr<Service> service,
     : _service(service),
       _context(context),
       _acceptor(*_service->service()),
-      _socket(*_service->service()),
       _started(false),
-      _bytes_sent(0),
-      _bytes_received(0)
+      _draining(false),
+      _drain_timer(0),
+      _reuse_port(false),
+      _accept_backlog(asio::socket_base::max_connections),
+      _accept_concurrency(1),
+      _send_size_limit(0),
+      _buffer_min(4096),
+      _buffer_max(1048576),
+      _send_buffer_high(0),
+      _send_buffer_low(0),
+      _receive_pause(false),
+      _session_pool_size(0),
+      _idle_timeout(std::chrono::steady_clock::duration::zero())
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -65,10 +85,20 @@ inline SSLServer<TServer, TSession>::SSLServer(std::shared_ptr<Service> service,
       _context(context),
       _endpoint(endpoint),
       _acceptor(*_service->service()),
-      _socket(*_service->service()),
       _started(false),
-      _bytes_sent(0),
-      _bytes_received(0)
+      _draining(false),
+      _drain_timer(0),
+      _reuse_port(false),
+      _accept_backlog(asio::socket_base::max_connections),
+      _accept_concurrency(1),
+      _send_size_limit(0),
+      _buffer_min(4096),
+      _buffer_max(1048576),
+      _send_buffer_high(0),
+      _send_buffer_low(0),
+      _receive_pause(false),
+      _session_pool_size(0),
+      _idle_timeout(std::chrono::steady_clock::duration::zero())
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -93,12 +123,33 @@ inline bool SSLServer<TServer, TSession>::Start()
         if (IsStarted())
             return;
 
-        // Create the server acceptor
-        _acceptor = asio::ip::tcp::acceptor(*_service->service(), _endpoint);
+        // Create server acceptors
+        bool reuse_port_acceptors = false;
+#if defined(SO_REUSEPORT)
+        reuse_port_acceptors = _reuse_port && (_pool != nullptr);
+#endif
+        if (reuse_port_acceptors)
+        {
+            // Create one server acceptor per service of the pool
+            for (auto& service : _pool->services())
+            {
+                auto acceptor = std::make_shared<ServiceAcceptor>(service);
+                acceptor->acceptor = OpenAcceptor(service);
+                _service_acceptors.emplace_back(acceptor);
+            }
+        }
+        else
+        {
+            // Create the server acceptor
+            _acceptor = OpenAcceptor(_service);
+
+            // Setup the acceptor strand for multi-threaded service
+            if ((_service->threads() > 1) && !_acceptor_strand)
+                _acceptor_strand = std::make_unique<asio::io_service::strand>(*_service->service());
+        }
 
         // Reset statistic
-        _bytes_sent = 0;
-        _bytes_received = 0;
+        _statistics.Reset();
 
         // Update the started flag
         _started = true;
@@ -106,15 +157,24 @@ inline bool SSLServer<TServer, TSession>::Start()
         // Call the server started handler
         onStarted();
 
-        // Perform the first server accept
-        Accept();
+        // Perform outstanding server accepts
+        for (size_t i = 0; i < _accept_concurrency; ++i)
+        {
+            if (_service_acceptors.empty())
+                Accept(std::make_shared<AcceptOperation>(nullptr, _service));
+            else
+            {
+                for (auto& acceptor : _service_acceptors)
+                    Accept(std::make_shared<AcceptOperation>(acceptor, acceptor->service));
+            }
+        }
     });
 
     return true;
 }
 
 template <class TServer, class TSession>
-inline bool SSLServer<TServer, TSession>::Stop()
+inline bool SSLServer<TServer, TSession>::Stop(const std::chrono::steady_clock::duration& timeout)
 {
     assert(IsStarted() && "SSL server is not started!");
     if (!IsStarted())
@@ -122,25 +182,65 @@ inline bool SSLServer<TServer, TSession>::Stop()
 
     // Post the stopped routine
     auto self(this->shared_from_this());
-    _service->service()->post([this, self]()
+    _service->service()->post([this, self, timeout]()
     {
-        if (!IsStarted())
+        if (!IsStarted() || IsDraining())
             return;
 
         // Close the server acceptor
-        _acceptor.close();
+        if (_acceptor.is_open())
+            _acceptor.close();
+
+        // Close server acceptors of the service pool in their own services
+        for (auto& acceptor : _service_acceptors)
+            acceptor->service->Dispatch([acceptor]() { acceptor->acceptor.close(); });
+        _service_acceptors.clear();
 
         // Clear multicast buffer
         ClearBuffers();
 
+        // Drain all sessions until the drain timeout
+        if (timeout.count() > 0)
+        {
+            std::vector<std::shared_ptr<TSession>> sessions;
+            {
+                std::lock_guard<std::mutex> locker(_sessions_lock);
+
+                _draining = true;
+
+                // Abort sessions which are not drained until the drain timeout
+                _drain_timer = _service->Schedule(timeout, [this, self]()
+                {
+                    if (!IsDraining())
+                        return;
+
+                    auto sessions = CopySessions();
+                    for (auto& session : sessions)
+                        session->Abort();
+
+                    // Otherwise the last unregistered session completes the drain
+                    if (sessions.empty())
+                        CompleteDrain();
+                });
+
+                sessions.assign(_sessions.begin(), _sessions.end());
+            }
+
+            // Drain all sessions. Each session is drained in its own service.
+            for (auto& session : sessions)
+                session->Drain();
+
+            // Stop the server without sessions at once
+            if (sessions.empty())
+                CompleteDrain();
+            return;
+        }
+
         // Disconnect all sessions
         DisconnectAll();
 
-        // Update the started flag
-        _started = false;
-
-        // Call the server stopped handler
-        onStopped();
+        // Stop the server
+        Stopped();
     });
 
     return true;
@@ -152,36 +252,154 @@ inline bool SSLServer<TServer, TSession>::Restart()
     if (!Stop())
         return false;
 
-    while (IsStarted())
-        CppCommon::Thread::Yield();
+    WaitStopped();
 
     return Start();
 }
 
 template <class TServer, class TSession>
-inline void SSLServer<TServer, TSession>::Accept()
+inline void SSLServer<TServer, TSession>::WaitStopped()
+{
+    std::unique_lock<std::mutex> locker(_stopped_lock);
+    _stopped_event.wait(locker, [this]() { return !IsStarted(); });
+}
+
+template <class TServer, class TSession>
+inline void SSLServer<TServer, TSession>::CompleteDrain()
+{
+    // Complete the drain only once
+    if (!_draining.exchange(false))
+        return;
+
+    // Cancel the drain timeout
+    _service->Cancel(_drain_timer);
+    _drain_timer = 0;
+
+    // Stop the server
+    Stopped();
+}
+
+template <class TServer, class TSession>
+inline void SSLServer<TServer, TSession>::Stopped()
+{
+    // Update the started flag
+    _started = false;
+
+    // Call the server stopped handler
+    onStopped();
+
+    // Wake up threads waiting for the server to be stopped
+    std::lock_guard<std::mutex> locker(_stopped_lock);
+    _stopped_event.notify_all();
+}
+
+template <class TServer, class TSession>
+inline asio::ip::tcp::acceptor SSLServer<TServer, TSession>::OpenAcceptor(std::shared_ptr<Service>& service)
+{
+    asio::ip::tcp::acceptor acceptor(*service->service());
+
+    // Open and bind the server acceptor
+    acceptor.open(_endpoint.protocol());
+    acceptor.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+#if defined(SO_REUSEPORT)
+    if (_reuse_port)
+    {
+        typedef asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> reuse_port;
+        acceptor.set_option(reuse_port(true));
+    }
+#endif
+    acceptor.bind(_endpoint);
+    acceptor.listen(_accept_backlog);
+
+    // Non-blocking acceptor fails with would_block when no more connections are ready to accept
+    acceptor.non_blocking(true);
+
+    return acceptor;
+}
+
+template <class TServer, class TSession>
+inline void SSLServer<TServer, TSession>::Accept(std::shared_ptr<AcceptOperation> operation)
 {
     if (!IsStarted())
         return;
 
-    // Dispatch the disconnect routine
     auto self(this->shared_from_this());
-    _service->Dispatch([this, self]()
+    auto accept = [this, self, operation]()
     {
         if (!IsStarted())
             return;
 
-        _acceptor.async_accept(_socket, [this, self](std::error_code ec)
+        asio::ip::tcp::acceptor& acceptor = (operation->acceptor != nullptr) ? operation->acceptor->acceptor : _acceptor;
+        if (!acceptor.is_open())
+            return;
+
+        // Prepare a new socket to accept
+        PrepareAccept(*operation);
+
+        auto async_accept_handler = [this, self, operation](std::error_code ec)
         {
             if (!ec)
-                RegisterSession();
+            {
+                RegisterSession(std::move(operation->socket), operation->service);
+
+                // Accept all other ready connections without waiting for another wakeup
+                AcceptReady(*operation);
+            }
             else
                 SendError(ec);
 
             // Perform the next server accept
-            Accept();
-        });
-    });
+            Accept(operation);
+        };
+
+        // Accept handlers of the server acceptor in the multi-threaded service are serialized by the acceptor strand
+        if ((operation->acceptor == nullptr) && _acceptor_strand)
+            acceptor.async_accept(operation->socket, _acceptor_strand->wrap(async_accept_handler));
+        else
+            acceptor.async_accept(operation->socket, async_accept_handler);
+    };
+
+    // Dispatch the accept routine in the acceptor service
+    if (operation->acceptor != nullptr)
+        operation->acceptor->service->Dispatch(accept);
+    else if (_acceptor_strand)
+        _acceptor_strand->dispatch(accept);
+    else
+        _service->Dispatch(accept);
+}
+
+template <class TServer, class TSession>
+inline void SSLServer<TServer, TSession>::AcceptReady(AcceptOperation& operation)
+{
+    asio::ip::tcp::acceptor& acceptor = (operation.acceptor != nullptr) ? operation.acceptor->acceptor : _acceptor;
+
+    // Accept up to the backlog of ready connections
+    for (int i = 1; (i < _accept_backlog) && IsStarted() && acceptor.is_open(); ++i)
+    {
+        PrepareAccept(operation);
+
+        asio::error_code ec;
+        acceptor.accept(operation.socket, ec);
+        if (ec)
+        {
+            // Stop accepting when no more connections are ready
+            if ((ec != asio::error::would_block) && (ec != asio::error::try_again))
+                SendError(ec);
+            break;
+        }
+
+        RegisterSession(std::move(operation.socket), operation.service);
+    }
+}
+
+template <class TServer, class TSession>
+inline void SSLServer<TServer, TSession>::PrepareAccept(AcceptOperation& operation)
+{
+    // Place the accepted socket into the next service of the pool. Sockets
+    // of SO_REUSEPORT acceptors stay in the acceptor service.
+    if ((operation.acceptor == nullptr) && (_pool != nullptr))
+        operation.service = _pool->GetNextService();
+    operation.socket = asio::ip::tcp::socket(*operation.service->service());
 }
 
 template <class TServer, class TSession>
@@ -207,18 +425,49 @@ inline bool SSLServer<TServer, TSession>::Multicast(const void* buffer, size_t s
     auto self(this->shared_from_this());
     _service->Dispatch([this, self]()
     {
-        std::lock_guard<std::mutex> locker(_multicast_lock);
+        std::shared_ptr<const Buffer> multicast;
+        {
+            std::lock_guard<std::mutex> locker(_multicast_lock);
 
-        // Check for empty multicast buffer
-        if (_multicast_buffer.empty())
-            return;
+            // Check for empty multicast buffer
+            if (_multicast_buffer.empty())
+                return;
+
+            // Move the multicast buffer into the shared buffer once for all sessions
+            multicast = std::make_shared<const Buffer>(std::move(_multicast_buffer));
+
+            // Clear the multicast buffer
+            _multicast_buffer.clear();
+        }
+
+        // Multicast all sessions. Each session enqueues the shared buffer and sends it in its own service.
+        for (auto& session : CopySessions())
+            session->Send(multicast);
+    });
+
+    return true;
+}
+
+template <class TServer, class TSession>
+inline bool SSLServer<TServer, TSession>::Multicast(std::shared_ptr<const Buffer> buffer)
+{
+    assert((buffer != nullptr) && "Shared buffer should not be equal to 'nullptr'!");
+    if ((buffer == nullptr) || buffer->empty())
+        return false;
+
+    if (!IsStarted())
+        return false;
 
-        // Multicast all sessions
-        for (auto& session : _sessions)
-            session.second->Send(_multicast_buffer.data(), _multicast_buffer.size());
+    // Dispatch the multicast routine
+    auto self(this->shared_from_this());
+    _service->Dispatch([this, self, buffer]()
+    {
+        if (!IsStarted())
+            return;
 
-        // Clear the multicast buffer
-        _multicast_buffer.clear();
+        // Multicast all sessions. Each session enqueues the shared buffer and sends it in its own service.
+        for (auto& session : CopySessions())
+            session->Send(buffer);
     });
 
     return true;
@@ -237,25 +486,98 @@ inline bool SSLServer<TServer, TSession>::DisconnectAll()
         if (!IsStarted())
             return;
 
-        // Disconnect all sessions
-        for (auto& session : _sessions)
-            session.second->Disconnect();
+        // Disconnect all sessions. Each session is disconnected in its own service.
+        for (auto& session : CopySessions())
+            session->Disconnect();
     });
 
     return true;
 }
 
 template <class TServer, class TSession>
-inline std::shared_ptr<TSession> SSLServer<TServer, TSession>::RegisterSession()
+inline std::shared_ptr<TSession> SSLServer<TServer, TSession>::FindSession(SessionId id)
+{
+    std::lock_guard<std::mutex> locker(_sessions_lock);
+    return _sessions.Find(id);
+}
+
+template <class TServer, class TSession>
+inline std::vector<std::shared_ptr<TSession>> SSLServer<TServer, TSession>::CopySessions()
+{
+    std::lock_guard<std::mutex> locker(_sessions_lock);
+    return std::vector<std::shared_ptr<TSession>>(_sessions.begin(), _sessions.end());
+}
+
+template <class TServer, class TSession>
+inline std::shared_ptr<TSession> SSLServer<TServer, TSession>::CreateSession(asio::ip::tcp::socket&& socket)
 {
-    // Create and register a new session
     auto self(this->shared_from_this());
-    auto session = std::make_shared<TSession>(self, std::move(_socket), _context);
-    _sessions.emplace(session->id(), session);
 
-    // Connect a new session
+    // Create a new session without the session pool
+    if (_session_pool_size == 0)
+        return std::make_shared<TSession>(self, std::move(socket), _context);
+
+    // Take the pooled session
+    std::unique_ptr<TSession> session;
+    {
+        std::lock_guard<std::mutex> locker(_session_pool_lock);
+        if (!_session_pool.empty())
+        {
+            session = std::move(_session_pool.back());
+            _session_pool.pop_back();
+        }
+    }
+
+    // Reuse the pooled session with the accepted socket or create a new one
+    if (session)
+    {
+        session->_server = self;
+        session->_stream = std::make_unique<asio::ssl::stream<asio::ip::tcp::socket>>(std::move(socket), *_context);
+    }
+    else
+        session = std::make_unique<TSession>(self, std::move(socket), _context);
+
+    // Release the session into the session pool when it is not referred anymore
+    return std::shared_ptr<TSession>(session.release(), [](TSession* released)
+    {
+        // Keep the server alive until the session is released
+        auto server = released->_server;
+        server->ReleaseSession(released);
+    });
+}
+
+template <class TServer, class TSession>
+inline void SSLServer<TServer, TSession>::ReleaseSession(TSession* session)
+{
+    std::unique_ptr<TSession> released(session);
+
+    // Reset the session and detach it from the server
+    released->Reset();
+    released->_server.reset();
+
+    // Keep the session in the session pool or destroy it if the pool is full
+    std::lock_guard<std::mutex> locker(_session_pool_lock);
+    if (_session_pool.size() < _session_pool_size)
+        _session_pool.push_back(std::move(released));
+}
+
+template <class TServer, class TSession>
+inline std::shared_ptr<TSession> SSLServer<TServer, TSession>::RegisterSession(asio::ip::tcp::socket&& socket, std::shared_ptr<Service>& service)
+{
+    // Create and register a new session
+    auto session = CreateSession(std::move(socket));
+    session->_service = service;
+    {
+        std::lock_guard<std::mutex> locker(_sessions_lock);
+        session->_id = _sessions.Register(session);
+    }
+
+    // Connect a new session in its own service
     session->Connect();
 
+    // Update statistic
+    _statistics.AddConnect();
+
     // Call a new session connected handler
     onConnected(session);
 
@@ -263,17 +585,33 @@ inline std::shared_ptr<TSession> SSLServer<TServer, TSession>::RegisterSession()
 }
 
 template <class TServer, class TSession>
-inline void SSLServer<TServer, TSession>::UnregisterSession(const CppCommon::UUID& id)
+inline void SSLServer<TServer, TSession>::UnregisterSession(SessionId id)
 {
-    // Try to find the unregistered session
-    auto it = _sessions.find(id);
-    if (it != _sessions.end())
+    std::shared_ptr<TSession> session;
+    bool drained;
+
+    // Try to find and erase the unregistered session
     {
-        // Call the session disconnected handler
-        onDisconnected(it->second);
+        std::lock_guard<std::mutex> locker(_sessions_lock);
+        session = _sessions.Unregister(id);
+        if (session == nullptr)
+            return;
+
+        // Check for the last drained session
+        drained = IsDraining() && (_sessions.size() == 0);
+    }
 
-        // Erase the session
-        _sessions.erase(it);
+    // Update statistic
+    _statistics.AddDisconnect();
+
+    // Call the session disconnected handler
+    onDisconnected(session);
+
+    // Complete the graceful stop of the server in its own service
+    if (drained)
+    {
+        auto self(this->shared_from_this());
+        _service->Dispatch([this, self]() { CompleteDrain(); });
     }
 }
 
@@ -300,6 +638,9 @@ inline void SSLServer<TServer, TSession>::SendError(std::error_code ec)
     if (ec.value() == 995)
         return;
 
+    // Update statistic
+    _statistics.AddError();
+
     onError(ec.value(), ec.category().name(), ec.message());
 }
 
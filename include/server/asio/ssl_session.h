@@ -21,7 +21,11 @@ class SSLServer;
 /*!
     SSL session is used to read and write data from the connected SSL client.
 
-    Thread-safe.
+    Data to send is enqueued into the lock-free send queue by any thread and
+    sent by the IO thread, so producers never wait for each other.
+
+    Thread-safe. If the Asio service runs several working threads all session
+    handlers are serialized by the session strand.
 */
 template <class TServer, class TSession>
 class SSLSession : public std::enable_shared_from_this<SSLSession<TServer, TSession>>
@@ -39,22 +43,32 @@ public:
     explicit SSLSession(std::shared_ptr<SSLServer<TServer, TSession>> server, asio::ip::tcp::socket&& socket, std::shared_ptr<asio::ssl::context> context);
     SSLSession(const SSLSession&) = delete;
     SSLSession(SSLSession&&) = default;
-    virtual ~SSLSession() = default;
+    virtual ~SSLSession() { ClearBuffers(); }
 
     SSLSession& operator=(const SSLSession&) = delete;
     SSLSession& operator=(SSLSession&&) = default;
 
     //! Get the session Id
-    const CppCommon::UUID& id() const noexcept { return _id; }
+    /*!
+        Session Id is assigned by the server when the session is registered.
+    */
+    SessionId id() const noexcept { return _id; }
+    //! Get the session UUID
+    /*!
+        Session UUID is generated on the first call, so sessions that never
+        use it do not pay for the UUID generation. The session reused by the
+        server session pool generates a new UUID.
+    */
+    const CppCommon::UUID& uuid() const;
 
     //! Get the Asio service
-    std::shared_ptr<Service>& service() noexcept { return _server->service(); }
+    std::shared_ptr<Service>& service() noexcept { return _service; }
     //! Get the session server
     std::shared_ptr<SSLServer<TServer, TSession>>& server() noexcept { return _server; }
     //! Get the session SSL stream
-    asio::ssl::stream<asio::ip::tcp::socket>& stream() noexcept { return _stream; }
+    asio::ssl::stream<asio::ip::tcp::socket>& stream() noexcept { return *_stream; }
     //! Get the session socket
-    asio::ssl::stream<asio::ip::tcp::socket>::lowest_layer_type& socket() noexcept { return _stream.lowest_layer(); }
+    asio::ssl::stream<asio::ip::tcp::socket>::lowest_layer_type& socket() noexcept { return _stream->lowest_layer(); }
     //! Get the session SSL context
     std::shared_ptr<asio::ssl::context>& context() noexcept { return _context; }
 
@@ -78,15 +92,55 @@ public:
     /*!
         \param buffer - Buffer to send
         \param size - Buffer size
-        \return Count of pending bytes in the send buffer
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
     */
     size_t Send(const void* buffer, size_t size);
     //! Send a text string into the session
     /*!
         \param text - Text string to send
-        \return Count of pending bytes in the send buffer
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
     */
     size_t Send(const std::string& text) { return Send(text.data(), text.size()); }
+    //! Send the shared buffer into the session
+    /*!
+        The shared buffer is queued by reference without copying its content,
+        so the same buffer could be sent by many sessions or clients at once.
+        The buffer content must not be changed until it is sent.
+
+        \param buffer - Shared buffer to send
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
+    */
+    size_t Send(std::shared_ptr<const Buffer> buffer);
+
+    //! Receive data from the session asynchronously (C++20 coroutines)
+    /*!
+        Awaits the next chunk of data received from the client and copies it
+        into the given buffer. Unread data of the receive buffer is returned
+        at once. Once the data is awaited the session stops calling onReceived()
+        handler and receives only when the next chunk is awaited, so a slow
+        coroutine applies backpressure to the client.
+
+        Should be awaited in the IO thread of the handshaked session.
+
+        \param buffer - Buffer to receive
+        \param size - Buffer size
+        
+eturn Awaitable count of received bytes or 0 if the session was disconnected
+    */
+    AsyncAwaitable<SSLSession> ReceiveAsync(void* buffer, size_t size);
+    //! Send data into the session asynchronously (C++20 coroutines)
+    /*!
+        Enqueues the data as Send() does and awaits until all pending data
+        including the given buffer is sent to the client.
+
+        Should be awaited in the IO thread of the handshaked session.
+
+        \param buffer - Buffer to send
+        \param size - Buffer size
+        
+eturn Awaitable count of sent bytes or 0 if the data was not sent
+    */
+    AsyncAwaitable<SSLSession> SendAsync(const void* buffer, size_t size);
 
 protected:
     //! Handle session connected notification
@@ -105,6 +159,9 @@ protected:
         If you want to wait for some more bytes from the client return the
         size of the buffer you want to keep until another chunk is received.
 
+        The given buffer is a view of all unread data in the receive buffer.
+        It is valid only until the handler returns.
+
         \param buffer - Received buffer
         \param size - Received buffer size
         \return Count of handled bytes
@@ -132,6 +189,36 @@ protected:
     */
     virtual void onEmpty() {}
 
+    //! Handle send buffer full notification
+    /*!
+        Notification is called when pending data of the send buffer reaches
+        the high watermark. New data to send is rejected until the send buffer
+        is drained down to the low watermark.
+    */
+    virtual void onSendBufferFull() {}
+    //! Handle send buffer drained notification
+    /*!
+        Notification is called when the full send buffer was drained down to
+        the low watermark and is ready for a new data to send.
+    */
+    virtual void onSendBufferDrained() {}
+
+    //! Handle session reset notification
+    /*!
+        Notification is called when the disconnected session is returned into
+        the server session pool to be reused by a new connection. All user
+        state of the session should be cleared here.
+    */
+    virtual void onReset() {}
+
+    //! Handle session idle timeout notification
+    /*!
+        Notification is called when nothing was received from or sent to the
+        client during the idle timeout of the server. The session is
+        disconnected right after this handler.
+    */
+    virtual void onIdleTimeout() {}
+
     //! Handle error notification
     /*!
         \param error - Error code
@@ -141,28 +228,50 @@ protected:
     virtual void onError(int error, const std::string& category, const std::string& message) {}
 
 private:
-    static const size_t CHUNK = 8192;
-
-    // Session Id
-    CppCommon::UUID _id;
-    // Session server, SSL stream and SSL context
+    // Session Id & lazily generated UUID
+    SessionId _id;
+    mutable std::mutex _uuid_lock;
+    mutable bool _uuid_generated;
+    mutable CppCommon::UUID _uuid;
+    // Session server, Asio service, SSL stream and SSL context. SSL stream
+    // could not be reused by another connection, so the pooled session
+    // creates a new one.
     std::shared_ptr<SSLServer<TServer, TSession>> _server;
-    asio::ssl::stream<asio::ip::tcp::socket> _stream;
+    std::shared_ptr<Service> _service;
+    std::unique_ptr<asio::io_service::strand> _strand;
+    bool _strand_required;
+    std::unique_ptr<asio::ssl::stream<asio::ip::tcp::socket>> _stream;
     std::shared_ptr<asio::ssl::context> _context;
     std::atomic<bool> _connected;
     std::atomic<bool> _handshaked;
-    // Session statistic
-    uint64_t _bytes_sent;
-    uint64_t _bytes_received;
-    // Receive buffer & cache
+    // Session statistic (updated by the IO thread, read from other threads)
+    Counter _bytes_sent;
+    Counter _bytes_received;
+    // Idle timeout
+    TimerId _idle_timer;
+    std::chrono::steady_clock::time_point _idle_activity;
+    // Receive buffer
     bool _reciving;
-    uint8_t _recive_buffer[CHUNK];
-    std::vector<uint8_t> _recive_cache;
-    // Send buffer & cache
+    std::vector<uint8_t> _recive_buffer;
+    size_t _recive_buffer_offset;
+    size_t _recive_buffer_size;
+    size_t _recive_size;
+    HandlerStorage _recive_storage;
+    // Send queue
     bool _sending;
-    std::mutex _send_lock;
-    uint8_t _send_buffer[CHUNK];
-    std::vector<uint8_t> _send_cache;
+    SendQueue _send_queue;
+    SendFlush _send_flush;
+    std::atomic<size_t> _send_pending;
+    std::atomic<bool> _send_scheduled;
+    std::atomic<bool> _send_full;
+    bool _send_full_notified;
+    HandlerStorage _send_storage;
+    // Coroutine awaiters
+    bool _recive_async;
+    AsyncAwaiter* _recive_awaiter;
+    AsyncAwaiter* _send_awaiter;
+    // Graceful drain
+    bool _draining;
 
     //! Connect the session
     void Connect();
@@ -172,11 +281,79 @@ private:
         \return 'true' if the session was successfully disconnected, 'false' if the session is already disconnected
     */
     bool Disconnect(bool dispatch);
+    //! Drain the session
+    /*!
+        The session sends all pending data of its send buffer and then
+        disconnects with SSL shutdown.
+    */
+    void Drain();
+    //! Abort the session
+    /*!
+        Closes the session socket, so all pending operations of the session
+        including SSL shutdown fail and the session is disconnected at once.
+    */
+    void Abort();
+
+    //! Perform SSL handshake
+    void Handshake();
 
     //! Try to receive new data
     void TryReceive();
     //! Try to send pending data
     void TrySend();
+    //! Update the send buffer state with the given pending size
+    /*!
+        Calls send buffer full/drained handlers and resumes receiving paused
+        by the full send buffer.
+
+        \param pending - Size of pending buffer
+    */
+    void UpdateSendBuffer(size_t pending);
+
+    //! Start to await received data
+    /*!
+        \param awaiter - Receive awaiter
+        \return 'true' if the awaiter is registered, 'false' if the receive is already completed
+    */
+    bool StartReceiveAsync(AsyncAwaiter& awaiter);
+    //! Start to await sent data
+    /*!
+        \param awaiter - Send awaiter
+        \return 'true' if the awaiter is registered, 'false' if the send is already completed
+    */
+    bool StartSendAsync(AsyncAwaiter& awaiter);
+    //! Read unread data of the receive buffer into the given buffer
+    /*!
+        \param buffer - Buffer to read
+        \param size - Buffer size
+        \return Count of read bytes
+    */
+    size_t ReadBuffer(void* buffer, size_t size);
+    //! Complete all registered awaiters of the disconnected session
+    void CompleteAsync();
+
+    //! Schedule the idle timeout check after the given delay
+    /*!
+        \param delay - Delay to check the idle timeout
+    */
+    void ScheduleIdleTimeout(const std::chrono::steady_clock::duration& delay);
+    //! Check the idle timeout of the session
+    /*!
+        Activity of the session only updates its timestamp, so the idle timer
+        is not rescheduled on each receive or send. When the timer expires the
+        session is disconnected if it was idle long enough. Otherwise the timer
+        is scheduled again for the rest of the idle timeout.
+    */
+    void CheckIdleTimeout();
+    //! Cancel the idle timeout of the session
+    void CancelIdleTimeout();
+
+    //! Reset the released session to be reused by the session pool
+    /*!
+        Keeps the capacity of receive & send buffers up to the maximal buffer
+        size and calls the session reset handler.
+    */
+    void Reset();
 
     //! Clear receive & send buffers
     void ClearBuffers();
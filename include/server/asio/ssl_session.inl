@@ -9,22 +9,46 @@
 namespace CppServer {
 namespace Asio {
 
-template <class TServer, class TSession>
-const size_t SSLSession<TServer, TSession>::CHUNK;
-
 template <class TServer, class TSession>
 inline SSLSession<TServer, TSession>::SSLSession(std::shared_ptr<SSLServer<TServer, TSession>> server, asio::ip::tcp::socket&& socket, std::shared_ptr<asio::ssl::context> context)
-    : _id(CppCommon::UUID::Generate()),
+    : _id(0),
+      _uuid_generated(false),
       _server(server),
-      _stream(std::move(socket), *context),
+      _service(server->service()),
+      _strand_required(false),
+      _stream(std::make_unique<asio::ssl::stream<asio::ip::tcp::socket>>(std::move(socket), *context)),
       _context(context),
       _connected(false),
       _handshaked(false),
       _bytes_sent(0),
       _bytes_received(0),
+      _idle_timer(0),
       _reciving(false),
-      _sending(false)
+      _recive_buffer_offset(0),
+      _recive_buffer_size(0),
+      _recive_size(0),
+      _sending(false),
+      _send_pending(0),
+      _send_scheduled(false),
+      _send_full(false),
+      _send_full_notified(false),
+      _recive_async(false),
+      _recive_awaiter(nullptr),
+      _send_awaiter(nullptr),
+      _draining(false)
+{
+}
+
+template <class TServer, class TSession>
+inline const CppCommon::UUID& SSLSession<TServer, TSession>::uuid() const
 {
+    std::lock_guard<std::mutex> locker(_uuid_lock);
+    if (!_uuid_generated)
+    {
+        _uuid = CppCommon::UUID::Generate();
+        _uuid_generated = true;
+    }
+    return _uuid;
 }
 
 template <class TServer, class TSession>
@@ -33,19 +57,51 @@ inline void SSLSession<TServer, TSession>::Connect()
     if (IsConnected() || IsHandshaked())
         return;
 
-    // Reset statistic
-    _bytes_sent = 0;
-    _bytes_received = 0;
+    // Setup the session strand for multi-threaded service
+    _strand_required = (_service->threads() > 1);
+    if (_strand_required)
+        _strand = std::make_unique<asio::io_service::strand>(*_service->service());
+
+    auto self(this->shared_from_this());
+    auto connect = [this, self]()
+    {
+        // Reset statistic
+        _bytes_sent = 0;
+        _bytes_received = 0;
+
+        // Reset the adaptive receive size
+        _recive_size = _server->option_buffer_min();
 
-    // Update the connected flag
-    _connected = true;
+        // Update the connected flag
+        _connected = true;
 
-    // Call the session connected handler
-    onConnected();
+        // Start the idle timeout of the session
+        auto timeout = _server->option_idle_timeout();
+        if (timeout.count() > 0)
+        {
+            _idle_activity = std::chrono::steady_clock::now();
+            ScheduleIdleTimeout(timeout);
+        }
 
-    // Perform SSL handshake
+        // Call the session connected handler
+        onConnected();
+
+        // Perform SSL handshake
+        Handshake();
+    };
+
+    // Dispatch the connect routine
+    if (_strand_required)
+        _strand->dispatch(connect);
+    else
+        service()->Dispatch(connect);
+}
+
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::Handshake()
+{
     auto self(this->shared_from_this());
-    _stream.async_handshake(asio::ssl::stream_base::server, [this, self](std::error_code ec)
+    auto async_handshake_handler = [this, self](std::error_code ec)
     {
         if (IsHandshaked())
             return;
@@ -70,7 +126,13 @@ inline void SSLSession<TServer, TSession>::Connect()
             SendError(ec);
             Disconnect(true);
         }
-    });
+    };
+
+    // SSL stream handlers of the multi-threaded service are serialized by the session strand
+    if (_strand_required)
+        _stream->async_handshake(asio::ssl::stream_base::server, _strand->wrap(async_handshake_handler));
+    else
+        _stream->async_handshake(asio::ssl::stream_base::server, async_handshake_handler);
 }
 
 template <class TServer, class TSession>
@@ -85,8 +147,10 @@ inline bool SSLSession<TServer, TSession>::Disconnect(bool dispatch)
         if (!IsConnected())
             return;
 
-        // Shutdown the client stream
-        _stream.async_shutdown([this, self](std::error_code ec)
+        // Cancel the idle timeout of the session
+        CancelIdleTimeout();
+
+        auto async_shutdown_handler = [this, self](std::error_code ec)
         {
             if (!IsConnected())
                 return;
@@ -106,20 +170,92 @@ inline bool SSLSession<TServer, TSession>::Disconnect(bool dispatch)
             // Call the session disconnected handler
             onDisconnected();
 
+            // Resume coroutines awaiting the disconnected session
+            CompleteAsync();
+
             // Unregister the session
             _server->UnregisterSession(id());
-        });
+        };
+
+        // Shutdown the client stream
+        if (_strand_required)
+            _stream->async_shutdown(_strand->wrap(async_shutdown_handler));
+        else
+            _stream->async_shutdown(async_shutdown_handler);
     };
 
     // Dispatch or post the disconnect routine
-    if (dispatch)
-        service()->Dispatch(disconnect);
+    if (_strand_required)
+    {
+        if (dispatch)
+            _strand->dispatch(disconnect);
+        else
+            _strand->post(disconnect);
+    }
     else
-        service()->Post(disconnect);
+    {
+        if (dispatch)
+            service()->Dispatch(disconnect);
+        else
+            service()->Post(disconnect);
+    }
 
     return true;
 }
 
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::Drain()
+{
+    if (!IsConnected())
+        return;
+
+    auto self(this->shared_from_this());
+    auto drain = [this, self]()
+    {
+        if (!IsConnected() || _draining)
+            return;
+
+        _draining = true;
+
+        // Disconnect the idle session at once. The busy session is disconnected when its send buffer is empty.
+        if (_send_pending == 0)
+            Disconnect(true);
+    };
+
+    // Post the drain routine
+    if (_strand_required)
+        _strand->post(drain);
+    else
+        service()->Post(drain);
+}
+
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::Abort()
+{
+    if (!IsConnected())
+        return;
+
+    auto self(this->shared_from_this());
+    auto abort = [this, self]()
+    {
+        if (!IsConnected())
+            return;
+
+        // Close the session socket to fail all pending operations
+        asio::error_code ec;
+        socket().close(ec);
+
+        // Disconnect the session without waiting for the client
+        Disconnect(true);
+    };
+
+    // Post the abort routine
+    if (_strand_required)
+        _strand->post(abort);
+    else
+        service()->Post(abort);
+}
+
 template <class TServer, class TSession>
 inline size_t SSLSession<TServer, TSession>::Send(const void* buffer, size_t size)
 {
@@ -131,23 +267,95 @@ inline size_t SSLSession<TServer, TSession>::Send(const void* buffer, size_t siz
     if (!IsHandshaked())
         return 0;
 
+    // Reject data while the send buffer is full
+    if (_send_full)
+        return 0;
+
+    // Account the pending size before the data is enqueued, so the send
+    // routine never observes enqueued data which is not yet pending
+    size_t pending = (_send_pending += size);
+
+    // Enqueue a copy of the buffer into the lock-free send queue
+    _send_queue.Enqueue(buffer, size);
+
+    // Mark the send buffer as full when it reaches the high watermark
+    size_t high = _server->option_send_buffer_high();
+    bool full = (high > 0) && (pending >= high) && !_send_full.exchange(true);
+
+    // Dispatch the send routine unless it is already scheduled or when the
+    // send buffer became full. Otherwise the enqueued data is picked up by
+    // the scheduled send routine.
+    bool schedule = !_send_scheduled.exchange(true);
+    if (schedule || full)
     {
-        std::lock_guard<std::mutex> locker(_send_lock);
+        auto self(this->shared_from_this());
+        auto send = [this, self]()
+        {
+            // Update the send buffer state
+            UpdateSendBuffer(_send_pending);
 
-        // Fill the send buffer
-        const uint8_t* bytes = (const uint8_t*)buffer;
-        _send_cache.insert(_send_cache.end(), bytes, bytes + size);
+            // Try to send the buffer
+            TrySend();
+        };
+
+        if (_strand_required)
+            _strand->dispatch(send);
+        else
+            service()->Dispatch(send);
     }
 
-    // Dispatch the send routine
-    auto self(this->shared_from_this());
-    service()->Dispatch([this, self]()
+    return pending;
+}
+
+template <class TServer, class TSession>
+inline size_t SSLSession<TServer, TSession>::Send(std::shared_ptr<const Buffer> buffer)
+{
+    assert((buffer != nullptr) && "Shared buffer should not be equal to 'nullptr'!");
+    if ((buffer == nullptr) || buffer->empty())
+        return 0;
+
+    if (!IsHandshaked())
+        return 0;
+
+    // Reject data while the send buffer is full
+    if (_send_full)
+        return 0;
+
+    // Account the pending size before the data is enqueued, so the send
+    // routine never observes enqueued data which is not yet pending
+    size_t size = buffer->size();
+    size_t pending = (_send_pending += size);
+
+    // Enqueue the shared buffer reference without copying its content
+    _send_queue.Enqueue(std::move(buffer));
+
+    // Mark the send buffer as full when it reaches the high watermark
+    size_t high = _server->option_send_buffer_high();
+    bool full = (high > 0) && (pending >= high) && !_send_full.exchange(true);
+
+    // Dispatch the send routine unless it is already scheduled or when the
+    // send buffer became full. Otherwise the enqueued data is picked up by
+    // the scheduled send routine.
+    bool schedule = !_send_scheduled.exchange(true);
+    if (schedule || full)
     {
-        // Try to send the buffer
-        TrySend();
-    });
+        auto self(this->shared_from_this());
+        auto send = [this, self]()
+        {
+            // Update the send buffer state
+            UpdateSendBuffer(_send_pending);
+
+            // Try to send the buffer
+            TrySend();
+        };
+
+        if (_strand_required)
+            _strand->dispatch(send);
+        else
+            service()->Dispatch(send);
+    }
 
-    return _send_cache.size();
+    return pending;
 }
 
 template <class TServer, class TSession>
@@ -159,30 +367,93 @@ inline void SSLSession<TServer, TSession>::TryReceive()
     if (!IsHandshaked())
         return;
 
+    // Receive coroutine data only when the next chunk is awaited
+    if (_recive_async && (_recive_awaiter == nullptr))
+        return;
+
+    // Pause receiving while the peer does not drain the full send buffer
+    if (_send_full && _server->option_receive_pause())
+        return;
+
+    // Release the receive buffer above the receive size when all received data is handled
+    if ((_recive_buffer_size == 0) && (_recive_buffer.size() > (2 * _recive_size)))
+    {
+        _recive_buffer.resize(_recive_size);
+        _recive_buffer.shrink_to_fit();
+    }
+
+    // Prepare the free space for the receive size at the tail of the receive buffer
+    if ((_recive_buffer.size() - _recive_buffer_size) < _recive_size)
+    {
+        // Compact unread data to the front of the receive buffer
+        if (_recive_buffer_offset > 0)
+        {
+            std::memmove(_recive_buffer.data(), _recive_buffer.data() + _recive_buffer_offset, _recive_buffer_size - _recive_buffer_offset);
+            _recive_buffer_size -= _recive_buffer_offset;
+            _recive_buffer_offset = 0;
+        }
+
+        // Grow the receive buffer if it is still too small
+        if ((_recive_buffer.size() - _recive_buffer_size) < _recive_size)
+            _recive_buffer.resize(_recive_buffer_size + _recive_size);
+    }
+
     _reciving = true;
     auto self(this->shared_from_this());
-    _stream.async_read_some(asio::buffer(_recive_buffer), [this, self](std::error_code ec, std::size_t size)
+    auto async_receive_handler = [this, self](std::error_code ec, std::size_t size)
     {
         _reciving = false;
 
         if (!IsHandshaked())
             return;
 
+        AsyncAwaiter* awaiter = nullptr;
+
         // Received some data from the client
         if (size > 0)
         {
             // Update statistic
             _bytes_received += size;
-            _server->_bytes_received += size;
+            _server->_statistics.AddReceived(size);
 
-            // Fill receive buffer
-            _recive_cache.insert(_recive_cache.end(), _recive_buffer, _recive_buffer + size);
+            // Update the idle timeout activity
+            if (_idle_timer != 0)
+                _idle_activity = std::chrono::steady_clock::now();
 
-            // Call the buffer received handler
-            size_t handled = onReceived(_recive_cache.data(), _recive_cache.size());
+            // Data was received directly into the free tail of the receive buffer
+            _recive_buffer_size += size;
 
-            // Erase the handled buffer
-            _recive_cache.erase(_recive_cache.begin(), _recive_cache.begin() + handled);
+            // Grow the receive size while receive operations fill it up and
+            // fall back when they return less than a half of it
+            size_t buffer_min = _server->option_buffer_min();
+            size_t buffer_max = _server->option_buffer_max();
+            if (size >= _recive_size)
+                _recive_size = std::min(2 * _recive_size, buffer_max);
+            else
+            {
+                while ((_recive_size > buffer_min) && (size < (_recive_size / 2)))
+                    _recive_size = std::max(_recive_size / 2, buffer_min);
+            }
+
+            if (_recive_awaiter != nullptr)
+            {
+                // Read received data into the buffer of the awaiting coroutine
+                awaiter = std::exchange(_recive_awaiter, nullptr);
+                awaiter->result = ReadBuffer(awaiter->buffer, awaiter->size);
+            }
+            else
+            {
+                // Call the buffer received handler with all unread data
+                size_t handled = onReceived(_recive_buffer.data() + _recive_buffer_offset, _recive_buffer_size - _recive_buffer_offset);
+
+                // Skip the handled data. Reset the receive buffer if all data was handled.
+                _recive_buffer_offset += handled;
+                if (_recive_buffer_offset >= _recive_buffer_size)
+                {
+                    _recive_buffer_offset = 0;
+                    _recive_buffer_size = 0;
+                }
+            }
         }
 
         // Try to receive again if the session is valid
@@ -193,7 +464,19 @@ inline void SSLSession<TServer, TSession>::TryReceive()
             SendError(ec);
             Disconnect(true);
         }
-    });
+
+        // Resume the coroutine awaiting received data
+        if (awaiter != nullptr)
+            awaiter->Complete(awaiter->result);
+    };
+
+    // SSL stream handlers of the multi-threaded service are serialized by the session strand
+    // Memory of receive operations is recycled by the receive handler storage
+    auto buffer = asio::buffer(_recive_buffer.data() + _recive_buffer_size, _recive_buffer.size() - _recive_buffer_size);
+    if (_strand_required)
+        _stream->async_read_some(buffer, _strand->wrap(make_alloc_handler(_recive_storage, async_receive_handler)));
+    else
+        _stream->async_read_some(buffer, make_alloc_handler(_recive_storage, async_receive_handler));
 }
 
 template <class TServer, class TSession>
@@ -205,18 +488,37 @@ inline void SSLSession<TServer, TSession>::TrySend()
     if (!IsHandshaked())
         return;
 
-    size_t size;
+    // Dequeue all nodes enqueued by producers into the flush list
+    _send_flush.Fetch(_send_queue);
+
+    // Check for nothing to send
+    if (_send_flush.empty())
     {
-        std::lock_guard<std::mutex> locker(_send_lock);
+        // Stop sending until producers schedule the send routine again. Data
+        // pending before the scheduled flag is cleared is checked once more.
+        if (_send_pending == 0)
+        {
+            _send_scheduled = false;
+            if ((_send_pending == 0) || _send_scheduled.exchange(true))
+                return;
+        }
 
-        // Fill the send buffer
-        size = std::min(_send_cache.size(), CHUNK);
-        std::memcpy(_send_buffer, _send_cache.data(), size);
+        // Some producer has not yet linked its pending data into the send queue. Try again later.
+        auto self(this->shared_from_this());
+        auto send = [this, self]() { TrySend(); };
+        if (_strand_required)
+            _strand->post(send);
+        else
+            service()->Post(send);
+        return;
     }
 
+    // Gather pending segments from the head of the flush list up to the send size limit
+    SendBuffers buffers = _send_flush.Gather(_server->option_send_size_limit());
+
     _sending = true;
     auto self(this->shared_from_this());
-    asio::async_write(_stream, asio::buffer(_send_buffer, size), [this, self](std::error_code ec, std::size_t size)
+    auto async_send_handler = [this, self](std::error_code ec, std::size_t size)
     {
         _sending = false;
 
@@ -224,27 +526,39 @@ inline void SSLSession<TServer, TSession>::TrySend()
             return;
 
         bool resume = true;
+        AsyncAwaiter* awaiter = nullptr;
 
         // Send some data to the client
         if (size > 0)
         {
             // Update statistic
             _bytes_sent += size;
-            _server->_bytes_sent += size;
+            _server->_statistics.AddSent(size);
 
-            // Call the buffer sent handler
-            onSent(size, _send_cache.size());
+            // Update the idle timeout activity
+            if (_idle_timer != 0)
+                _idle_activity = std::chrono::steady_clock::now();
 
-            {
-                std::lock_guard<std::mutex> locker(_send_lock);
+            // Consume and release completely sent nodes of the flush list
+            _send_flush.Consume(_send_queue, size);
 
-                // Erase the sent buffer
-                _send_cache.erase(_send_cache.begin(), _send_cache.begin() + size);
+            // Update the pending size
+            size_t pending = (_send_pending -= size);
 
-                // Stop sending if the send buffer is empty
-                if (_send_cache.empty())
-                    resume = false;
-            }
+            // Stop sending if the send buffer is empty. Producers dispatch
+            // the send routine again with the next enqueued data.
+            if (pending == 0)
+                resume = false;
+
+            // Call the buffer sent handler
+            onSent(size, pending);
+
+            // Update the send buffer state
+            UpdateSendBuffer(pending);
+
+            // Complete the coroutine awaiting all data sent before its buffer
+            if ((_send_awaiter != nullptr) && (_bytes_sent >= _send_awaiter->target))
+                awaiter = std::exchange(_send_awaiter, nullptr);
         }
 
         // Try to send again if the session is valid
@@ -252,24 +566,239 @@ inline void SSLSession<TServer, TSession>::TrySend()
         {
             if (resume)
                 TrySend();
+            else if (_draining)
+                Disconnect(true);
             else
+            {
+                // Call the empty send buffer handler and stop sending unless it has sent more data
                 onEmpty();
+                TrySend();
+            }
         }
         else
         {
             SendError(ec);
             Disconnect(true);
         }
+
+        // Resume the coroutine awaiting sent data
+        if (awaiter != nullptr)
+            awaiter->Complete(awaiter->size);
+    };
+
+    // Send gathered segments without an intermediate copy
+    // SSL stream handlers of the multi-threaded service are serialized by the session strand
+    // Memory of send operations is recycled by the send handler storage
+    if (_strand_required)
+        asio::async_write(*_stream, buffers, _strand->wrap(make_alloc_handler(_send_storage, async_send_handler)));
+    else
+        asio::async_write(*_stream, buffers, make_alloc_handler(_send_storage, async_send_handler));
+}
+
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::UpdateSendBuffer(size_t pending)
+{
+    // Call the send buffer full handler once the send buffer becomes full
+    if (_send_full && !_send_full_notified)
+    {
+        _send_full_notified = true;
+        onSendBufferFull();
+    }
+
+    // Clear the full flag when the send buffer is drained to the low watermark
+    if (_send_full && (pending <= _server->option_send_buffer_low()))
+    {
+        _send_full = false;
+
+        // Call the send buffer drained handler paired with the notified full send buffer
+        if (_send_full_notified)
+        {
+            _send_full_notified = false;
+            onSendBufferDrained();
+        }
+
+        // Resume receiving paused by the full send buffer
+        TryReceive();
+    }
+}
+
+template <class TServer, class TSession>
+inline bool SSLSession<TServer, TSession>::StartReceiveAsync(AsyncAwaiter& awaiter)
+{
+    assert((!_strand_required || _strand->running_in_this_thread()) && "Session operations should be awaited in the session strand!");
+    assert((_recive_awaiter == nullptr) && "Only one receive operation of the session could be awaited at once!");
+
+    awaiter.result = 0;
+
+    if (!IsHandshaked())
+        return false;
+
+    // Complete at once with unread data of the receive buffer
+    awaiter.result = ReadBuffer(awaiter.buffer, awaiter.size);
+    if (awaiter.result > 0)
+        return false;
+
+    // Register the awaiter and receive the next chunk of data
+    _recive_async = true;
+    _recive_awaiter = &awaiter;
+    TryReceive();
+    return true;
+}
+
+template <class TServer, class TSession>
+inline bool SSLSession<TServer, TSession>::StartSendAsync(AsyncAwaiter& awaiter)
+{
+    assert((!_strand_required || _strand->running_in_this_thread()) && "Session operations should be awaited in the session strand!");
+    assert((_send_awaiter == nullptr) && "Only one send operation of the session could be awaited at once!");
+
+    awaiter.result = 0;
+
+    // Complete at once if the data was not sent
+    size_t pending = Send(awaiter.buffer, awaiter.size);
+    if (pending == 0)
+        return false;
+
+    // Register the awaiter until all pending data is sent
+    awaiter.target = _bytes_sent + pending;
+    _send_awaiter = &awaiter;
+    return true;
+}
+
+template <class TServer, class TSession>
+inline size_t SSLSession<TServer, TSession>::ReadBuffer(void* buffer, size_t size)
+{
+    size_t unread = std::min(size, _recive_buffer_size - _recive_buffer_offset);
+    if (unread == 0)
+        return 0;
+
+    std::memcpy(buffer, _recive_buffer.data() + _recive_buffer_offset, unread);
+
+    // Skip the read data. Reset the receive buffer if all data was read.
+    _recive_buffer_offset += unread;
+    if (_recive_buffer_offset >= _recive_buffer_size)
+    {
+        _recive_buffer_offset = 0;
+        _recive_buffer_size = 0;
+    }
+
+    return unread;
+}
+
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::CompleteAsync()
+{
+    _recive_async = false;
+
+    if (_recive_awaiter != nullptr)
+        std::exchange(_recive_awaiter, nullptr)->Complete(0);
+    if (_send_awaiter != nullptr)
+        std::exchange(_send_awaiter, nullptr)->Complete(0);
+}
+
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::ScheduleIdleTimeout(const std::chrono::steady_clock::duration& delay)
+{
+    auto self(this->shared_from_this());
+    _idle_timer = service()->Schedule(delay, [this, self]()
+    {
+        // Check the idle timeout serialized with other session handlers
+        auto check = [this, self]() { CheckIdleTimeout(); };
+        if (_strand_required)
+            _strand->dispatch(check);
+        else
+            service()->Dispatch(check);
     });
 }
 
 template <class TServer, class TSession>
-inline void SSLSession<TServer, TSession>::ClearBuffers()
+inline void SSLSession<TServer, TSession>::CheckIdleTimeout()
+{
+    if (!IsConnected() || (_idle_timer == 0))
+        return;
+
+    // Schedule the idle timer again for the rest of the idle timeout
+    auto timeout = _server->option_idle_timeout();
+    auto idle = std::chrono::steady_clock::now() - _idle_activity;
+    if (idle < timeout)
+    {
+        ScheduleIdleTimeout(timeout - idle);
+        return;
+    }
+
+    _idle_timer = 0;
+
+    // Call the session idle timeout handler
+    onIdleTimeout();
+
+    // Disconnect the idle session
+    Disconnect(true);
+}
+
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::CancelIdleTimeout()
+{
+    if (_idle_timer == 0)
+        return;
+
+    service()->Cancel(_idle_timer);
+    _idle_timer = 0;
+}
+
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::Reset()
 {
-    std::lock_guard<std::mutex> locker(_send_lock);
+    // Clear the session Id & UUID
+    _id = 0;
+    {
+        std::lock_guard<std::mutex> locker(_uuid_lock);
+        _uuid_generated = false;
+    }
 
-    _recive_cache.clear();
-    _send_cache.clear();
+    // Clear receive/send buffers. The released session is not referred by
+    // any producer, so the pending size is cleared completely.
+    ClearBuffers();
+    _send_pending = 0;
+    _send_scheduled = false;
+
+    // Keep the capacity of receive & send buffers only up to the maximal buffer size
+    size_t buffer_max = _server->option_buffer_max();
+    if (_recive_buffer.size() > buffer_max)
+    {
+        _recive_buffer.resize(buffer_max);
+        _recive_buffer.shrink_to_fit();
+    }
+    _send_flush.Shrink(buffer_max);
+
+    // Reset the session state
+    _strand.reset();
+    _strand_required = false;
+    _reciving = false;
+    _sending = false;
+    _handshaked = false;
+    _bytes_sent = 0;
+    _bytes_received = 0;
+    _idle_timer = 0;
+    _recive_async = false;
+    _recive_awaiter = nullptr;
+    _send_awaiter = nullptr;
+    _draining = false;
+
+    // Call the session reset handler
+    onReset();
+}
+
+template <class TServer, class TSession>
+inline void SSLSession<TServer, TSession>::ClearBuffers()
+{
+    _recive_buffer_offset = 0;
+    _recive_buffer_size = 0;
+
+    // Release all unsent nodes. Only their size is removed from the pending
+    // size, because producers could enqueue new data at the same time.
+    size_t unsent = _send_flush.Clear(_send_queue);
+    _send_pending -= unsent;
+    _send_full = false;
+    _send_full_notified = false;
 }
 
 template <class TServer, class TSession>
@@ -294,8 +823,27 @@ inline void SSLSession<TServer, TSession>::SendError(std::error_code ec)
             return;
     }
 
+    // Update statistic
+    _server->_statistics.AddError();
+
     onError(ec.value(), ec.category().name(), ec.message());
 }
 
+#if defined(CPPSERVER_ASIO_COROUTINES)
+
+template <class TServer, class TSession>
+inline AsyncAwaitable<SSLSession<TServer, TSession>> SSLSession<TServer, TSession>::ReceiveAsync(void* buffer, size_t size)
+{
+    return AsyncAwaitable<SSLSession>(*this, &SSLSession::StartReceiveAsync, buffer, size);
+}
+
+template <class TServer, class TSession>
+inline AsyncAwaitable<SSLSession<TServer, TSession>> SSLSession<TServer, TSession>::SendAsync(const void* buffer, size_t size)
+{
+    return AsyncAwaitable<SSLSession>(*this, &SSLSession::StartSendAsync, const_cast<void*>(buffer), size);
+}
+
+#endif
+
 } // namespace Asio
 } // namespace CppServer
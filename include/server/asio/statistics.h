@@ -0,0 +1,154 @@
+/*!
+    \file statistics.h
+    \brief Server statistics definition
+    \author Ivan Shynkarenka
+    \date 27.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_STATISTICS_H
+#define CPPSERVER_ASIO_STATISTICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace CppServer {
+namespace Asio {
+
+//! Single writer counter
+/*!
+    Single writer counter is updated by one thread at a time (e.g. by the IO
+    thread of the session) with a plain relaxed load and store instead of
+    an atomic read-modify-write operation. Any thread could read it.
+
+    Thread-safe for readers, not thread-safe for writers.
+*/
+class Counter
+{
+public:
+    Counter(uint64_t value = 0) noexcept : _value(value) {}
+    Counter(const Counter&) = delete;
+    Counter(Counter&& counter) noexcept : _value(counter) {}
+    ~Counter() = default;
+
+    Counter& operator=(const Counter&) = delete;
+    Counter& operator=(Counter&& counter) noexcept { return operator=((uint64_t)counter); }
+
+    //! Get the counter value
+    operator uint64_t() const noexcept { return _value.load(std::memory_order_relaxed); }
+
+    //! Set the counter value
+    Counter& operator=(uint64_t value) noexcept { _value.store(value, std::memory_order_relaxed); return *this; }
+    //! Add the given value to the counter
+    Counter& operator+=(uint64_t value) noexcept { _value.store(_value.load(std::memory_order_relaxed) + value, std::memory_order_relaxed); return *this; }
+    //! Increment the counter
+    Counter& operator++() noexcept { return operator+=(1); }
+
+private:
+    std::atomic<uint64_t> _value;
+};
+
+//! Server statistics
+/*!
+    Server statistics counts bytes, messages, connects, disconnects and errors
+    of the server. They are updated at once by sessions running in different
+    threads and by producers sending data from any thread.
+
+    Each thread updates its own cache line sized shard of counters with plain
+    relaxed stores, so updates never contend on the same cache line and do
+    not use atomic read-modify-write operations. Counters are aggregated over
+    all shards on read, so reading is much slower than updating.
+
+    Threads above the shards count share one more shard which is updated with
+    atomic operations.
+
+    Thread-safe.
+*/
+class Statistics
+{
+public:
+    Statistics();
+    Statistics(const Statistics&) = delete;
+    Statistics(Statistics&&) = delete;
+    ~Statistics() = default;
+
+    Statistics& operator=(const Statistics&) = delete;
+    Statistics& operator=(Statistics&&) = delete;
+
+    //! Get the number of bytes sent
+    uint64_t bytes_sent() const noexcept { return Get(BYTES_SENT); }
+    //! Get the number of bytes received
+    uint64_t bytes_received() const noexcept { return Get(BYTES_RECEIVED); }
+    //! Get the number of messages sent
+    uint64_t messages_sent() const noexcept { return Get(MESSAGES_SENT); }
+    //! Get the number of messages received
+    uint64_t messages_received() const noexcept { return Get(MESSAGES_RECEIVED); }
+    //! Get the number of connected sessions
+    uint64_t connects() const noexcept { return Get(CONNECTS); }
+    //! Get the number of disconnected sessions
+    uint64_t disconnects() const noexcept { return Get(DISCONNECTS); }
+    //! Get the number of errors
+    uint64_t errors() const noexcept { return Get(ERRORS); }
+
+    //! Count the sent message of the given size
+    /*!
+        \param size - Message size
+    */
+    void AddSent(size_t size) noexcept { Add(MESSAGES_SENT, 1, BYTES_SENT, size); }
+    //! Count the received message of the given size
+    /*!
+        \param size - Message size
+    */
+    void AddReceived(size_t size) noexcept { Add(MESSAGES_RECEIVED, 1, BYTES_RECEIVED, size); }
+    //! Count the connected session
+    void AddConnect() noexcept { Add(CONNECTS, 1); }
+    //! Count the disconnected session
+    void AddDisconnect() noexcept { Add(DISCONNECTS, 1); }
+    //! Count the error
+    void AddError() noexcept { Add(ERRORS, 1); }
+
+    //! Reset all counters
+    /*!
+        Counters are not cleared, so concurrent updates are never lost. Current
+        values are remembered and subtracted from all following reads.
+    */
+    void Reset() noexcept;
+
+private:
+    enum Type { BYTES_SENT, BYTES_RECEIVED, MESSAGES_SENT, MESSAGES_RECEIVED, CONNECTS, DISCONNECTS, ERRORS, TYPES };
+
+    static const size_t CACHE_LINE = 64;
+    static const size_t SHARDS = 64;
+
+    // Shard of counters which fills the whole cache line
+    struct Shard
+    {
+        std::atomic<uint64_t> counters[CACHE_LINE / sizeof(uint64_t)];
+    };
+    static_assert(TYPES <= (CACHE_LINE / sizeof(uint64_t)), "Statistics counters should fit the cache line!");
+
+    // Cache line aligned shards of threads and the shared shard
+    std::unique_ptr<uint8_t[]> _memory;
+    Shard* _shards;
+    // Counter values at the last reset
+    std::atomic<uint64_t> _base[TYPES];
+
+    //! Get the counter value aggregated over all shards
+    uint64_t Get(Type type) const noexcept;
+    //! Add values to counters of the current thread shard
+    void Add(Type type, uint64_t value) noexcept;
+    void Add(Type type1, uint64_t value1, Type type2, uint64_t value2) noexcept;
+
+    //! Get the shard index of the current thread
+    /*!
+        Index of the shared shard is returned to threads above the shards count.
+    */
+    static size_t ThreadShard() noexcept;
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_STATISTICS_H
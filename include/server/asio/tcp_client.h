@@ -9,6 +9,10 @@
 #ifndef CPPSERVER_ASIO_TCP_CLIENT_H
 #define CPPSERVER_ASIO_TCP_CLIENT_H
 
+#include "coroutine.h"
+#include "memory.h"
+#include "reconnect.h"
+#include "send_queue.h"
 #include "service.h"
 
 #include "system/uuid.h"
@@ -23,7 +27,11 @@ namespace Asio {
 /*!
     TCP client is used to read/write data from/into the connected TCP server.
 
-    Thread-safe.
+    Data to send is enqueued into the lock-free send queue by any thread and
+    sent by the IO thread, so producers never wait for each other.
+
+    Thread-safe. If the Asio service runs several working threads all client
+    handlers are serialized by the client strand.
 */
 class TCPClient : public std::enable_shared_from_this<TCPClient>
 {
@@ -43,13 +51,17 @@ public:
     explicit TCPClient(std::shared_ptr<Service> service, const asio::ip::tcp::endpoint& endpoint);
     TCPClient(const TCPClient&) = delete;
     TCPClient(TCPClient&&) = default;
-    virtual ~TCPClient() = default;
+    virtual ~TCPClient() { ClearBuffers(); }
 
     TCPClient& operator=(const TCPClient&) = delete;
     TCPClient& operator=(TCPClient&&) = default;
 
     //! Get the client Id
-    const CppCommon::UUID& id() const noexcept { return _id; }
+    /*!
+        Client Id is generated on the first call, so clients that never use
+        it do not pay for the UUID generation.
+    */
+    const CppCommon::UUID& id() const;
 
     //! Get the Asio service
     std::shared_ptr<Service>& service() noexcept { return _service; }
@@ -62,23 +74,118 @@ public:
     uint64_t bytes_sent() const noexcept { return _bytes_sent; }
     //! Get the number of bytes received by this client
     uint64_t bytes_received() const noexcept { return _bytes_received; }
+    //! Get the number of bytes pending in the send buffer of this client
+    uint64_t bytes_pending() const noexcept { return _send_pending; }
 
     //! Is the client connected?
     bool IsConnected() const noexcept { return _connected; }
 
+    //! Get the option: send size limit
+    size_t option_send_size_limit() const noexcept { return _send_size_limit; }
+
+    //! Setup option: send size limit
+    /*!
+        All pending data is passed to the socket with a single send operation.
+        This option limits the size of such operation (0 - unlimited).
+
+        \param limit - Send size limit in bytes
+    */
+    void SetupSendSizeLimit(size_t limit) noexcept { _send_size_limit = limit; }
+
+    //! Get the option: minimal buffer size
+    size_t option_buffer_min() const noexcept { return _buffer_min; }
+    //! Get the option: maximal buffer size
+    size_t option_buffer_max() const noexcept { return _buffer_max; }
+
+    //! Setup option: buffer limits
+    /*!
+        The client reads up to the adaptive receive size. It starts from the
+        minimal buffer size, doubles while receive operations fill it up and
+        falls back when they return less than a half of it. The receive buffer
+        above the receive size is released once all received data is handled.
+        Send buffers keep their capacity between sends only up to the maximal
+        buffer size.
+
+        Default limits are 4 KB and 1 MB.
+
+        \param min - Minimal buffer size in bytes
+        \param max - Maximal buffer size in bytes
+    */
+    void SetupBufferLimits(size_t min, size_t max) noexcept { _buffer_min = min; _buffer_max = std::max(min, max); }
+
+    //! Get the option: send buffer high watermark
+    size_t option_send_buffer_high() const noexcept { return _send_buffer_high; }
+    //! Get the option: send buffer low watermark
+    size_t option_send_buffer_low() const noexcept { return _send_buffer_low; }
+    //! Get the option: pause receiving while the send buffer is full
+    bool option_receive_pause() const noexcept { return _receive_pause; }
+
+    //! Setup option: send buffer watermarks
+    /*!
+        When pending data of the client send buffer reaches the high watermark
+        the client calls onSendBufferFull() and rejects new data to send until
+        the send buffer is drained down to the low watermark. Then it calls
+        onSendBufferDrained().
+
+        \param high - High watermark in bytes (0 - unlimited)
+        \param low - Low watermark in bytes
+    */
+    void SetupSendBufferWatermarks(size_t high, size_t low) noexcept { _send_buffer_high = high; _send_buffer_low = std::min(low, high); }
+
+    //! Setup option: pause receiving while the send buffer is full
+    /*!
+        This option stops reading from the client socket while its send buffer
+        is full, so the peer that does not drain sent data could not make the
+        client produce more of it. Receiving is resumed when the send buffer is
+        drained.
+
+        \param enable - Enable/disable option
+    */
+    void SetupReceivePause(bool enable) noexcept { _receive_pause = enable; }
+
+    //! Get the option: minimal reconnect delay
+    std::chrono::steady_clock::duration option_reconnect_delay_min() const noexcept { return _reconnect_policy.delay_min(); }
+    //! Get the option: maximal reconnect delay
+    std::chrono::steady_clock::duration option_reconnect_delay_max() const noexcept { return _reconnect_policy.delay_max(); }
+    //! Get the option: limit of reconnect attempts
+    size_t option_reconnect_attempts() const noexcept { return _reconnect_policy.attempts(); }
+
+    //! Setup option: automatic reconnect
+    /*!
+        The client which failed to connect or lost its connection is connected
+        again after the reconnect delay scheduled in the timer wheel of the
+        client Asio service, so no thread waits for the reconnect. The delay
+        grows exponentially from the minimal to the maximal delay with each
+        attempt in a row and is randomized by the jitter (see ReconnectPolicy).
+        Reconnect attempts are reset when the client is connected and stopped
+        by Disconnect().
+
+        Default minimal delay is 0 (automatic reconnect is disabled).
+
+        \param min - Minimal reconnect delay
+        \param max - Maximal reconnect delay
+        \param attempts - Limit of reconnect attempts in a row (0 - unlimited, default is 0)
+    */
+    void SetupReconnect(const std::chrono::steady_clock::duration& min, const std::chrono::steady_clock::duration& max, size_t attempts = 0) noexcept { _reconnect_policy.Setup(min, max, attempts); }
+
     //! Connect the client
     /*!
         \return 'true' if the client was successfully connected, 'false' if the client failed to connect
     */
-    bool Connect();
+    bool Connect() { _reconnect = true; return Connect(nullptr); }
     //! Disconnect the client
     /*!
+        Disconnects the client and stops its automatic reconnect.
+
         \return 'true' if the client was successfully disconnected, 'false' if the client is already disconnected
     */
-    bool Disconnect() { return Disconnect(false); }
+    bool Disconnect();
     //! Reconnect the client
     /*!
-        \return 'true' if the client was successfully reconnected, 'false' if the client is already reconnected
+        Disconnects and connects the client again in its IO thread, so the
+        calling thread does not wait for the disconnect.
+
+        \return 'true' if the client was successfully reconnected, 'false' if the client is not connected
     */
     bool Reconnect();
 
@@ -86,21 +193,80 @@ public:
     /*!
         \param buffer - Buffer to send
         \param size - Buffer size
-        \return Count of pending bytes in the send buffer
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
     */
     size_t Send(const void* buffer, size_t size);
     //! Send a text string to the server
     /*!
         \param text - Text string to send
-        \return Count of pending bytes in the send buffer
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
     */
     size_t Send(const std::string& text) { return Send(text.data(), text.size()); }
+    //! Send the shared buffer to the server
+    /*!
+        The shared buffer is queued by reference without copying its content,
+        so the same buffer could be sent by many sessions or clients at once.
+        The buffer content must not be changed until it is sent.
+
+        \param buffer - Shared buffer to send
+        \return Count of pending bytes in the send buffer or 0 if the data was not sent
+    */
+    size_t Send(std::shared_ptr<const Buffer> buffer);
+
+    //! Connect the client asynchronously (C++20 coroutines)
+    /*!
+        Connects the client as Connect() does and awaits until the client is
+        connected or failed to connect. The client should not be already
+        connecting. The coroutine is resumed in the IO
+        thread of the client right after onConnected() handler, so all next
+        operations of the client could be awaited there.
+
+        \return Awaitable 'true' if the client was successfully connected, 'false' if the client failed to connect
+    */
+    AsyncAwaitable<TCPClient, bool> ConnectAsync();
+    //! Receive data from the server asynchronously (C++20 coroutines)
+    /*!
+        Awaits the next chunk of data received from the server and copies it
+        into the given buffer. Unread data of the receive buffer is returned
+        at once. Once the data is awaited the client stops calling onReceived()
+        handler and receives only when the next chunk is awaited, so a slow
+        coroutine applies backpressure to the server.
+
+        Should be awaited in the IO thread of the client.
+
+        \param buffer - Buffer to receive
+        \param size - Buffer size
+        \return Awaitable count of received bytes or 0 if the client was disconnected
+    */
+    AsyncAwaitable<TCPClient> ReceiveAsync(void* buffer, size_t size);
+    //! Send data to the server asynchronously (C++20 coroutines)
+    /*!
+        Enqueues the data as Send() does and awaits until all pending data
+        including the given buffer is sent to the server.
+
+        Should be awaited in the IO thread of the client.
+
+        \param buffer - Buffer to send
+        \param size - Buffer size
+        \return Awaitable count of sent bytes or 0 if the data was not sent
+    */
+    AsyncAwaitable<TCPClient> SendAsync(const void* buffer, size_t size);
 
 protected:
     //! Handle client connected notification
     virtual void onConnected() {}
     //! Handle client disconnected notification
     virtual void onDisconnected() {}
+    //! Handle client reconnecting notification
+    /*!
+        Notification is called right after onDisconnected() handler when the
+        next automatic reconnect attempt is scheduled. Disconnect() called
+        from this handler stops reconnecting.
+
+        \param attempt - Reconnect attempt in a row (starting from 1)
+        \param delay - Delay of the reconnect attempt
+    */
+    virtual void onReconnecting(size_t attempt, const std::chrono::steady_clock::duration& delay) {}
 
     //! Handle buffer received notification
     /*!
@@ -111,6 +277,9 @@ protected:
         If you want to wait for some more bytes from the server return the
         size of the buffer you want to keep until another chunk is received.
 
+        The given buffer is a view of all unread data in the receive buffer.
+        It is valid only until the handler returns.
+
         \param buffer - Received buffer
         \param size - Received buffer size
         \return Count of handled bytes
@@ -138,6 +307,20 @@ protected:
     */
     virtual void onEmpty() {}
 
+    //! Handle send buffer full notification
+    /*!
+        Notification is called when pending data of the send buffer reaches
+        the high watermark. New data to send is rejected until the send buffer
+        is drained down to the low watermark.
+    */
+    virtual void onSendBufferFull() {}
+    //! Handle send buffer drained notification
+    /*!
+        Notification is called when the full send buffer was drained down to
+        the low watermark and is ready for a new data to send.
+    */
+    virtual void onSendBufferDrained() {}
+
     //! Handle error notification
     /*!
         \param error - Error code
@@ -147,30 +330,60 @@ protected:
     virtual void onError(int error, const std::string& category, const std::string& message) {}
 
 private:
-    static const size_t CHUNK = 8192;
-
-    // Client Id
-    CppCommon::UUID _id;
+    // Client Id (lazily generated)
+    mutable std::once_flag _id_flag;
+    mutable CppCommon::UUID _id;
     // Asio service
     std::shared_ptr<Service> _service;
     // Server endpoint & client socket
     asio::ip::tcp::endpoint _endpoint;
     asio::ip::tcp::socket _socket;
+    asio::io_service::strand _strand;
+    bool _strand_required;
     std::atomic<bool> _connecting;
     std::atomic<bool> _connected;
-    // Client statistic
-    uint64_t _bytes_sent;
-    uint64_t _bytes_received;
-    // Receive buffer & cache
+    // Client options
+    size_t _send_size_limit;
+    size_t _buffer_min;
+    size_t _buffer_max;
+    size_t _send_buffer_high;
+    size_t _send_buffer_low;
+    bool _receive_pause;
+    // Client statistic (read from other threads)
+    std::atomic<uint64_t> _bytes_sent;
+    std::atomic<uint64_t> _bytes_received;
+    // Receive buffer
     bool _reciving;
-    uint8_t _recive_buffer[CHUNK];
-    std::vector<uint8_t> _recive_cache;
-    // Send buffer & cache
+    std::vector<uint8_t> _recive_buffer;
+    size_t _recive_buffer_offset;
+    size_t _recive_buffer_size;
+    size_t _recive_size;
+    HandlerStorage _recive_storage;
+    // Send queue
     bool _sending;
-    std::mutex _send_lock;
-    uint8_t _send_buffer[CHUNK];
-    std::vector<uint8_t> _send_cache;
+    SendQueue _send_queue;
+    SendFlush _send_flush;
+    std::atomic<size_t> _send_pending;
+    std::atomic<bool> _send_scheduled;
+    std::atomic<bool> _send_full;
+    bool _send_full_notified;
+    HandlerStorage _send_storage;
+    // Coroutine awaiters
+    bool _recive_async;
+    AsyncAwaiter* _connect_awaiter;
+    AsyncAwaiter* _recive_awaiter;
+    AsyncAwaiter* _send_awaiter;
+    // Automatic reconnect
+    std::atomic<bool> _reconnect;
+    std::atomic<TimerId> _reconnect_timer;
+    ReconnectPolicy _reconnect_policy;
 
+    //! Connect the client
+    /*!
+        \param awaiter - Connect awaiter registered by the connect routine (nullptr - no awaiter)
+        \return 'true' if the client was successfully connected, 'false' if the client failed to connect
+    */
+    bool Connect(AsyncAwaiter* awaiter);
     //! Disconnect the client
     /*!
         \param dispatch - Dispatch flag
@@ -178,10 +391,56 @@ private:
     */
     bool Disconnect(bool dispatch);
 
+    //! Schedule the next automatic reconnect attempt of the disconnected client
+    void ScheduleReconnect();
+    //! Cancel the scheduled reconnect attempt
+    void CancelReconnect();
+
     //! Try to receive new data
     void TryReceive();
     //! Try to send pending data
     void TrySend();
+    //! Update the send buffer state with the given pending size
+    /*!
+        Calls send buffer full/drained handlers and resumes receiving paused
+        by the full send buffer.
+
+        \param pending - Size of pending buffer
+    */
+    void UpdateSendBuffer(size_t pending);
+
+    //! Start to await the client connection
+    /*!
+        \param awaiter - Connect awaiter
+        \return 'true' if the awaiter is registered, 'false' if the client is already connected
+    */
+    bool StartConnectAsync(AsyncAwaiter& awaiter);
+    //! Start to await received data
+    /*!
+        \param awaiter - Receive awaiter
+        \return 'true' if the awaiter is registered, 'false' if the receive is already completed
+    */
+    bool StartReceiveAsync(AsyncAwaiter& awaiter);
+    //! Start to await sent data
+    /*!
+        \param awaiter - Send awaiter
+        \return 'true' if the awaiter is registered, 'false' if the send is already completed
+    */
+    bool StartSendAsync(AsyncAwaiter& awaiter);
+    //! Read unread data of the receive buffer into the given buffer
+    /*!
+        \param buffer - Buffer to read
+        \param size - Buffer size
+        \return Count of read bytes
+    */
+    size_t ReadBuffer(void* buffer, size_t size);
+    //! Complete the registered connect awaiter
+    /*!
+        \param connected - Connected flag
+    */
+    void CompleteConnectAsync(bool connected);
+    //! Complete all registered awaiters of the disconnected client
+    void CompleteAsync();
 
     //! Clear receive & send buffers
     void ClearBuffers();
@@ -192,6 +451,25 @@ private:
 
 /*! \example tcp_chat_client.cpp TCP chat client example */
 
+#if defined(CPPSERVER_ASIO_COROUTINES)
+
+inline AsyncAwaitable<TCPClient, bool> TCPClient::ConnectAsync()
+{
+    return AsyncAwaitable<TCPClient, bool>(*this, &TCPClient::StartConnectAsync);
+}
+
+inline AsyncAwaitable<TCPClient> TCPClient::ReceiveAsync(void* buffer, size_t size)
+{
+    return AsyncAwaitable<TCPClient>(*this, &TCPClient::StartReceiveAsync, buffer, size);
+}
+
+inline AsyncAwaitable<TCPClient> TCPClient::SendAsync(const void* buffer, size_t size)
+{
+    return AsyncAwaitable<TCPClient>(*this, &TCPClient::StartSendAsync, const_cast<void*>(buffer), size);
+}
+
+#endif
+
 } // namespace Asio
 } // namespace CppServer
 
@@ -0,0 +1,52 @@
+/*!
+    \file tcp_client_pool.h
+    \brief TCP client pool definition
+    \author Ivan Shynkarenka
+    \date 05.04.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_TCP_CLIENT_POOL_H
+#define CPPSERVER_ASIO_TCP_CLIENT_POOL_H
+
+#include "client_pool.h"
+#include "tcp_client.h"
+
+namespace CppServer {
+namespace Asio {
+
+//! TCP client pool
+/*!
+    TCP client pool keeps connected TCP clients of several servers and
+    balances sent data between them (see ClientPool).
+
+    Thread-safe.
+*/
+template <class TClient = TCPClient>
+class TCPClientPool : public ClientPool<TClient>
+{
+public:
+    //! Initialize TCP client pool with a given Asio service and count of connections per endpoint
+    /*!
+        \param service - Asio service
+        \param connections - Count of connections per endpoint (default is 1)
+    */
+    explicit TCPClientPool(std::shared_ptr<Service> service, size_t connections = 1) : ClientPool<TClient>(service, connections) {}
+    TCPClientPool(const TCPClientPool&) = delete;
+    TCPClientPool(TCPClientPool&&) = delete;
+    virtual ~TCPClientPool() = default;
+
+    TCPClientPool& operator=(const TCPClientPool&) = delete;
+    TCPClientPool& operator=(TCPClientPool&&) = delete;
+
+protected:
+    //! Create a new TCP client of the given server endpoint
+    std::shared_ptr<TClient> CreateClient(std::shared_ptr<Service>& service, const asio::ip::tcp::endpoint& endpoint) override { return std::make_shared<TClient>(service, endpoint); }
+    //! Is the given TCP client connected?
+    bool IsReady(const TClient& client) const noexcept override { return client.IsConnected(); }
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_TCP_CLIENT_POOL_H
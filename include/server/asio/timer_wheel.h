@@ -0,0 +1,139 @@
+/*!
+    \file timer_wheel.h
+    \brief Hierarchical timer wheel definition
+    \author Ivan Shynkarenka
+    \date 29.03.2017
+    \copyright MIT License
+*/
+
+#ifndef CPPSERVER_ASIO_TIMER_WHEEL_H
+#define CPPSERVER_ASIO_TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace CppServer {
+namespace Asio {
+
+//! Timer Id
+/*!
+    Timer Id combines the timer slot index (low 32 bits) with the generation of
+    the slot (high 32 bits), so the Id of the expired or cancelled timer never
+    refers to another timer reusing the same slot. Zero Id is never assigned.
+*/
+typedef uint64_t TimerId;
+
+//! Hierarchical timer wheel
+/*!
+    Hierarchical timer wheel keeps timers in five levels of slots measured in
+    ticks. The first level has 256 slots of one tick, each next level has 64
+    slots covering the whole previous level. Timer is linked into the slot of
+    its expiration tick, so scheduling and cancelling are O(1) operations.
+    Timers of upper levels are cascaded into lower levels when the wheel turns.
+
+    Timers are stored in the slab of nodes linked by indexes, so armed timers
+    do not allocate heap nodes of their own and freed nodes are reused.
+
+    Timer wheel covers 2^32 ticks. Timers with longer delays are kept in the
+    last level and cascaded again until they expire.
+
+    Not thread-safe.
+*/
+class TimerWheel
+{
+public:
+    //! Timer handler
+    typedef std::function<void()> Handler;
+
+    TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&) = default;
+    ~TimerWheel() = default;
+
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = default;
+
+    //! Get the current tick of the wheel
+    uint64_t now() const noexcept { return _now; }
+    //! Get the count of armed timers
+    size_t size() const noexcept { return _size; }
+    //! Is the wheel empty?
+    bool empty() const noexcept { return _size == 0; }
+
+    //! Schedule a new timer
+    /*!
+        \param ticks - Count of ticks from the current tick to expire the timer
+        \param handler - Timer handler
+        \return Timer Id
+    */
+    TimerId Schedule(uint64_t ticks, Handler&& handler);
+    //! Cancel the timer with a given Id
+    /*!
+        \param id - Timer Id
+        \return 'true' if the timer was successfully cancelled, 'false' if the timer has already expired or cancelled
+    */
+    bool Cancel(TimerId id);
+
+    //! Advance the wheel by a given count of ticks
+    /*!
+        Handlers of expired timers are moved into the given vector in order of
+        their expiration, so they could be called without holding any lock
+        protecting the wheel.
+
+        \param ticks - Count of ticks to advance
+        \param expired - Vector of expired timer handlers
+    */
+    void Advance(uint64_t ticks, std::vector<Handler>& expired);
+
+    //! Clear all timers
+    /*!
+        Handlers of cleared timers are moved into the given vector, so they
+        could be destroyed without holding any lock protecting the wheel.
+
+        \param cleared - Vector of cleared timer handlers
+    */
+    void Clear(std::vector<Handler>& cleared);
+
+private:
+    static const uint32_t NIL = 0xFFFFFFFF;
+    static const uint32_t LEVELS = 5;
+    static const uint32_t ROOT_BITS = 8;
+    static const uint32_t ROOT_SLOTS = 1 << ROOT_BITS;
+    static const uint32_t LEVEL_BITS = 6;
+    static const uint32_t LEVEL_SLOTS = 1 << LEVEL_BITS;
+    static const uint32_t SLOTS = ROOT_SLOTS + (LEVELS - 1) * LEVEL_SLOTS;
+    static const uint64_t MAX_TICKS = 0xFFFFFFFF;
+
+    // Timer node linked into the wheel slot or into the free list
+    struct Node
+    {
+        uint64_t expires;
+        uint32_t generation;
+        uint32_t slot;
+        uint32_t prev;
+        uint32_t next;
+        Handler handler;
+    };
+
+    uint64_t _now;
+    size_t _size;
+    std::vector<Node> _nodes;
+    uint32_t _free;
+    uint32_t _slots[SLOTS];
+
+    //! Link the node into the slot of its expiration tick
+    void Link(uint32_t index);
+    //! Unlink the node from its slot
+    void Unlink(uint32_t index);
+    //! Release the node into the free list
+    void Release(uint32_t index);
+    //! Cascade timers of the given upper level slot into lower levels
+    void Cascade(uint32_t slot);
+};
+
+} // namespace Asio
+} // namespace CppServer
+
+#endif // CPPSERVER_ASIO_TIMER_WHEEL_H
@@ -9,6 +9,7 @@
 #ifndef CPPSERVER_ASIO_UDP_CLIENT_H
 #define CPPSERVER_ASIO_UDP_CLIENT_H
 
+#include "memory.h"
 #include "service.h"
 
 #include "system/uuid.h"
@@ -85,6 +86,18 @@ public:
     //! Is the client connected?
     bool IsConnected() const noexcept { return _connected; }
 
+    //! Get the option: receive buffer size
+    size_t option_receive_buffer_size() const noexcept { return _recive_buffer_limit; }
+
+    //! Setup option: receive buffer size
+    /*!
+        Datagrams larger than the receive buffer are truncated.
+        Default receive buffer size is 8 KB.
+
+        \param size - Receive buffer size in bytes
+    */
+    void SetupReceiveBufferSize(size_t size) noexcept { _recive_buffer_limit = size; }
+
     //! Connect the client
     /*!
         \return 'true' if the client was successfully connected, 'false' if the client failed to connect
@@ -179,8 +192,6 @@ protected:
     virtual void onError(int error, const std::string& category, const std::string& message) {}
 
 private:
-    static const size_t CHUNK = 8192;
-
     // Client Id
     CppCommon::UUID _id;
     // Asio service
@@ -198,7 +209,9 @@ private:
     asio::ip::udp::endpoint _recive_endpoint;
     // Receive buffer
     bool _reciving;
-    uint8_t _recive_buffer[CHUNK];
+    size_t _recive_buffer_limit;
+    std::vector<uint8_t> _recive_buffer;
+    HandlerStorage _recive_storage;
     // Additional options
     bool _multicast;
     bool _reuse_address;
@@ -9,7 +9,10 @@
 #ifndef CPPSERVER_ASIO_UDP_SERVER_H
 #define CPPSERVER_ASIO_UDP_SERVER_H
 
+#include "coroutine.h"
+#include "memory.h"
 #include "service.h"
+#include "statistics.h"
 
 namespace CppServer {
 namespace Asio {
@@ -58,17 +61,35 @@ public:
     asio::ip::udp::endpoint& multicast_endpoint() noexcept { return _multicast_endpoint; }
 
     //! Get the number datagrams sent by this server
-    uint64_t datagrams_sent() const noexcept { return _datagrams_sent; }
+    uint64_t datagrams_sent() const noexcept { return _statistics.messages_sent(); }
     //! Get the number datagrams received by this server
-    uint64_t datagrams_received() const noexcept { return _datagrams_received; }
+    uint64_t datagrams_received() const noexcept { return _statistics.messages_received(); }
     //! Get the number of bytes sent by this server
-    uint64_t bytes_sent() const noexcept { return _bytes_sent; }
+    uint64_t bytes_sent() const noexcept { return _statistics.bytes_sent(); }
     //! Get the number of bytes received by this server
-    uint64_t bytes_received() const noexcept { return _bytes_received; }
+    uint64_t bytes_received() const noexcept { return _statistics.bytes_received(); }
+    //! Get the server statistics
+    /*!
+        Messages of the server statistics are datagrams. UDP server does not
+        count connects and disconnects.
+    */
+    const Statistics& statistics() const noexcept { return _statistics; }
 
     //! Is the server started?
     bool IsStarted() const noexcept { return _started; }
 
+    //! Get the option: receive buffer size
+    size_t option_receive_buffer_size() const noexcept { return _recive_buffer_limit; }
+
+    //! Setup option: receive buffer size
+    /*!
+        Datagrams larger than the receive buffer are truncated.
+        Default receive buffer size is 8 KB.
+
+        \param size - Receive buffer size in bytes
+    */
+    void SetupReceiveBufferSize(size_t size) noexcept { _recive_buffer_limit = size; }
+
     //! Start the server
     /*!
         \return 'true' if the server was successfully started, 'false' if the server failed to start
@@ -130,6 +151,32 @@ public:
     */
     bool Send(const asio::ip::udp::endpoint& endpoint, const std::string& text) { return Send(endpoint, text.data(), text.size()); }
 
+    //! Receive a datagram asynchronously (C++20 coroutines)
+    /*!
+        Awaits the next datagram and copies it into the given buffer. The rest
+        of the datagram which does not fit into the buffer is discarded. Once
+        the datagram is awaited the server stops calling onReceived() handler
+        and receives only when the next datagram is awaited.
+
+        Should be awaited in the IO thread of the server.
+
+        \param endpoint - Endpoint of the received datagram
+        \param buffer - Datagram buffer to receive
+        \param size - Datagram buffer size
+        \return Awaitable size of received datagram or 0 if the server was stopped
+    */
+    AsyncAwaitable<UDPServer> ReceiveAsync(asio::ip::udp::endpoint& endpoint, void* buffer, size_t size);
+    //! Send a datagram into the given endpoint asynchronously (C++20 coroutines)
+    /*!
+        Datagrams are sent at once, so the coroutine is never suspended.
+
+        \param endpoint - Endpoint to send
+        \param buffer - Datagram buffer to send
+        \param size - Datagram buffer size
+        \return Awaitable size of sent datagram or 0 if the datagram was not sent
+    */
+    AsyncAwaitable<UDPServer> SendAsync(const asio::ip::udp::endpoint& endpoint, const void* buffer, size_t size);
+
 protected:
     //! Handle server started notification
     virtual void onStarted() {}
@@ -167,29 +214,42 @@ protected:
     virtual void onError(int error, const std::string& category, const std::string& message) {}
 
 private:
-    static const size_t CHUNK = 8192;
-
     // Asio service
     std::shared_ptr<Service> _service;
     // Server endpoint & socket
     asio::ip::udp::endpoint _endpoint;
     asio::ip::udp::socket _socket;
     std::atomic<bool> _started;
-    // Server statistic
-    uint64_t _datagrams_sent;
-    uint64_t _datagrams_received;
-    uint64_t _bytes_sent;
-    uint64_t _bytes_received;
+    // Server statistic (datagrams are sent from any thread)
+    Statistics _statistics;
     // Multicast & receive endpoint
     asio::ip::udp::endpoint _multicast_endpoint;
     asio::ip::udp::endpoint _recive_endpoint;
     // Receive buffer
     bool _reciving;
-    uint8_t _recive_buffer[CHUNK];
+    size_t _recive_buffer_limit;
+    std::vector<uint8_t> _recive_buffer;
+    HandlerStorage _recive_storage;
+    // Coroutine awaiters
+    bool _recive_async;
+    AsyncAwaiter* _recive_awaiter;
 
     //! Try to receive new datagram
     void TryReceive();
 
+    //! Start to await the received datagram
+    /*!
+        \param awaiter - Receive awaiter
+        \return 'true' if the awaiter is registered, 'false' if the server is not started
+    */
+    bool StartReceiveAsync(AsyncAwaiter& awaiter);
+    //! Send the datagram of the awaiter
+    /*!
+        \param awaiter - Send awaiter
+        \return Always 'false' as the datagram is sent at once
+    */
+    bool StartSendAsync(AsyncAwaiter& awaiter);
+
     //! Send error notification
     void SendError(std::error_code ec);
 };
@@ -197,6 +257,20 @@ private:
 /*! \example udp_echo_server.cpp UDP echo server example */
 /*! \example udp_multicast_server.cpp UDP multicast server example */
 
+#if defined(CPPSERVER_ASIO_COROUTINES)
+
+inline AsyncAwaitable<UDPServer> UDPServer::ReceiveAsync(asio::ip::udp::endpoint& endpoint, void* buffer, size_t size)
+{
+    return AsyncAwaitable<UDPServer>(*this, &UDPServer::StartReceiveAsync, buffer, size, &endpoint);
+}
+
+inline AsyncAwaitable<UDPServer> UDPServer::SendAsync(const asio::ip::udp::endpoint& endpoint, const void* buffer, size_t size)
+{
+    return AsyncAwaitable<UDPServer>(*this, &UDPServer::StartSendAsync, const_cast<void*>(buffer), size, const_cast<asio::ip::udp::endpoint*>(&endpoint));
+}
+
+#endif
+
 } // namespace Asio
 } // namespace CppServer
 
@@ -9,6 +9,7 @@
 #ifndef CPPSERVER_ASIO_WEBSOCKET_CLIENT_H
 #define CPPSERVER_ASIO_WEBSOCKET_CLIENT_H
 
+#include "reconnect.h"
 #include "service.h"
 #include "websocket.h"
 
@@ -61,6 +62,31 @@ public:
     //! Is the client connected?
     bool IsConnected() const noexcept { return _connected; }
 
+    //! Get the option: minimal reconnect delay
+    std::chrono::steady_clock::duration option_reconnect_delay_min() const noexcept { return _reconnect_policy.delay_min(); }
+    //! Get the option: maximal reconnect delay
+    std::chrono::steady_clock::duration option_reconnect_delay_max() const noexcept { return _reconnect_policy.delay_max(); }
+    //! Get the option: limit of reconnect attempts
+    size_t option_reconnect_attempts() const noexcept { return _reconnect_policy.attempts(); }
+
+    //! Setup option: automatic reconnect
+    /*!
+        The client which failed to connect or lost its connection is connected
+        again after the reconnect delay scheduled in the timer wheel of the
+        client Asio service, so no thread waits for the reconnect. The delay
+        grows exponentially from the minimal to the maximal delay with each
+        attempt in a row and is randomized by the jitter (see ReconnectPolicy).
+        Reconnect attempts are reset when the client is connected and stopped
+        by Disconnect().
+
+        Default minimal delay is 0 (automatic reconnect is disabled).
+
+        \param min - Minimal reconnect delay
+        \param max - Maximal reconnect delay
+        \param attempts - Limit of reconnect attempts in a row (0 - unlimited, default is 0)
+    */
+    void SetupReconnect(const std::chrono::steady_clock::duration& min, const std::chrono::steady_clock::duration& max, size_t attempts = 0) noexcept { _reconnect_policy.Setup(min, max, attempts); }
+
     //! Connect the client
     /*!
         \return 'true' if the client was successfully connected, 'false' if the client failed to connect
@@ -68,14 +94,20 @@ public:
     bool Connect();
     //! Disconnect the client
     /*!
+        Disconnects the client and stops its automatic reconnect.
+
         \param code - Close code to send (default is normal)
         \param reason - Close reason to send (default is "")
         \return 'true' if the client was successfully disconnected, 'false' if the client is already disconnected
     */
-    bool Disconnect(websocketpp::close::status::value code = websocketpp::close::status::normal, const std::string& reason = "") { return Disconnect(false, code, reason); }
+    bool Disconnect(websocketpp::close::status::value code = websocketpp::close::status::normal, const std::string& reason = "");
     //! Reconnect the client
     /*!
-        \return 'true' if the client was successfully reconnected, 'false' if the client is already reconnected
+        Closes the client connection and connects the client again as soon as
+        the connection is closed, so the calling thread does not wait for the
+        close handshake.
+
+        \return 'true' if the client was successfully reconnected, 'false' if the client is not connected
     */
     bool Reconnect();
 
@@ -106,6 +138,16 @@ protected:
     virtual void onConnected() {}
     //! Handle client disconnected notification
     virtual void onDisconnected() {}
+    //! Handle client reconnecting notification
+    /*!
+        Notification is called right after onDisconnected() handler when the
+        next automatic reconnect attempt is scheduled. Disconnect() called
+        from this handler stops reconnecting.
+
+        \param attempt - Reconnect attempt in a row (starting from 1)
+        \param delay - Delay of the reconnect attempt
+    */
+    virtual void onReconnecting(size_t attempt, const std::chrono::steady_clock::duration& delay) {}
 
     //! Handle message received notification
     /*!
@@ -137,6 +179,11 @@ private:
     uint64_t _messages_received;
     uint64_t _bytes_sent;
     uint64_t _bytes_received;
+    // Automatic reconnect
+    std::atomic<bool> _reconnect;
+    std::atomic<bool> _reconnecting;
+    std::atomic<TimerId> _reconnect_timer;
+    ReconnectPolicy _reconnect_policy;
 
     //! Initialize Asio
     void InitAsio();
@@ -155,6 +202,11 @@ private:
     //! Disconnected session handler
     void Disconnected(websocketpp::connection_hdl connection);
 
+    //! Schedule the next automatic reconnect attempt of the disconnected client
+    void ScheduleReconnect();
+    //! Cancel the scheduled reconnect attempt
+    void CancelReconnect();
+
     //! Send error notification
     void SendError(std::error_code ec);
 };
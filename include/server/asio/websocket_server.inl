@@ -14,10 +14,9 @@ inline WebSocketServer<TServer, TSession>::WebSocketServer(std::shared_ptr<Servi
     : _service(service),
       _initialized(false),
       _started(false),
-      _messages_sent(0),
-      _messages_received(0),
-      _bytes_sent(0),
-      _bytes_received(0)
+      _draining(false),
+      _drain_timer(0),
+      _idle_timeout(std::chrono::steady_clock::duration::zero())
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -41,10 +40,9 @@ inline WebSocketServer<TServer, TSession>::WebSocketServer(std::shared_ptr<Servi
     : _service(service),
       _initialized(false),
       _started(false),
-      _messages_sent(0),
-      _messages_received(0),
-      _bytes_sent(0),
-      _bytes_received(0)
+      _draining(false),
+      _drain_timer(0),
+      _idle_timeout(std::chrono::steady_clock::duration::zero())
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -61,10 +59,9 @@ inline WebSocketServer<TServer, TSession>::WebSocketServer(std::shared_ptr<Servi
       _endpoint(endpoint),
       _initialized(false),
       _started(false),
-      _messages_sent(0),
-      _messages_received(0),
-      _bytes_sent(0),
-      _bytes_received(0)
+      _draining(false),
+      _drain_timer(0),
+      _idle_timeout(std::chrono::steady_clock::duration::zero())
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -127,10 +124,7 @@ inline bool WebSocketServer<TServer, TSession>::Start()
         }
 
         // Reset statistic
-        _messages_sent = 0;
-        _messages_received = 0;
-        _bytes_sent = 0;
-        _bytes_received = 0;
+        _statistics.Reset();
 
         // Update the started flag
         _started = true;
@@ -152,7 +146,7 @@ inline bool WebSocketServer<TServer, TSession>::Start()
 }
 
 template <class TServer, class TSession>
-inline bool WebSocketServer<TServer, TSession>::Stop()
+inline bool WebSocketServer<TServer, TSession>::Stop(const std::chrono::steady_clock::duration& timeout)
 {
     assert(IsStarted() && "WebSocket server is not started!");
     if (!IsStarted())
@@ -160,8 +154,11 @@ inline bool WebSocketServer<TServer, TSession>::Stop()
 
     // Post the stopped routine
     auto self(this->shared_from_this());
-    _service->service()->post([this, self]()
+    _service->service()->post([this, self, timeout]()
     {
+        if (!IsStarted() || IsDraining())
+            return;
+
         // Stop WebSocket server
         websocketpp::lib::error_code ec;
         _core.stop_listening(ec);
@@ -171,14 +168,40 @@ inline bool WebSocketServer<TServer, TSession>::Stop()
         // Clear multicast buffer
         ClearBuffers();
 
+        // Close all sessions until the drain timeout
+        if (timeout.count() > 0)
+        {
+            _draining = true;
+
+            // Terminate sessions which are not closed until the drain timeout
+            _drain_timer = _service->Schedule(timeout, [this, self]()
+            {
+                if (!IsDraining())
+                    return;
+
+                for (auto& session : _sessions)
+                    session->Abort();
+
+                // Otherwise the last unregistered session completes the drain
+                if (_sessions.size() == 0)
+                    CompleteDrain();
+            });
+
+            // Close all sessions with the close handshake bounded by the drain timeout
+            for (auto& session : _sessions)
+                session->Drain(timeout);
+
+            // Stop the server without sessions at once
+            if (_sessions.size() == 0)
+                CompleteDrain();
+            return;
+        }
+
         // Disconnect all sessions
         DisconnectAll();
 
-        // Update the started flag
-        _started = false;
-
-        // Call the server stopped handler
-        onStopped();
+        // Stop the server
+        Stopped();
     });
 
     return true;
@@ -190,12 +213,47 @@ inline bool WebSocketServer<TServer, TSession>::Restart()
     if (!Stop())
         return false;
 
-    while (IsStarted())
-        CppCommon::Thread::Yield();
+    WaitStopped();
 
     return Start();
 }
 
+template <class TServer, class TSession>
+inline void WebSocketServer<TServer, TSession>::WaitStopped()
+{
+    std::unique_lock<std::mutex> locker(_stopped_lock);
+    _stopped_event.wait(locker, [this]() { return !IsStarted(); });
+}
+
+template <class TServer, class TSession>
+inline void WebSocketServer<TServer, TSession>::CompleteDrain()
+{
+    // Complete the drain only once
+    if (!_draining.exchange(false))
+        return;
+
+    // Cancel the drain timeout
+    _service->Cancel(_drain_timer);
+    _drain_timer = 0;
+
+    // Stop the server
+    Stopped();
+}
+
+template <class TServer, class TSession>
+inline void WebSocketServer<TServer, TSession>::Stopped()
+{
+    // Update the started flag
+    _started = false;
+
+    // Call the server stopped handler
+    onStopped();
+
+    // Wake up threads waiting for the server to be stopped
+    std::lock_guard<std::mutex> locker(_stopped_lock);
+    _stopped_event.notify_all();
+}
+
 template <class TServer, class TSession>
 inline bool WebSocketServer<TServer, TSession>::Multicast(const void* buffer, size_t size, websocketpp::frame::opcode::value opcode)
 {
@@ -266,11 +324,11 @@ inline void WebSocketServer<TServer, TSession>::MulticastAll()
         for (auto& session : _sessions)
         {
             for (auto& message : _multicast_buffer)
-                session.second->Send(std::get<0>(message).data(), std::get<0>(message).size(), std::get<1>(message));
+                session->Send(std::get<0>(message).data(), std::get<0>(message).size(), std::get<1>(message));
             for (auto& text : _multicast_text)
-                session.second->Send(std::get<0>(text), std::get<1>(text));
+                session->Send(std::get<0>(text), std::get<1>(text));
             for (auto& message : _multicast_messages)
-                session.second->Send(message);
+                session->Send(message);
         }
 
         // Clear the multicast buffers
@@ -292,7 +350,7 @@ inline bool WebSocketServer<TServer, TSession>::DisconnectAll()
     {
         // Disconnect all sessions
         for (auto& session : _sessions)
-            session.second->Disconnect();
+            session->Disconnect();
     });
 
     return true;
@@ -305,11 +363,14 @@ inline std::shared_ptr<TSession> WebSocketServer<TServer, TSession>::RegisterSes
     auto self(this->shared_from_this());
     auto session = std::make_shared<TSession>(self);
     _connections.insert(std::make_pair(connection, session));
-    _sessions.insert(std::make_pair(session->id(), session));
+    session->_id = _sessions.Register(session);
 
     // Connect a new session
     session->Connect(connection);
 
+    // Update statistic
+    _statistics.AddConnect();
+
     // Call a new session connected handler
     onConnected(session);
 
@@ -329,20 +390,27 @@ inline void WebSocketServer<TServer, TSession>::UnregisterSession(websocketpp::c
 }
 
 template <class TServer, class TSession>
-inline void WebSocketServer<TServer, TSession>::UnregisterSession(const CppCommon::UUID& id)
+inline void WebSocketServer<TServer, TSession>::UnregisterSession(SessionId id)
 {
     // Try to find the unregistered session
-    auto it = _sessions.find(id);
-    if (it != _sessions.end())
+    auto session = _sessions.Find(id);
+    if (session != nullptr)
     {
+        // Update statistic
+        _statistics.AddDisconnect();
+
         // Call the session disconnected handler
-        onDisconnected(it->second);
+        onDisconnected(session);
 
         // Erase the connection
-        _connections.erase(_connections.find(it->second->connection()));
+        _connections.erase(_connections.find(session->connection()));
 
         // Erase the session
-        _sessions.erase(it);
+        _sessions.Unregister(id);
+
+        // Complete the graceful stop of the server with the last closed session
+        if (IsDraining() && (_sessions.size() == 0))
+            CompleteDrain();
     }
 }
 
@@ -359,6 +427,9 @@ inline void WebSocketServer<TServer, TSession>::ClearBuffers()
 template <class TServer, class TSession>
 inline void WebSocketServer<TServer, TSession>::SendError(std::error_code ec)
 {
+    // Update statistic
+    _statistics.AddError();
+
     onError(ec.value(), ec.category().name(), ec.message());
 }
 
@@ -10,10 +10,14 @@
 #define CPPSERVER_ASIO_WEBSOCKET_SESSION_H
 
 #include "service.h"
+#include "session_registry.h"
+#include "statistics.h"
 #include "websocket.h"
 
 #include "system/uuid.h"
 
+#include <mutex>
+
 namespace CppServer {
 namespace Asio {
 
@@ -46,7 +50,16 @@ public:
     WebSocketSession& operator=(WebSocketSession&&) = default;
 
     //! Get the session Id
-    const CppCommon::UUID& id() const noexcept { return _id; }
+    /*!
+        Session Id is assigned by the server when the session is registered.
+    */
+    SessionId id() const noexcept { return _id; }
+    //! Get the session UUID
+    /*!
+        Session UUID is generated on the first call, so sessions that never
+        use it do not pay for the UUID generation.
+    */
+    const CppCommon::UUID& uuid() const;
 
     //! Get the Asio service
     std::shared_ptr<Service>& service() noexcept { return _server->service(); }
@@ -109,6 +122,14 @@ protected:
     */
     virtual void onReceived(const WebSocketMessage& message) {}
 
+    //! Handle session idle timeout notification
+    /*!
+        Notification is called when no messages were received from or sent to
+        the client during the idle timeout of the server. The session is
+        disconnected right after this handler.
+    */
+    virtual void onIdleTimeout() {}
+
     //! Handle error notification
     /*!
         \param error - Error code
@@ -118,17 +139,22 @@ protected:
     virtual void onError(int error, const std::string& category, const std::string& message) {}
 
 private:
-    // Session Id
-    CppCommon::UUID _id;
+    // Session Id & lazily generated UUID
+    SessionId _id;
+    mutable std::once_flag _uuid_flag;
+    mutable CppCommon::UUID _uuid;
     // Session server & connection
     std::shared_ptr<WebSocketServer<TServer, TSession>> _server;
     websocketpp::connection_hdl _connection;
     std::atomic<bool> _connected;
-    // Session statistic
-    uint64_t _messages_sent;
-    uint64_t _messages_received;
-    uint64_t _bytes_sent;
-    uint64_t _bytes_received;
+    // Session statistic. Messages are sent from any thread and received by the IO thread.
+    std::atomic<uint64_t> _messages_sent;
+    Counter _messages_received;
+    std::atomic<uint64_t> _bytes_sent;
+    Counter _bytes_received;
+    // Idle timeout. Messages are sent from any thread, so the activity timestamp is atomic.
+    std::atomic<TimerId> _idle_timer;
+    std::atomic<std::chrono::steady_clock::rep> _idle_activity;
 
     //! Connect the session
     /*!
@@ -144,9 +170,40 @@ private:
     */
     bool Disconnect(bool dispatch, websocketpp::close::status::value code = websocketpp::close::status::normal, const std::string& reason = "");
 
+    //! Drain the session
+    /*!
+        The session is closed with 'going away' status after all queued
+        messages are sent. The close handshake is bounded by the drain timeout.
+
+        \param timeout - Drain timeout
+    */
+    void Drain(const std::chrono::steady_clock::duration& timeout);
+    //! Abort the session
+    /*!
+        The session connection is terminated without waiting for the close
+        handshake of the client.
+    */
+    void Abort();
+
     //! Disconnected session handler
     void Disconnected();
 
+    //! Schedule the idle timeout check after the given delay
+    /*!
+        \param delay - Delay to check the idle timeout
+    */
+    void ScheduleIdleTimeout(const std::chrono::steady_clock::duration& delay);
+    //! Check the idle timeout of the session
+    /*!
+        The idle session is disconnected. Otherwise the idle timer is scheduled
+        again for the rest of the idle timeout.
+    */
+    void CheckIdleTimeout();
+    //! Cancel the idle timeout of the session
+    void CancelIdleTimeout();
+    //! Update the idle timeout activity of the session
+    void UpdateIdleActivity();
+
     //! Send error notification
     void SendError(std::error_code ec);
 };
@@ -11,16 +11,25 @@ namespace Asio {
 
 template <class TServer, class TSession>
 inline WebSocketSession<TServer, TSession>::WebSocketSession(std::shared_ptr<WebSocketServer<TServer, TSession>> server)
-    : _id(CppCommon::UUID::Generate()),
+    : _id(0),
       _server(server),
       _connected(false),
       _messages_sent(0),
       _messages_received(0),
       _bytes_sent(0),
-      _bytes_received(0)
+      _bytes_received(0),
+      _idle_timer(0),
+      _idle_activity(0)
 {
 }
 
+template <class TServer, class TSession>
+inline const CppCommon::UUID& WebSocketSession<TServer, TSession>::uuid() const
+{
+    std::call_once(_uuid_flag, [this]() { _uuid = CppCommon::UUID::Generate(); });
+    return _uuid;
+}
+
 template <class TServer, class TSession>
 inline void WebSocketSession<TServer, TSession>::Connect(websocketpp::connection_hdl connection)
 {
@@ -32,9 +41,9 @@ inline void WebSocketSession<TServer, TSession>::Connect(websocketpp::connection
 
         // Update statistic
         ++_messages_received;
-        ++_server->_messages_received;
         _bytes_received += size;
-        _server->_bytes_received += size;
+        _server->_statistics.AddReceived(size);
+        UpdateIdleActivity();
 
         // Call the message received handler
         onReceived(message);
@@ -59,6 +68,14 @@ inline void WebSocketSession<TServer, TSession>::Connect(websocketpp::connection
     // Update the connected flag
     _connected = true;
 
+    // Start the idle timeout of the session
+    auto timeout = _server->option_idle_timeout();
+    if (timeout.count() > 0)
+    {
+        UpdateIdleActivity();
+        ScheduleIdleTimeout(timeout);
+    }
+
     // Call the session connected handler
     onConnected();
 }
@@ -88,9 +105,57 @@ inline bool WebSocketSession<TServer, TSession>::Disconnect(bool dispatch, webso
     return true;
 }
 
+template <class TServer, class TSession>
+inline void WebSocketSession<TServer, TSession>::Drain(const std::chrono::steady_clock::duration& timeout)
+{
+    if (!IsConnected())
+        return;
+
+    // Post the drain routine
+    auto self(this->shared_from_this());
+    service()->Post([this, self, timeout]()
+    {
+        websocketpp::lib::error_code ec;
+        WebSocketServerCore::connection_ptr con = _server->core().get_con_from_hdl(_connection, ec);
+        if (ec)
+            return;
+
+        // Bound the close handshake of the session by the drain timeout
+        con->set_close_handshake_timeout((long)std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count());
+
+        // Close the session connection. Queued messages are sent before the close frame.
+        con->close(websocketpp::close::status::going_away, "Server is stopping", ec);
+        if (ec)
+            SendError(ec);
+    });
+}
+
+template <class TServer, class TSession>
+inline void WebSocketSession<TServer, TSession>::Abort()
+{
+    if (!IsConnected())
+        return;
+
+    // Post the abort routine
+    auto self(this->shared_from_this());
+    service()->Post([this, self]()
+    {
+        websocketpp::lib::error_code ec;
+        WebSocketServerCore::connection_ptr con = _server->core().get_con_from_hdl(_connection, ec);
+        if (ec)
+            return;
+
+        // Terminate the session connection without the close handshake
+        con->terminate(websocketpp::lib::error_code());
+    });
+}
+
 template <class TServer, class TSession>
 inline void WebSocketSession<TServer, TSession>::Disconnected()
 {
+    // Cancel the idle timeout of the session
+    CancelIdleTimeout();
+
     // Update the connected flag
     _connected = false;
 
@@ -101,6 +166,57 @@ inline void WebSocketSession<TServer, TSession>::Disconnected()
     _server->UnregisterSession(id());
 }
 
+template <class TServer, class TSession>
+inline void WebSocketSession<TServer, TSession>::ScheduleIdleTimeout(const std::chrono::steady_clock::duration& delay)
+{
+    auto self(this->shared_from_this());
+    _idle_timer = service()->Schedule(delay, [this, self]() { CheckIdleTimeout(); });
+
+    // Cancel the idle timer scheduled concurrently with the session disconnect
+    if (!IsConnected())
+        CancelIdleTimeout();
+}
+
+template <class TServer, class TSession>
+inline void WebSocketSession<TServer, TSession>::CheckIdleTimeout()
+{
+    if (!IsConnected() || (_idle_timer == 0))
+        return;
+
+    // Schedule the idle timer again for the rest of the idle timeout
+    auto timeout = _server->option_idle_timeout();
+    auto activity = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(_idle_activity.load(std::memory_order_relaxed)));
+    auto idle = std::chrono::steady_clock::now() - activity;
+    if (idle < timeout)
+    {
+        ScheduleIdleTimeout(timeout - idle);
+        return;
+    }
+
+    _idle_timer = 0;
+
+    // Call the session idle timeout handler
+    onIdleTimeout();
+
+    // Disconnect the idle session
+    Disconnect(true, websocketpp::close::status::going_away, "Idle timeout");
+}
+
+template <class TServer, class TSession>
+inline void WebSocketSession<TServer, TSession>::CancelIdleTimeout()
+{
+    TimerId id = _idle_timer.exchange(0);
+    if (id != 0)
+        service()->Cancel(id);
+}
+
+template <class TServer, class TSession>
+inline void WebSocketSession<TServer, TSession>::UpdateIdleActivity()
+{
+    if (_server->option_idle_timeout().count() > 0)
+        _idle_activity.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
 template <class TServer, class TSession>
 inline size_t WebSocketSession<TServer, TSession>::Send(const void* buffer, size_t size, websocketpp::frame::opcode::value opcode)
 {
@@ -121,10 +237,10 @@ inline size_t WebSocketSession<TServer, TSession>::Send(const void* buffer, size
     }
 
     // Update statistic
-    ++_messages_sent;
-    ++_server->_messages_sent;
-    _bytes_sent += size;
-    _server->_bytes_sent += size;
+    _messages_sent.fetch_add(1, std::memory_order_relaxed);
+    _bytes_sent.fetch_add(size, std::memory_order_relaxed);
+    _server->_statistics.AddSent(size);
+    UpdateIdleActivity();
 
     return size;
 }
@@ -146,10 +262,10 @@ inline size_t WebSocketSession<TServer, TSession>::Send(const std::string& text,
     size_t size = text.size();
 
     // Update statistic
-    ++_messages_sent;
-    ++_server->_messages_sent;
-    _bytes_sent += size;
-    _server->_bytes_sent += size;
+    _messages_sent.fetch_add(1, std::memory_order_relaxed);
+    _bytes_sent.fetch_add(size, std::memory_order_relaxed);
+    _server->_statistics.AddSent(size);
+    UpdateIdleActivity();
 
     return size;
 }
@@ -171,10 +287,10 @@ inline size_t WebSocketSession<TServer, TSession>::Send(const WebSocketMessage&
     size_t size = message->get_raw_payload().size();
 
     // Update statistic
-    ++_messages_sent;
-    ++_server->_messages_sent;
-    _bytes_sent += size;
-    _server->_bytes_sent += size;
+    _messages_sent.fetch_add(1, std::memory_order_relaxed);
+    _bytes_sent.fetch_add(size, std::memory_order_relaxed);
+    _server->_statistics.AddSent(size);
+    UpdateIdleActivity();
 
     return size;
 }
@@ -182,6 +298,9 @@ inline size_t WebSocketSession<TServer, TSession>::Send(const WebSocketMessage&
 template <class TServer, class TSession>
 inline void WebSocketSession<TServer, TSession>::SendError(std::error_code ec)
 {
+    // Update statistic
+    _server->_statistics.AddError();
+
     onError(ec.value(), ec.category().name(), ec.message());
 }
 
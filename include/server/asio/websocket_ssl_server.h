@@ -11,6 +11,7 @@
 
 #include "websocket_ssl_session.h"
 
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <tuple>
@@ -77,16 +78,35 @@ public:
     //! Get the number of sessions currently connected to this server
     uint64_t current_sessions() const noexcept { return _sessions.size(); }
     //! Get the number messages sent by this server
-    uint64_t messages_sent() const noexcept { return _messages_sent; }
+    uint64_t messages_sent() const noexcept { return _statistics.messages_sent(); }
     //! Get the number messages received by this server
-    uint64_t messages_received() const noexcept { return _messages_received; }
+    uint64_t messages_received() const noexcept { return _statistics.messages_received(); }
     //! Get the number of bytes sent by this server
-    uint64_t bytes_sent() const noexcept { return _bytes_sent; }
+    uint64_t bytes_sent() const noexcept { return _statistics.bytes_sent(); }
     //! Get the number of bytes received by this server
-    uint64_t bytes_received() const noexcept { return _bytes_received; }
+    uint64_t bytes_received() const noexcept { return _statistics.bytes_received(); }
+    //! Get the server statistics
+    const Statistics& statistics() const noexcept { return _statistics; }
 
     //! Is the server started?
     bool IsStarted() const noexcept { return _started; }
+    //! Is the server draining its sessions to stop?
+    bool IsDraining() const noexcept { return _draining; }
+
+    //! Get the option: idle timeout
+    std::chrono::steady_clock::duration option_idle_timeout() const noexcept { return _idle_timeout; }
+
+    //! Setup option: idle timeout
+    /*!
+        Sessions which neither receive nor send any message during the idle
+        timeout are disconnected. Idle timeouts are scheduled in the timer
+        wheel of the server Asio service.
+
+        Default idle timeout is 0 (idle timeout is disabled).
+
+        \param timeout - Idle timeout
+    */
+    void SetupIdleTimeout(const std::chrono::steady_clock::duration& timeout) noexcept { _idle_timeout = timeout; }
 
     //! Start the server
     /*!
@@ -95,15 +115,41 @@ public:
     bool Start();
     //! Stop the server
     /*!
+        Stops accepting new connections and disconnects all sessions at once.
+
+        \return 'true' if the server was successfully stopped, 'false' if the server is already stopped
+    */
+    bool Stop() { return Stop(std::chrono::steady_clock::duration::zero()); }
+    //! Stop the server gracefully with the given drain timeout
+    /*!
+        Stops accepting new connections and closes connected sessions with
+        'going away' status. Each session sends all queued messages before
+        the close frame and waits for the close handshake of the client no
+        longer than the drain timeout. Sessions which are not closed until
+        the timeout are terminated.
+
+        The server is stopped when the last session is closed or the drain
+        timeout expires. Then the server stopped handler is called and threads
+        waiting for the server to be stopped are woken up.
+
+        \param timeout - Drain timeout (0 - disconnect all sessions at once)
         \return 'true' if the server was successfully stopped, 'false' if the server is already stopped
     */
-    bool Stop();
+    bool Stop(const std::chrono::steady_clock::duration& timeout);
     //! Restart the server
     /*!
         \return 'true' if the server was successfully restarted, 'false' if the server failed to restart
     */
     bool Restart();
 
+    //! Wait for the server to be stopped
+    /*!
+        Blocks the calling thread until the server stop routine is completed
+        instead of spinning on IsStarted(). Should not be called from working
+        threads of the server Asio service.
+    */
+    void WaitStopped();
+
     //! Multicast data to all connected sessions
     /*!
         \param buffer - Buffer to send
@@ -166,14 +212,18 @@ private:
     WebSocketSSLServerCore _core;
     std::atomic<bool> _initialized;
     std::atomic<bool> _started;
-    // Server statistic
-    uint64_t _messages_sent;
-    uint64_t _messages_received;
-    uint64_t _bytes_sent;
-    uint64_t _bytes_received;
+    // Graceful stop: drain state, drain timeout & stopped event
+    std::atomic<bool> _draining;
+    TimerId _drain_timer;
+    std::mutex _stopped_lock;
+    std::condition_variable _stopped_event;
+    // Server options
+    std::chrono::steady_clock::duration _idle_timeout;
+    // Server statistic (updated by sessions from different threads)
+    Statistics _statistics;
     // Server sessions
     std::map<websocketpp::connection_hdl, std::shared_ptr<TSession>, std::owner_less<websocketpp::connection_hdl>> _connections;
-    std::map<CppCommon::UUID, std::shared_ptr<TSession>> _sessions;
+    SessionRegistry<TSession> _sessions;
     // Multicast buffer
     std::mutex _multicast_lock;
     std::vector<std::tuple<std::vector<uint8_t>, websocketpp::frame::opcode::value>> _multicast_buffer;
@@ -197,7 +247,15 @@ private:
     /*!
         \param id - Session Id
     */
-    void UnregisterSession(const CppCommon::UUID& id);
+    void UnregisterSession(SessionId id);
+
+    //! Complete the graceful stop of the server
+    /*!
+        Called once by the last closed session or by the drain timeout.
+    */
+    void CompleteDrain();
+    //! Update the server state stopped and signal threads waiting for it
+    void Stopped();
 
     //! Multicast all
     void MulticastAll();
@@ -6,6 +6,10 @@ if(NOT TARGET asio)
   target_compile_definitions(asio PRIVATE ASIO_STANDALONE ASIO_SEPARATE_COMPILATION)
   target_include_directories(asio PRIVATE "asio/asio/include" PRIVATE ${OPENSSL_INCLUDE_DIR})
   target_link_libraries(asio ${OPENSSL_LIBRARIES})
+  if(CPPSERVER_IO_URING)
+    target_compile_definitions(asio PRIVATE ASIO_HAS_IO_URING ASIO_HAS_IO_URING_AS_DEFAULT)
+    target_link_libraries(asio ${LIBURING_LIBRARIES})
+  endif()
 
   # Module folder
   set_target_properties(asio PROPERTIES FOLDER modules/asio)
@@ -0,0 +1,116 @@
+//
+// Created by Ivan Shynkarenka on 29.03.2017
+//
+
+#include "benchmark/reporter_console.h"
+#include "server/asio/service.h"
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../../modules/cpp-optparse/OptionParser.h"
+
+using namespace CppServer::Asio;
+
+std::atomic<uint64_t> total_errors(0);
+std::atomic<uint64_t> total_expired(0);
+
+class TimersService : public Service
+{
+public:
+    using Service::Service;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Service caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-h", "--help").help("Show help");
+    parser.add_option("-t", "--threads").action("store").type("int").set_default(1).help("Count of working threads. Default: %default");
+    parser.add_option("-n", "--timers").action("store").type("int").set_default(1000000).help("Count of armed timers. Default: %default");
+    parser.add_option("-d", "--delay").action("store").type("int").set_default(1000).help("Maximal timer delay in milliseconds. Default: %default");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        parser.exit();
+    }
+
+    // Benchmark parameters
+    int threads_count = options.get("threads");
+    int timers_count = options.get("timers");
+    int max_delay = options.get("delay");
+
+    std::cout << "Working threads: " << threads_count << std::endl;
+    std::cout << "Armed timers: " << timers_count << std::endl;
+    std::cout << "Maximal timer delay: " << max_delay << " ms" << std::endl;
+
+    // Create a new Asio service
+    auto service = std::make_shared<TimersService>();
+
+    // Start the service
+    std::cout << "Asio service starting...";
+    service->Start(false, threads_count);
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::mt19937 random;
+    std::uniform_int_distribution<int> delays(max_delay / 2, max_delay);
+    std::vector<TimerId> timers(timers_count);
+
+    // Arm all timers
+    uint64_t timestamp_start = CppCommon::Timestamp::nano();
+    for (auto& timer : timers)
+        timer = service->Schedule(std::chrono::milliseconds(delays(random)), []() { ++total_expired; });
+    uint64_t schedule_time = CppCommon::Timestamp::nano() - timestamp_start;
+
+    // Reset all armed timers like idle timeouts of active sessions
+    timestamp_start = CppCommon::Timestamp::nano();
+    for (auto& timer : timers)
+    {
+        service->Cancel(timer);
+        timer = service->Schedule(std::chrono::milliseconds(delays(random)), []() { ++total_expired; });
+    }
+    uint64_t reset_time = CppCommon::Timestamp::nano() - timestamp_start;
+
+    // Wait for all timers expired
+    timestamp_start = CppCommon::Timestamp::nano();
+    while (total_expired < (uint64_t)timers_count)
+        CppCommon::Thread::Yield();
+    uint64_t expire_time = CppCommon::Timestamp::nano() - timestamp_start;
+
+    // Stop the service
+    std::cout << "Asio service stopping...";
+    service->Stop();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Errors: " << total_errors << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Schedule time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(schedule_time) << std::endl;
+    std::cout << "Schedule latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(schedule_time / timers_count) << std::endl;
+    std::cout << "Reset time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(reset_time) << std::endl;
+    std::cout << "Reset latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(reset_time / timers_count) << std::endl;
+    std::cout << "Expire time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(expire_time) << std::endl;
+    std::cout << "Expired timers: " << total_expired << std::endl;
+
+    return 0;
+}
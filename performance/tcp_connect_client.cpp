@@ -0,0 +1,151 @@
+//
+// Created by Ivan Shynkarenka on 18.03.2017
+//
+
+#include "benchmark/reporter_console.h"
+#include "server/asio/service.h"
+#include "server/asio/tcp_client.h"
+#include "system/cpu.h"
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include "../../modules/cpp-optparse/OptionParser.h"
+
+using namespace CppServer::Asio;
+
+std::atomic<bool> running(true);
+
+std::atomic<uint64_t> total_errors(0);
+std::atomic<uint64_t> total_connects(0);
+
+class ConnectClient : public TCPClient
+{
+public:
+    using TCPClient::TCPClient;
+
+protected:
+    void onConnected() override
+    {
+        ++total_connects;
+
+        // Disconnect immediately to measure the connect rate
+        Disconnect();
+    }
+
+    void onDisconnected() override
+    {
+        // Reconnect the client until the benchmark is finished
+        if (running)
+            Connect();
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Client caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-h", "--help").help("Show help");
+    parser.add_option("-a", "--address").set_default("127.0.0.1").help("Server address. Default: %default");
+    parser.add_option("-p", "--port").action("store").type("int").set_default(1111).help("Server port. Default: %default");
+    parser.add_option("-t", "--threads").action("store").type("int").set_default(CppCommon::CPU::LogicalCores()).help("Count of working threads. Default: %default");
+    parser.add_option("-c", "--clients").action("store").type("int").set_default(100).help("Count of working clients. Default: %default");
+    parser.add_option("-z", "--seconds").action("store").type("int").set_default(10).help("Count of seconds to benchmark. Default: %default");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        parser.exit();
+    }
+
+    // Client parameters
+    std::string address(options.get("address"));
+    int port = options.get("port");
+    int threads_count = options.get("threads");
+    int clients_count = options.get("clients");
+    int seconds_count = options.get("seconds");
+
+    std::cout << "Server address: " << address << std::endl;
+    std::cout << "Server port: " << port << std::endl;
+    std::cout << "Working threads: " << threads_count << std::endl;
+    std::cout << "Working clients: " << clients_count << std::endl;
+    std::cout << "Seconds to benchmarking: " << seconds_count << std::endl;
+
+    // Create Asio services
+    std::vector<std::shared_ptr<Service>> services;
+    for (int i = 0; i < threads_count; ++i)
+    {
+        auto service = std::make_shared<Service>();
+        services.emplace_back(service);
+    }
+
+    // Start Asio services
+    std::cout << "Asio services starting...";
+    for (auto& service : services)
+        service->Start();
+    std::cout << "Done!" << std::endl;
+
+    // Create connect clients
+    std::vector<std::shared_ptr<ConnectClient>> clients;
+    for (int i = 0; i < clients_count; ++i)
+    {
+        auto client = std::make_shared<ConnectClient>(services[i % services.size()], address, port);
+        clients.emplace_back(client);
+    }
+
+    uint64_t timestamp_start = CppCommon::Timestamp::nano();
+
+    // Connect clients
+    std::cout << "Clients connecting...";
+    for (auto& client : clients)
+        client->Connect();
+    std::cout << "Done!" << std::endl;
+
+    // Wait for benchmarking
+    std::cout << "Benchmarking...";
+    CppCommon::Thread::Sleep(seconds_count * 1000);
+    std::cout << "Done!" << std::endl;
+
+    // Stop reconnecting clients
+    running = false;
+
+    uint64_t timestamp_stop = CppCommon::Timestamp::nano();
+    uint64_t connects = total_connects;
+
+    // Disconnect clients
+    std::cout << "Clients disconnecting...";
+    for (auto& client : clients)
+    {
+        client->Disconnect();
+        while (client->IsConnected())
+            CppCommon::Thread::Yield();
+    }
+    std::cout << "Done!" << std::endl;
+
+    // Stop Asio services
+    std::cout << "Asio services stopping...";
+    for (auto& service : services)
+        service->Stop();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Total time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start) << std::endl;
+    std::cout << "Total connects: " << connects << std::endl;
+    std::cout << "Connects throughput: " << connects * 1000000000 / (timestamp_stop - timestamp_start) << " connects per second" << std::endl;
+    std::cout << "Errors: " << total_errors << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+//
+// Created by Ivan Shynkarenka on 18.03.2017
+//
+
+#include "server/asio/service.h"
+#include "server/asio/service_pool.h"
+#include "server/asio/tcp_server.h"
+
+#include <atomic>
+#include <iostream>
+
+#include "../../modules/cpp-optparse/OptionParser.h"
+
+using namespace CppServer::Asio;
+
+class ConnectSession;
+
+class ConnectServer : public TCPServer<ConnectServer, ConnectSession>
+{
+public:
+    using TCPServer<ConnectServer, ConnectSession>::TCPServer;
+
+    std::atomic<uint64_t> accepted{0};
+
+protected:
+    void onConnected(std::shared_ptr<ConnectSession>& session) override
+    {
+        ++accepted;
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Server caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+    }
+};
+
+class ConnectSession : public TCPSession<ConnectServer, ConnectSession>
+{
+public:
+    using TCPSession<ConnectServer, ConnectSession>::TCPSession;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Session caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+    }
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-h", "--help").help("Show help");
+    parser.add_option("-p", "--port").action("store").type("int").set_default(1111).help("Server port. Default: %default");
+    parser.add_option("-t", "--threads").action("store").type("int").set_default(1).help("Count of services in the service pool (0 - no service pool). Default: %default");
+    parser.add_option("-r", "--reuse-port").action("store_true").help("Accept connections with one SO_REUSEPORT acceptor per service of the pool");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        parser.exit();
+    }
+
+    // Server port, service pool size & reuse port mode
+    int port = options.get("port");
+    int threads = options.get("threads");
+    bool reuse_port = options.get("reuse_port");
+
+    std::cout << "Server port: " << port << std::endl;
+    std::cout << "Service pool: " << threads << std::endl;
+    std::cout << "Reuse port: " << (reuse_port ? "true" : "false") << std::endl;
+
+    // Create a new Asio service
+    auto service = std::make_shared<Service>();
+
+    // Start the service
+    std::cout << "Asio service starting...";
+    service->Start();
+    std::cout << "Done!" << std::endl;
+
+    // Create a new Asio service pool
+    std::shared_ptr<ServicePool> pool;
+    if (threads > 0)
+    {
+        pool = std::make_shared<ServicePool>(threads);
+
+        // Start the service pool
+        std::cout << "Asio service pool starting...";
+        pool->Start();
+        std::cout << "Done!" << std::endl;
+    }
+
+    // Create a new connect server
+    auto server = std::make_shared<ConnectServer>(service, InternetProtocol::IPv4, port);
+    server->SetupServicePool(pool);
+    server->SetupReusePort(reuse_port);
+
+    // Start the server
+    std::cout << "Server starting...";
+    server->Start();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << "Press Enter to stop the server or '!' to restart the server..." << std::endl;
+
+    // Perform text input
+    std::string line;
+    while (getline(std::cin, line))
+    {
+        if (line.empty())
+            break;
+
+        // Restart the server
+        if (line == "!")
+        {
+            std::cout << "Server restarting...";
+            server->Restart();
+            std::cout << "Done!" << std::endl;
+            continue;
+        }
+    }
+
+    // Stop the server
+    std::cout << "Server stopping...";
+    server->Stop();
+    std::cout << "Done!" << std::endl;
+
+    // Stop the service pool
+    if (pool)
+    {
+        std::cout << "Asio service pool stopping...";
+        pool->Stop();
+        std::cout << "Done!" << std::endl;
+    }
+
+    // Stop the service
+    std::cout << "Asio service stopping...";
+    service->Stop();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Total accepted connections: " << server->accepted << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+//
+// Created by Ivan Shynkarenka on 28.03.2017
+//
+
+#include "benchmark/reporter_console.h"
+#include "server/asio/service.h"
+#include "server/asio/service_pool.h"
+#include "server/asio/tcp_client.h"
+#include "server/asio/tcp_server.h"
+#include "system/cpu.h"
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include "../../modules/cpp-optparse/OptionParser.h"
+
+using namespace CppServer::Asio;
+
+std::atomic<uint64_t> total_errors(0);
+
+class StormSession;
+
+class StormServer : public TCPServer<StormServer, StormSession>
+{
+public:
+    using TCPServer<StormServer, StormSession>::TCPServer;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Server caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class StormSession : public TCPSession<StormServer, StormSession>
+{
+public:
+    using TCPSession<StormServer, StormSession>::TCPSession;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Session caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class StormClient : public TCPClient
+{
+public:
+    using TCPClient::TCPClient;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Client caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-h", "--help").help("Show help");
+    parser.add_option("-p", "--port").action("store").type("int").set_default(1111).help("Server port. Default: %default");
+    parser.add_option("-t", "--threads").action("store").type("int").set_default(CppCommon::CPU::LogicalCores()).help("Count of working threads. Default: %default");
+    parser.add_option("-c", "--clients").action("store").type("int").set_default(1000).help("Count of clients connecting at once. Default: %default");
+    parser.add_option("-b", "--backlog").action("store").type("int").set_default(1024).help("Server accept backlog. Default: %default");
+    parser.add_option("-k", "--accepts").action("store").type("int").set_default(CppCommon::CPU::LogicalCores()).help("Maximal count of outstanding server accepts. Default: %default");
+    parser.add_option("-r", "--rounds").action("store").type("int").set_default(10).help("Count of connection storms per configuration. Default: %default");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        parser.exit();
+    }
+
+    // Benchmark parameters
+    int port = options.get("port");
+    int threads_count = options.get("threads");
+    int clients_count = options.get("clients");
+    int backlog = options.get("backlog");
+    int accepts_count = options.get("accepts");
+    int rounds_count = options.get("rounds");
+
+    std::cout << "Server port: " << port << std::endl;
+    std::cout << "Working threads: " << threads_count << std::endl;
+    std::cout << "Clients per storm: " << clients_count << std::endl;
+    std::cout << "Accept backlog: " << backlog << std::endl;
+    std::cout << "Outstanding accepts: 1.." << accepts_count << std::endl;
+    std::cout << "Storms per configuration: " << rounds_count << std::endl;
+
+    // Create Asio services for the server and clients and the service pool for sessions
+    auto server_service = std::make_shared<Service>();
+    auto pool = std::make_shared<ServicePool>(threads_count);
+    std::vector<std::shared_ptr<Service>> client_services;
+    for (int i = 0; i < threads_count; ++i)
+        client_services.emplace_back(std::make_shared<Service>());
+
+    // Start Asio services
+    std::cout << "Asio services starting...";
+    server_service->Start();
+    pool->Start();
+    for (auto& service : client_services)
+        service->Start();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    // Storm the server with connections for 1..K outstanding accepts
+    for (int accepts = 1; accepts <= accepts_count; accepts *= 2)
+    {
+        // Create and start the server
+        auto server = std::make_shared<StormServer>(server_service, InternetProtocol::IPv4, port);
+        server->SetupServicePool(pool);
+        server->SetupAcceptBacklog(backlog);
+        server->SetupAcceptConcurrency(accepts);
+        server->Start();
+        while (!server->IsStarted())
+            CppCommon::Thread::Yield();
+
+        // Create storm clients
+        std::vector<std::shared_ptr<StormClient>> clients;
+        for (int i = 0; i < clients_count; ++i)
+            clients.emplace_back(std::make_shared<StormClient>(client_services[i % client_services.size()], "127.0.0.1", port));
+
+        uint64_t total_time = 0;
+        for (int round = 0; round < rounds_count; ++round)
+        {
+            uint64_t connects = server->statistics().connects();
+            uint64_t timestamp_start = CppCommon::Timestamp::nano();
+
+            // Connect all clients at once and wait until the server accepts all of them
+            for (auto& client : clients)
+                client->Connect();
+            while (server->statistics().connects() < (connects + clients_count))
+                CppCommon::Thread::Yield();
+
+            total_time += CppCommon::Timestamp::nano() - timestamp_start;
+
+            // Disconnect all clients
+            for (auto& client : clients)
+                client->Disconnect();
+            for (auto& client : clients)
+                while (client->IsConnected())
+                    CppCommon::Thread::Yield();
+            while (server->current_sessions() > 0)
+                CppCommon::Thread::Yield();
+        }
+
+        // Stop the server
+        server->Stop();
+        while (server->IsStarted())
+            CppCommon::Thread::Yield();
+
+        uint64_t total_connects = (uint64_t)clients_count * rounds_count;
+
+        std::cout << "Outstanding accepts: " << accepts
+                  << ", storm time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(total_time / rounds_count)
+                  << ", accept throughput: " << total_connects * 1000000000 / total_time << " connections per second" << std::endl;
+    }
+
+    std::cout << std::endl;
+
+    // Stop Asio services
+    std::cout << "Asio services stopping...";
+    for (auto& service : client_services)
+        service->Stop();
+    pool->Stop();
+    server_service->Stop();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << "Errors: " << total_errors << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,245 @@
+//
+// Created by Ivan Shynkarenka on 31.03.2017
+//
+
+#include "benchmark/reporter_console.h"
+#include "server/asio/service.h"
+#include "server/asio/tcp_client.h"
+#include "server/asio/tcp_server.h"
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "../../modules/cpp-optparse/OptionParser.h"
+
+using namespace CppServer::Asio;
+
+std::atomic<uint64_t> total_allocations(0);
+std::atomic<uint64_t> total_errors(0);
+std::atomic<uint64_t> total_round_trips(0);
+
+// Count all heap allocations of the process
+void* operator new(std::size_t size)
+{
+    ++total_allocations;
+    void* ptr = std::malloc((size > 0) ? size : 1);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t size) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t size) noexcept
+{
+    std::free(ptr);
+}
+
+class EchoSession;
+
+class EchoServer : public TCPServer<EchoServer, EchoSession>
+{
+public:
+    using TCPServer<EchoServer, EchoSession>::TCPServer;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Server caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class EchoSession : public TCPSession<EchoServer, EchoSession>
+{
+public:
+    using TCPSession<EchoServer, EchoSession>::TCPSession;
+
+protected:
+    size_t onReceived(const void* buffer, size_t size) override
+    {
+        // Resend the message back to the client
+        Send(buffer, size);
+        return size;
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Session caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class PingClient : public TCPClient
+{
+public:
+    PingClient(std::shared_ptr<Service> service, const std::string& address, int port, size_t message_size)
+        : TCPClient(service, address, port),
+          _message(message_size, 'x'),
+          _received(0)
+    {
+    }
+
+    void Ping() { Send(_message.data(), _message.size()); }
+
+protected:
+    size_t onReceived(const void* buffer, size_t size) override
+    {
+        // Send the next ping once the whole message is echoed back
+        _received += size;
+        if (_received >= _message.size())
+        {
+            _received -= _message.size();
+            ++total_round_trips;
+            Ping();
+        }
+        return size;
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Client caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+
+private:
+    std::vector<uint8_t> _message;
+    size_t _received;
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-h", "--help").help("Show help");
+    parser.add_option("-p", "--port").action("store").type("int").set_default(1111).help("Server port. Default: %default");
+    parser.add_option("-t", "--threads").action("store").type("int").set_default(1).help("Count of working threads. Default: %default");
+    parser.add_option("-s", "--size").action("store").type("int").set_default(32).help("Single message size. Default: %default");
+    parser.add_option("-w", "--warmup").action("store").type("int").set_default(10000).help("Count of warmup round trips. Default: %default");
+    parser.add_option("-r", "--round-trips").action("store").type("int").set_default(100000).help("Count of measured round trips. Default: %default");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        parser.exit();
+    }
+
+    // Benchmark parameters
+    int port = options.get("port");
+    int threads = options.get("threads");
+    int message_size = options.get("size");
+    int warmup = options.get("warmup");
+    int round_trips = options.get("round_trips");
+
+    std::cout << "Server port: " << port << std::endl;
+    std::cout << "Working threads: " << threads << std::endl;
+    std::cout << "Message size: " << message_size << std::endl;
+    std::cout << "Warmup round trips: " << warmup << std::endl;
+    std::cout << "Measured round trips: " << round_trips << std::endl;
+
+    std::cout << std::endl;
+
+    // Create and start a new Asio service
+    auto service = std::make_shared<Service>();
+    std::cout << "Asio service starting...";
+    service->Start(false, threads);
+    while (!service->IsStarted())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Create and start a new echo server
+    auto server = std::make_shared<EchoServer>(service, InternetProtocol::IPv4, port);
+    std::cout << "Server starting...";
+    server->Start();
+    while (!server->IsStarted())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Create and connect a new ping client
+    auto client = std::make_shared<PingClient>(service, "127.0.0.1", port, message_size);
+    std::cout << "Client connecting...";
+    client->Connect();
+    while (!client->IsConnected() || (server->current_sessions() == 0))
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    // Start the ping-pong and warm up session buffers and handler storages
+    client->Ping();
+    while (total_round_trips < (uint64_t)warmup)
+        CppCommon::Thread::Yield();
+
+    // Measure heap allocations of steady-state round trips
+    uint64_t round_trips_start = total_round_trips;
+    uint64_t allocations_start = total_allocations;
+    uint64_t timestamp_start = CppCommon::Timestamp::nano();
+    while (total_round_trips < (round_trips_start + round_trips))
+        CppCommon::Thread::Yield();
+    uint64_t timestamp_stop = CppCommon::Timestamp::nano();
+    uint64_t allocations_stop = total_allocations;
+    uint64_t round_trips_stop = total_round_trips;
+
+    // Disconnect the client
+    std::cout << "Client disconnecting...";
+    client->Disconnect();
+    while (client->IsConnected())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Stop the server
+    std::cout << "Server stopping...";
+    server->Stop();
+    while (server->IsStarted())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Stop the service
+    std::cout << "Asio service stopping...";
+    service->Stop();
+    while (service->IsStarted())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    uint64_t measured = round_trips_stop - round_trips_start;
+    uint64_t allocations = allocations_stop - allocations_start;
+
+    std::cout << "Errors: " << total_errors << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Round trips: " << measured << std::endl;
+    std::cout << "Round-trip latency: " << CppBenchmark::ReporterConsole::GenerateTimePeriod((timestamp_stop - timestamp_start) / measured) << std::endl;
+    std::cout << "Heap allocations: " << allocations << std::endl;
+    std::cout << "Heap allocations per round trip: " << (double)allocations / measured << std::endl;
+
+    return (allocations == 0) ? 0 : 1;
+}
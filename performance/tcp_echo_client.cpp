@@ -25,6 +25,8 @@ uint64_t timestamp_stop = 0;
 std::atomic<uint64_t> total_errors(0);
 std::atomic<uint64_t> total_bytes(0);
 std::atomic<uint64_t> total_messages(0);
+std::atomic<uint64_t> total_sends(0);
+std::atomic<uint64_t> total_receives(0);
 
 class EchoClient : public TCPClient
 {
@@ -46,11 +48,20 @@ protected:
         timestamp_stop = CppCommon::Timestamp::nano();
         total_bytes += size;
 
+        // Each received notification is a completed socket receive operation
+        ++total_receives;
+
         SendMessage();
 
         return size;
     }
 
+    void onSent(size_t sent, size_t pending) override
+    {
+        // Each sent notification is a completed socket send operation
+        ++total_sends;
+    }
+
     void onError(int error, const std::string& category, const std::string& message) override
     {
         std::cout << "Client caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
@@ -98,6 +109,7 @@ int main(int argc, char** argv)
     int messages_count = options.get("messages");
     int message_size = options.get("size");
 
+    std::cout << "Asio backend: " << Service::backend() << std::endl;
     std::cout << "Server address: " << address << std::endl;
     std::cout << "Server port: " << port << std::endl;
     std::cout << "Working threads: " << threads_count << std::endl;
@@ -166,6 +178,10 @@ int main(int argc, char** argv)
     std::cout << "Total messages: " << total_messages << std::endl;
     std::cout << "Bytes throughput: " << total_bytes * 1000000000 / (timestamp_stop - timestamp_start) << " bytes per second" << std::endl;
     std::cout << "Messages throughput: " << total_messages * 1000000000 / (timestamp_stop - timestamp_start) << " messages per second" << std::endl;
+    std::cout << "Send operations: " << total_sends << std::endl;
+    std::cout << "Send operations per message: " << (double)total_sends / total_messages << std::endl;
+    std::cout << "Receive operations: " << total_receives << std::endl;
+    std::cout << "Receive operations per message: " << (double)total_receives / total_messages << std::endl;
     std::cout << "Errors: " << total_errors << std::endl;
 
     return 0;
@@ -5,12 +5,16 @@
 #include "server/asio/service.h"
 #include "server/asio/tcp_server.h"
 
+#include <atomic>
 #include <iostream>
+#include <vector>
 
 #include "../../modules/cpp-optparse/OptionParser.h"
 
 using namespace CppServer::Asio;
 
+std::atomic<uint64_t> total_sends(0);
+
 class EchoSession;
 
 class EchoServer : public TCPServer<EchoServer, EchoSession>
@@ -39,6 +43,12 @@ protected:
         return size;
     }
 
+    void onSent(size_t sent, size_t pending) override
+    {
+        // Each sent notification is a completed socket send operation
+        ++total_sends;
+    }
+
     void onError(int error, const std::string& category, const std::string& message) override
     {
         std::cout << "Session caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
@@ -51,6 +61,15 @@ int main(int argc, char** argv)
 
     parser.add_option("-h", "--help").help("Show help");
     parser.add_option("-p", "--port").action("store").type("int").set_default(1111).help("Server port. Default: %default");
+    parser.add_option("-t", "--threads").action("store").type("int").set_default(1).help("Count of working threads. Default: %default");
+    parser.add_option("-a", "--affinity").action("store").set_default("").help("CPU list to pin working threads one per CPU (e.g. 0-3,8). Default: not pinned");
+    parser.add_option("-n", "--numa").action("store").type("int").set_default(-1).help("NUMA node to place working threads and their memory (-1 - not placed). Default: %default");
+    parser.add_option("-l", "--limit").action("store").type("int").set_default(0).help("Send size limit in bytes (0 - unlimited). Default: %default");
+    parser.add_option("-m", "--buffer-min").action("store").type("int").set_default(4096).help("Minimal session buffer size in bytes. Default: %default");
+    parser.add_option("-M", "--buffer-max").action("store").type("int").set_default(1048576).help("Maximal session buffer size in bytes. Default: %default");
+    parser.add_option("-P", "--polling").action("store_true").help("Run the service in polling loop mode");
+    parser.add_option("-S", "--spins").action("store").type("int").set_default(0).help("Adaptive polling spin budget in empty polls (0 - disabled). Default: %default");
+    parser.add_option("-Y", "--yields").action("store").type("int").set_default(0).help("Adaptive polling yield budget in thread yields (0 - disabled). Default: %default");
 
     optparse::Values options = parser.parse_args(argc, argv);
 
@@ -61,21 +80,43 @@ int main(int argc, char** argv)
         parser.exit();
     }
 
-    // Server port
+    // Server port, working threads, send size limit, buffer limits & service loop mode
     int port = options.get("port");
-
+    int threads = options.get("threads");
+    std::vector<int> affinity = Affinity::ParseCpuList(options["affinity"]);
+    int numa = options.get("numa");
+    int limit = options.get("limit");
+    int buffer_min = options.get("buffer_min");
+    int buffer_max = options.get("buffer_max");
+    bool polling = options.get("polling");
+    int spins = options.get("spins");
+    int yields = options.get("yields");
+
+    std::cout << "Asio backend: " << Service::backend() << std::endl;
     std::cout << "Server port: " << port << std::endl;
+    std::cout << "Working threads: " << threads << std::endl;
+    std::cout << "CPU affinity: " << (affinity.empty() ? "not pinned" : options["affinity"]) << std::endl;
+    std::cout << "NUMA node: " << numa << std::endl;
+    std::cout << "Send size limit: " << limit << std::endl;
+    std::cout << "Buffer limits: " << buffer_min << " - " << buffer_max << std::endl;
+    std::cout << "Polling loop mode: " << (polling ? "true" : "false") << std::endl;
+    std::cout << "Adaptive polling budgets: " << spins << " spins, " << yields << " yields" << std::endl;
 
     // Create a new Asio service
     auto service = std::make_shared<Service>();
+    service->SetupCpuAffinity(affinity);
+    service->SetupNumaNode(numa);
+    service->SetupAdaptivePolling(spins, yields);
 
     // Start the service
     std::cout << "Asio service starting...";
-    service->Start();
+    service->Start(polling, threads);
     std::cout << "Done!" << std::endl;
 
     // Create a new echo server
     auto server = std::make_shared<EchoServer>(service, InternetProtocol::IPv4, port);
+    server->SetupSendSizeLimit(limit);
+    server->SetupBufferLimits(buffer_min, buffer_max);
 
     // Start the server
     std::cout << "Server starting...";
@@ -111,5 +152,18 @@ int main(int argc, char** argv)
     service->Stop();
     std::cout << "Done!" << std::endl;
 
+    std::cout << std::endl;
+
+    std::cout << "Total bytes sent: " << server->bytes_sent() << std::endl;
+    std::cout << "Send operations: " << total_sends << std::endl;
+    if (total_sends > 0)
+        std::cout << "Bytes per send operation: " << server->bytes_sent() / total_sends << std::endl;
+    if (polling)
+    {
+        std::cout << "Idle spins: " << service->idle_spins() << std::endl;
+        std::cout << "Idle yields: " << service->idle_yields() << std::endl;
+        std::cout << "Idle blocks: " << service->idle_blocks() << std::endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,205 @@
+//
+// Created by Ivan Shynkarenka on 24.03.2017
+//
+
+#include "benchmark/reporter_console.h"
+#include "server/asio/service.h"
+#include "server/asio/tcp_client.h"
+#include "server/asio/tcp_server.h"
+#include "system/cpu.h"
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../../modules/cpp-optparse/OptionParser.h"
+
+using namespace CppServer::Asio;
+
+std::atomic<uint64_t> total_errors(0);
+std::atomic<uint64_t> total_bytes(0);
+
+class ContentionSession;
+
+std::shared_ptr<ContentionSession> contention_session;
+
+class ContentionServer : public TCPServer<ContentionServer, ContentionSession>
+{
+public:
+    using TCPServer<ContentionServer, ContentionSession>::TCPServer;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Server caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class ContentionSession : public TCPSession<ContentionServer, ContentionSession>
+{
+public:
+    using TCPSession<ContentionServer, ContentionSession>::TCPSession;
+
+protected:
+    void onConnected() override
+    {
+        // Publish the session for producer threads
+        std::atomic_store(&contention_session, std::static_pointer_cast<ContentionSession>(shared_from_this()));
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Session caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class ContentionClient : public TCPClient
+{
+public:
+    using TCPClient::TCPClient;
+
+protected:
+    size_t onReceived(const void* buffer, size_t size) override
+    {
+        total_bytes += size;
+        return size;
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Client caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-h", "--help").help("Show help");
+    parser.add_option("-p", "--port").action("store").type("int").set_default(1111).help("Server port. Default: %default");
+    parser.add_option("-t", "--producers").action("store").type("int").set_default(CppCommon::CPU::LogicalCores()).help("Maximal count of producer threads per session. Default: %default");
+    parser.add_option("-m", "--messages").action("store").type("int").set_default(1000000).help("Count of messages to send in each round. Default: %default");
+    parser.add_option("-s", "--size").action("store").type("int").set_default(32).help("Single message size. Default: %default");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        parser.exit();
+    }
+
+    // Benchmark parameters
+    int port = options.get("port");
+    int producers_count = options.get("producers");
+    int messages_count = options.get("messages");
+    int message_size = options.get("size");
+
+    std::cout << "Server port: " << port << std::endl;
+    std::cout << "Producer threads: 1.." << producers_count << std::endl;
+    std::cout << "Messages per round: " << messages_count << std::endl;
+    std::cout << "Message size: " << message_size << std::endl;
+
+    // Create Asio services for the server and the client
+    auto server_service = std::make_shared<Service>();
+    auto client_service = std::make_shared<Service>();
+
+    // Start Asio services
+    std::cout << "Asio services starting...";
+    server_service->Start();
+    client_service->Start();
+    std::cout << "Done!" << std::endl;
+
+    // Create and start the server
+    auto server = std::make_shared<ContentionServer>(server_service, InternetProtocol::IPv4, port);
+    std::cout << "Server starting...";
+    server->Start();
+    while (!server->IsStarted())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Create and connect the client
+    auto client = std::make_shared<ContentionClient>(client_service, "127.0.0.1", port);
+    std::cout << "Client connecting...";
+    client->Connect();
+    while (!client->IsConnected() || (std::atomic_load(&contention_session) == nullptr))
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    auto session = std::atomic_load(&contention_session);
+    std::vector<uint8_t> message(message_size, 0);
+
+    // Send the same amount of data into the single session with 1..N producer threads
+    for (int producers = 1; producers <= producers_count; ++producers)
+    {
+        int messages = messages_count / producers;
+        uint64_t total = (uint64_t)messages * producers * message_size;
+        total_bytes = 0;
+
+        uint64_t timestamp_start = CppCommon::Timestamp::nano();
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < producers; ++i)
+        {
+            threads.push_back(std::thread([session, messages, &message]()
+            {
+                for (int j = 0; j < messages; ++j)
+                    session->Send(message.data(), message.size());
+            }));
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        uint64_t timestamp_queued = CppCommon::Timestamp::nano();
+
+        // Wait for receiving all messages
+        while (total_bytes < total)
+            CppCommon::Thread::Yield();
+
+        uint64_t timestamp_stop = CppCommon::Timestamp::nano();
+
+        std::cout << "Producers: " << producers
+                  << ", queue time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_queued - timestamp_start)
+                  << ", drain time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start)
+                  << ", send ops throughput: " << (uint64_t)messages * producers * 1000000000 / (timestamp_queued - timestamp_start) << " ops per second"
+                  << ", bytes throughput: " << total * 1000000000 / (timestamp_stop - timestamp_start) << " bytes per second" << std::endl;
+    }
+
+    std::cout << std::endl;
+
+    session.reset();
+    std::atomic_store(&contention_session, std::shared_ptr<ContentionSession>());
+
+    // Disconnect the client
+    std::cout << "Client disconnecting...";
+    client->Disconnect();
+    while (client->IsConnected())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Stop the server
+    std::cout << "Server stopping...";
+    server->Stop();
+    while (server->IsStarted())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Stop Asio services
+    std::cout << "Asio services stopping...";
+    client_service->Stop();
+    server_service->Stop();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << "Errors: " << total_errors << std::endl;
+
+    return 0;
+}
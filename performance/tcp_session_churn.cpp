@@ -0,0 +1,229 @@
+//
+// Created by Ivan Shynkarenka on 26.03.2017
+//
+
+#include "benchmark/reporter_console.h"
+#include "server/asio/service.h"
+#include "server/asio/tcp_client.h"
+#include "server/asio/tcp_server.h"
+#include "system/cpu.h"
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include "../../modules/cpp-optparse/OptionParser.h"
+
+using namespace CppServer::Asio;
+
+std::atomic<bool> running(true);
+
+std::atomic<uint64_t> total_errors(0);
+std::atomic<uint64_t> total_requests(0);
+std::atomic<uint64_t> total_sessions(0);
+
+class ChurnSession;
+
+class ChurnServer : public TCPServer<ChurnServer, ChurnSession>
+{
+public:
+    using TCPServer<ChurnServer, ChurnSession>::TCPServer;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Server caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class ChurnSession : public TCPSession<ChurnServer, ChurnSession>
+{
+public:
+    explicit ChurnSession(std::shared_ptr<TCPServer<ChurnServer, ChurnSession>> server, asio::ip::tcp::socket&& socket)
+        : TCPSession<ChurnServer, ChurnSession>(server, std::move(socket))
+    {
+        // Count created session objects
+        ++total_sessions;
+    }
+
+protected:
+    size_t onReceived(const void* buffer, size_t size) override
+    {
+        // Reply to the short-lived client request
+        Send(buffer, size);
+        return size;
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Session caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class ChurnClient : public TCPClient
+{
+public:
+    ChurnClient(std::shared_ptr<Service> service, const std::string& address, int port, const std::vector<uint8_t>& request)
+        : TCPClient(service, address, port),
+          _request(request)
+    {
+    }
+
+protected:
+    void onConnected() override
+    {
+        // Send a single request per connection
+        Send(_request.data(), _request.size());
+    }
+
+    void onDisconnected() override
+    {
+        // Reconnect the client until the round is finished
+        if (running)
+            Connect();
+    }
+
+    size_t onReceived(const void* buffer, size_t size) override
+    {
+        // Disconnect as soon as the whole response is received
+        if (bytes_received() >= _request.size())
+        {
+            ++total_requests;
+            Disconnect();
+        }
+        return size;
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Client caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+
+private:
+    std::vector<uint8_t> _request;
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-h", "--help").help("Show help");
+    parser.add_option("-p", "--port").action("store").type("int").set_default(1111).help("Server port. Default: %default");
+    parser.add_option("-t", "--threads").action("store").type("int").set_default(CppCommon::CPU::LogicalCores()).help("Count of working threads. Default: %default");
+    parser.add_option("-c", "--clients").action("store").type("int").set_default(100).help("Count of working clients. Default: %default");
+    parser.add_option("-s", "--size").action("store").type("int").set_default(32).help("Single request size. Default: %default");
+    parser.add_option("-o", "--pool").action("store").type("int").set_default(1000).help("Session pool size of the pooled round. Default: %default");
+    parser.add_option("-z", "--seconds").action("store").type("int").set_default(10).help("Count of seconds to benchmark each round. Default: %default");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        parser.exit();
+    }
+
+    // Benchmark parameters
+    int port = options.get("port");
+    int threads_count = options.get("threads");
+    int clients_count = options.get("clients");
+    int request_size = options.get("size");
+    int pool_size = options.get("pool");
+    int seconds_count = options.get("seconds");
+
+    std::cout << "Server port: " << port << std::endl;
+    std::cout << "Working threads: " << threads_count << std::endl;
+    std::cout << "Working clients: " << clients_count << std::endl;
+    std::cout << "Request size: " << request_size << std::endl;
+    std::cout << "Session pool: " << pool_size << std::endl;
+    std::cout << "Seconds to benchmarking: " << seconds_count << std::endl;
+
+    // Create Asio services for the server and clients
+    auto server_service = std::make_shared<Service>();
+    std::vector<std::shared_ptr<Service>> client_services;
+    for (int i = 0; i < threads_count; ++i)
+        client_services.emplace_back(std::make_shared<Service>());
+
+    // Start Asio services
+    std::cout << "Asio services starting...";
+    server_service->Start();
+    for (auto& service : client_services)
+        service->Start();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::vector<uint8_t> request(request_size, 0);
+
+    // Churn short-lived connections without and with the session pool
+    for (int pool : { 0, pool_size })
+    {
+        running = true;
+        total_requests = 0;
+        total_sessions = 0;
+
+        // Create and start the server
+        auto server = std::make_shared<ChurnServer>(server_service, InternetProtocol::IPv4, port);
+        server->SetupSessionPool(pool);
+        server->Start();
+        while (!server->IsStarted())
+            CppCommon::Thread::Yield();
+
+        // Create churn clients
+        std::vector<std::shared_ptr<ChurnClient>> clients;
+        for (int i = 0; i < clients_count; ++i)
+            clients.emplace_back(std::make_shared<ChurnClient>(client_services[i % client_services.size()], "127.0.0.1", port, request));
+
+        uint64_t timestamp_start = CppCommon::Timestamp::nano();
+
+        // Connect clients and wait for benchmarking
+        for (auto& client : clients)
+            client->Connect();
+        CppCommon::Thread::Sleep(seconds_count * 1000);
+
+        // Stop reconnecting clients
+        running = false;
+
+        uint64_t timestamp_stop = CppCommon::Timestamp::nano();
+        uint64_t requests = total_requests;
+        uint64_t sessions = total_sessions;
+
+        // Disconnect clients
+        for (auto& client : clients)
+        {
+            client->Disconnect();
+            while (client->IsConnected())
+                CppCommon::Thread::Yield();
+        }
+
+        // Stop the server
+        server->Stop();
+        while (server->IsStarted())
+            CppCommon::Thread::Yield();
+
+        std::cout << "Session pool: " << pool
+                  << ", total time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start)
+                  << ", connections: " << requests
+                  << ", created sessions: " << sessions
+                  << ", connections throughput: " << requests * 1000000000 / (timestamp_stop - timestamp_start) << " connections per second" << std::endl;
+    }
+
+    std::cout << std::endl;
+
+    // Stop Asio services
+    std::cout << "Asio services stopping...";
+    for (auto& service : client_services)
+        service->Stop();
+    server_service->Stop();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << "Errors: " << total_errors << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+//
+// Created by Ivan Shynkarenka on 18.03.2017
+//
+
+#include "benchmark/reporter_console.h"
+#include "server/asio/service.h"
+#include "server/asio/tcp_client.h"
+#include "server/asio/tcp_server.h"
+#include "threads/thread.h"
+#include "time/timestamp.h"
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include "../../modules/cpp-optparse/OptionParser.h"
+
+using namespace CppServer::Asio;
+
+int receive_delay = 0;
+
+uint64_t timestamp_start = 0;
+uint64_t timestamp_queued = 0;
+uint64_t timestamp_stop = 0;
+
+std::atomic<uint64_t> total_errors(0);
+std::atomic<uint64_t> total_bytes(0);
+
+class ThrottledSession;
+
+class ThrottledServer : public TCPServer<ThrottledServer, ThrottledSession>
+{
+public:
+    using TCPServer<ThrottledServer, ThrottledSession>::TCPServer;
+
+protected:
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Server caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class ThrottledSession : public TCPSession<ThrottledServer, ThrottledSession>
+{
+public:
+    using TCPSession<ThrottledServer, ThrottledSession>::TCPSession;
+
+protected:
+    size_t onReceived(const void* buffer, size_t size) override
+    {
+        timestamp_stop = CppCommon::Timestamp::nano();
+        total_bytes += size;
+
+        // Throttle the receiver to keep a large backlog in the sender
+        uint64_t finish = CppCommon::Timestamp::nano() + receive_delay * 1000;
+        while (CppCommon::Timestamp::nano() < finish)
+            CppCommon::Thread::Yield();
+
+        return size;
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Session caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+};
+
+class FloodClient : public TCPClient
+{
+public:
+    explicit FloodClient(std::shared_ptr<Service> service, const std::string& address, int port, int messages, int size)
+        : TCPClient(service, address, port),
+          _messages(messages),
+          _message(size, 0)
+    {
+    }
+
+protected:
+    void onConnected() override
+    {
+        timestamp_start = CppCommon::Timestamp::nano();
+
+        // Queue all messages at once to build a deep send backlog
+        for (int i = 0; i < _messages; ++i)
+            Send(_message.data(), _message.size());
+
+        timestamp_queued = CppCommon::Timestamp::nano();
+    }
+
+    void onError(int error, const std::string& category, const std::string& message) override
+    {
+        std::cout << "Client caught an error with code " << error << " and category '" << category << "': " << message << std::endl;
+        ++total_errors;
+    }
+
+private:
+    int _messages;
+    std::vector<uint8_t> _message;
+};
+
+int main(int argc, char** argv)
+{
+    auto parser = optparse::OptionParser().version("1.0.0.0");
+
+    parser.add_option("-h", "--help").help("Show help");
+    parser.add_option("-p", "--port").action("store").type("int").set_default(1111).help("Server port. Default: %default");
+    parser.add_option("-m", "--messages").action("store").type("int").set_default(1000000).help("Count of messages to send. Default: %default");
+    parser.add_option("-s", "--size").action("store").type("int").set_default(32).help("Single message size. Default: %default");
+    parser.add_option("-d", "--delay").action("store").type("int").set_default(100).help("Receiver delay per received chunk in microseconds. Default: %default");
+
+    optparse::Values options = parser.parse_args(argc, argv);
+
+    // Print help
+    if (options.get("help"))
+    {
+        parser.print_help();
+        parser.exit();
+    }
+
+    // Benchmark parameters
+    int port = options.get("port");
+    int messages_count = options.get("messages");
+    int message_size = options.get("size");
+    receive_delay = options.get("delay");
+
+    std::cout << "Server port: " << port << std::endl;
+    std::cout << "Messages to send: " << messages_count << std::endl;
+    std::cout << "Message size: " << message_size << std::endl;
+    std::cout << "Receiver delay: " << receive_delay << " us" << std::endl;
+
+    // Create Asio services for the sender and the throttled receiver
+    auto server_service = std::make_shared<Service>();
+    auto client_service = std::make_shared<Service>();
+
+    // Start Asio services
+    std::cout << "Asio services starting...";
+    server_service->Start();
+    client_service->Start();
+    std::cout << "Done!" << std::endl;
+
+    // Create and start the throttled server
+    auto server = std::make_shared<ThrottledServer>(server_service, InternetProtocol::IPv4, port);
+    std::cout << "Server starting...";
+    server->Start();
+    while (!server->IsStarted())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Create and connect the flood client
+    auto client = std::make_shared<FloodClient>(client_service, "127.0.0.1", port, messages_count, message_size);
+    std::cout << "Client connecting...";
+    client->Connect();
+    while (!client->IsConnected())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Wait for receiving all messages
+    std::cout << "Processing...";
+    uint64_t total = (uint64_t)messages_count * message_size;
+    while (total_bytes < total)
+        CppCommon::Thread::Sleep(100);
+    std::cout << "Done!" << std::endl;
+
+    // Disconnect the client
+    std::cout << "Client disconnecting...";
+    client->Disconnect();
+    while (client->IsConnected())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Stop the server
+    std::cout << "Server stopping...";
+    server->Stop();
+    while (server->IsStarted())
+        CppCommon::Thread::Yield();
+    std::cout << "Done!" << std::endl;
+
+    // Stop Asio services
+    std::cout << "Asio services stopping...";
+    client_service->Stop();
+    server_service->Stop();
+    std::cout << "Done!" << std::endl;
+
+    std::cout << std::endl;
+
+    std::cout << "Queue time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_queued - timestamp_start) << std::endl;
+    std::cout << "Drain time: " << CppBenchmark::ReporterConsole::GenerateTimePeriod(timestamp_stop - timestamp_start) << std::endl;
+    std::cout << "Total bytes: " << total_bytes << std::endl;
+    std::cout << "Bytes throughput: " << total_bytes * 1000000000 / (timestamp_stop - timestamp_start) << " bytes per second" << std::endl;
+    std::cout << "Errors: " << total_errors << std::endl;
+
+    return 0;
+}
@@ -6,6 +6,7 @@
 #include "server/asio/udp_server.h"
 
 #include <iostream>
+#include <vector>
 
 #include "../../modules/cpp-optparse/OptionParser.h"
 
@@ -35,6 +36,8 @@ int main(int argc, char** argv)
 
     parser.add_option("-h", "--help").help("Show help");
     parser.add_option("-p", "--port").action("store").type("int").set_default(2222).help("Server port. Default: %default");
+    parser.add_option("-a", "--affinity").action("store").set_default("").help("CPU list to pin working threads one per CPU (e.g. 0-3,8). Default: not pinned");
+    parser.add_option("-n", "--numa").action("store").type("int").set_default(-1).help("NUMA node to place working threads and their memory (-1 - not placed). Default: %default");
 
     optparse::Values options = parser.parse_args(argc, argv);
 
@@ -47,11 +50,18 @@ int main(int argc, char** argv)
 
     // Server port
     int port = options.get("port");
+    std::vector<int> affinity = Affinity::ParseCpuList(options["affinity"]);
+    int numa = options.get("numa");
 
+    std::cout << "Asio backend: " << Service::backend() << std::endl;
     std::cout << "Server port: " << port << std::endl;
+    std::cout << "CPU affinity: " << (affinity.empty() ? "not pinned" : options["affinity"]) << std::endl;
+    std::cout << "NUMA node: " << numa << std::endl;
 
     // Create a new Asio service
     auto service = std::make_shared<Service>();
+    service->SetupCpuAffinity(affinity);
+    service->SetupNumaNode(numa);
 
     // Start the service
     std::cout << "Asio service starting...";
@@ -0,0 +1,170 @@
+/*!
+    \file affinity.cpp
+    \brief Thread affinity and NUMA placement implementation
+    \author Ivan Shynkarenka
+    \date 30.03.2017
+    \copyright MIT License
+*/
+
+#include "server/asio/affinity.h"
+
+#include "errors/exceptions.h"
+#include "threads/thread.h"
+
+#include <bitset>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#undef Yield
+#endif
+
+namespace CppServer {
+namespace Asio {
+
+#if defined(__linux__)
+namespace {
+
+// Linux memory policy mode which prefers the given node and falls back to other nodes
+const int MPOL_PREFERRED_MODE = 1;
+
+std::string NumaNodePath(int node)
+{
+    return "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+}
+
+} // namespace
+#endif
+
+int Affinity::NumaNodes()
+{
+#if defined(__linux__)
+    int nodes = 0;
+    while (std::ifstream(NumaNodePath(nodes)).good())
+        ++nodes;
+    return (nodes > 0) ? nodes : 1;
+#elif defined(_WIN32) || defined(_WIN64)
+    ULONG highest;
+    if (!GetNumaHighestNodeNumber(&highest))
+        return 1;
+    return (int)highest + 1;
+#else
+    return 1;
+#endif
+}
+
+std::vector<int> Affinity::NumaNodeCpus(int node)
+{
+    if (node < 0)
+        return std::vector<int>();
+
+#if defined(__linux__)
+    std::ifstream stream(NumaNodePath(node));
+    if (stream.good())
+    {
+        std::string cpus;
+        std::getline(stream, cpus);
+        return ParseCpuList(cpus);
+    }
+#elif defined(_WIN32) || defined(_WIN64)
+    ULONGLONG mask;
+    if ((node <= 0xFF) && GetNumaNodeProcessorMask((UCHAR)node, &mask))
+    {
+        std::vector<int> result;
+        for (int cpu = 0; cpu < 64; ++cpu)
+            if (mask & (1ull << cpu))
+                result.push_back(cpu);
+        return result;
+    }
+#endif
+
+    // Without NUMA topology all CPUs belong to the single node
+    std::vector<int> result;
+    if (node == 0)
+        for (int cpu = 0; cpu < (int)std::thread::hardware_concurrency(); ++cpu)
+            result.push_back(cpu);
+    return result;
+}
+
+std::vector<int> Affinity::ParseCpuList(const std::string& cpus)
+{
+    std::vector<int> result;
+
+    std::istringstream stream(cpus);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        int first, last;
+        char dummy;
+        if (std::sscanf(item.c_str(), "%d-%d%c", &first, &last, &dummy) == 2)
+        {
+            if ((first < 0) || (last < first))
+                continue;
+            for (int cpu = first; cpu <= last; ++cpu)
+                result.push_back(cpu);
+        }
+        else if ((std::sscanf(item.c_str(), "%d%c", &first, &dummy) == 1) && (first >= 0))
+            result.push_back(first);
+    }
+
+    return result;
+}
+
+std::error_code Affinity::SetThreadAffinity(const std::vector<int>& cpus)
+{
+    if (cpus.empty())
+        return std::make_error_code(std::errc::invalid_argument);
+
+    std::bitset<64> affinity;
+    for (int cpu : cpus)
+    {
+        if ((cpu < 0) || (cpu >= (int)affinity.size()))
+            return std::make_error_code(std::errc::invalid_argument);
+        affinity.set(cpu);
+    }
+
+    try
+    {
+        CppCommon::Thread::SetAffinity(affinity);
+        return std::error_code();
+    }
+    catch (const CppCommon::SystemException& ex)
+    {
+        return std::error_code(ex.system_error(), std::system_category());
+    }
+}
+
+std::error_code Affinity::SetThreadNumaNode(int node)
+{
+    if (NumaNodeCpus(node).empty())
+        return std::make_error_code(std::errc::invalid_argument);
+
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    const size_t bits = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> mask((node / bits) + 1, 0);
+    mask[node / bits] |= 1ul << (node % bits);
+
+    // Kernel ignores the last bit of the node mask, so its size is passed with one extra bit
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED_MODE, mask.data(), mask.size() * bits + 1) != 0)
+    {
+        // Kernel without NUMA support has the only node
+        if ((errno == ENOSYS) && (node == 0))
+            return std::error_code();
+        return std::error_code(errno, std::system_category());
+    }
+    return std::error_code();
+#else
+    // Memory is placed by the first touch of the thread pinned to the node CPUs
+    return std::error_code();
+#endif
+}
+
+} // namespace Asio
+} // namespace CppServer
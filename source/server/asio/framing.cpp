@@ -0,0 +1,117 @@
+/*!
+    \file framing.cpp
+    \brief Message framing codecs implementation
+    \author Ivan Shynkarenka
+    \date 22.03.2017
+    \copyright MIT License
+*/
+
+#include "server/asio/framing.h"
+
+#include "errors/exceptions.h"
+
+#include <cassert>
+
+namespace CppServer {
+namespace Asio {
+
+const size_t LengthPrefixCodec::HEADER;
+
+FrameResult LengthPrefixCodec::Decode(const uint8_t* buffer, size_t size, Frame& frame) const
+{
+    // Check for the complete frame header
+    if (size < HEADER)
+        return FrameResult::Incomplete;
+
+    // Decode the payload size in network byte order
+    size_t payload = ((size_t)buffer[0] << 24) | ((size_t)buffer[1] << 16) | ((size_t)buffer[2] << 8) | (size_t)buffer[3];
+    if (payload > _limit)
+        return FrameResult::Invalid;
+
+    // Check for the complete frame payload
+    if (size < (HEADER + payload))
+        return FrameResult::Incomplete;
+
+    frame.data = buffer + HEADER;
+    frame.size = payload;
+    frame.total = HEADER + payload;
+    return FrameResult::Complete;
+}
+
+void LengthPrefixCodec::Encode(const void* buffer, size_t size, Buffer& output) const
+{
+    assert((size <= 0xFFFFFFFF) && "Message size should fit into the 32-bit frame header!");
+
+    // Encode the payload size in network byte order
+    uint8_t header[HEADER] = { (uint8_t)(size >> 24), (uint8_t)(size >> 16), (uint8_t)(size >> 8), (uint8_t)size };
+    output.insert(output.end(), header, header + HEADER);
+
+    // Append the payload
+    const uint8_t* bytes = (const uint8_t*)buffer;
+    output.insert(output.end(), bytes, bytes + size);
+}
+
+DelimiterCodec::DelimiterCodec(const std::string& delimiter, size_t limit)
+    : _delimiter(delimiter),
+      _limit(limit)
+{
+    assert(!_delimiter.empty() && "Frame delimiter should not be empty!");
+    if (_delimiter.empty())
+        throw CppCommon::ArgumentException("Frame delimiter should not be empty!");
+}
+
+void DelimiterCodec::SetupDelimiter(const std::string& delimiter)
+{
+    assert(!delimiter.empty() && "Frame delimiter should not be empty!");
+    if (delimiter.empty())
+        throw CppCommon::ArgumentException("Frame delimiter should not be empty!");
+
+    _delimiter = delimiter;
+}
+
+FrameResult DelimiterCodec::Decode(const uint8_t* buffer, size_t size, Frame& frame) const
+{
+    const uint8_t* delimiter = (const uint8_t*)_delimiter.data();
+    size_t length = _delimiter.size();
+
+    // Find the frame delimiter starting from its first byte
+    const uint8_t* current = buffer;
+    const uint8_t* end = buffer + size;
+    while ((size_t)(end - current) >= length)
+    {
+        current = (const uint8_t*)std::memchr(current, delimiter[0], (end - current) - length + 1);
+        if (current == nullptr)
+            break;
+
+        if (std::memcmp(current, delimiter, length) == 0)
+        {
+            size_t payload = current - buffer;
+            if (payload > _limit)
+                return FrameResult::Invalid;
+
+            frame.data = buffer;
+            frame.size = payload;
+            frame.total = payload + length;
+            return FrameResult::Complete;
+        }
+
+        ++current;
+    }
+
+    // Check for the frame size limit without the delimiter
+    if (size > (_limit + length))
+        return FrameResult::Invalid;
+
+    return FrameResult::Incomplete;
+}
+
+void DelimiterCodec::Encode(const void* buffer, size_t size, Buffer& output) const
+{
+    // Append the payload and the frame delimiter
+    const uint8_t* bytes = (const uint8_t*)buffer;
+    output.insert(output.end(), bytes, bytes + size);
+    output.insert(output.end(), _delimiter.begin(), _delimiter.end());
+}
+
+} // namespace Asio
+} // namespace CppServer
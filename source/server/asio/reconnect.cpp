@@ -0,0 +1,61 @@
+/*!
+    \file reconnect.cpp
+    \brief Reconnect policy implementation
+    \author Ivan Shynkarenka
+    \date 03.04.2017
+    \copyright MIT License
+*/
+
+#include "server/asio/reconnect.h"
+
+#include <algorithm>
+
+namespace CppServer {
+namespace Asio {
+
+ReconnectPolicy::ReconnectPolicy()
+    : _delay_min(std::chrono::steady_clock::duration::zero()),
+      _delay_max(std::chrono::steady_clock::duration::zero()),
+      _attempts(0),
+      _attempt(0),
+      _random(std::random_device()())
+{
+}
+
+void ReconnectPolicy::Setup(const std::chrono::steady_clock::duration& min, const std::chrono::steady_clock::duration& max, size_t attempts) noexcept
+{
+    _delay_min = min;
+    _delay_max = std::max(min, max);
+    _attempts = attempts;
+    _attempt = 0;
+}
+
+bool ReconnectPolicy::Next(std::chrono::steady_clock::duration& delay)
+{
+    if (!enabled())
+        return false;
+
+    // Stop reconnecting when the limit of attempts is reached
+    if ((_attempts > 0) && (_attempt >= _attempts))
+    {
+        Reset();
+        return false;
+    }
+
+    ++_attempt;
+
+    // Double the backoff with each attempt in a row up to the maximal delay
+    auto backoff = _delay_min;
+    for (size_t i = 1; (i < _attempt) && (backoff < _delay_max); ++i)
+        backoff *= 2;
+    backoff = std::min(backoff, _delay_max);
+
+    // Spread the delay between a half and the whole backoff
+    std::uniform_int_distribution<std::chrono::steady_clock::rep> jitter(backoff.count() - backoff.count() / 2, backoff.count());
+    delay = std::chrono::steady_clock::duration(jitter(_random));
+
+    return true;
+}
+
+} // namespace Asio
+} // namespace CppServer
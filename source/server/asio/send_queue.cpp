@@ -0,0 +1,376 @@
+/*!
+    \file send_queue.cpp
+    \brief Lock-free send queue implementation
+    \author Ivan Shynkarenka
+    \date 24.03.2017
+    \copyright MIT License
+*/
+
+#include "server/asio/send_queue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+namespace CppServer {
+namespace Asio {
+
+const size_t SendQueue::APPEND_CAPACITY;
+const size_t SendQueue::SPARES;
+const size_t SendQueue::CLOSED;
+const size_t SendFlush::MAX_SEGMENTS;
+const size_t SendFlush::COALESCE_SIZE;
+const size_t SendFlush::COALESCE_CAPACITY;
+
+SendQueue::SendQueue() : _head(&_stub), _tail(&_stub), _appenders(0), _retired(nullptr)
+{
+    for (auto& spare : _spares)
+        spare = nullptr;
+
+    _stub.next = nullptr;
+    _stub.data = nullptr;
+    _stub.size = 0;
+    _stub.capacity = 0;
+    _stub.reserved = CLOSED;
+    _stub.committed = 0;
+}
+
+SendQueue::~SendQueue()
+{
+    // Release all nodes left in the queue
+    SendNode* node;
+    while ((node = Dequeue()) != nullptr)
+        Free(node);
+
+    // Free all retired nodes
+    while (_retired != nullptr)
+    {
+        node = _retired;
+        _retired = node->next.load(std::memory_order_relaxed);
+        Free(node);
+    }
+
+    // Free all spare nodes
+    for (auto& spare : _spares)
+    {
+        node = spare.exchange(nullptr);
+        if (node != nullptr)
+            Free(node);
+    }
+}
+
+void SendQueue::Enqueue(const void* buffer, size_t size)
+{
+    size_t capacity = size;
+
+    // Append the data into the open head node if it has enough room. The
+    // appending producer is counted before the head is loaded, so the
+    // consumer does not reuse the node while the producer refers it.
+    _appenders.fetch_add(1);
+    SendNode* head = _head.load();
+    size_t reserved = head->reserved.load(std::memory_order_relaxed);
+    while (((reserved & CLOSED) == 0) && ((head->capacity - reserved) >= size))
+    {
+        if (head->reserved.compare_exchange_weak(reserved, reserved + size, std::memory_order_relaxed))
+        {
+            std::memcpy(reinterpret_cast<uint8_t*>(head + 1) + reserved, buffer, size);
+            head->committed.fetch_add(size, std::memory_order_release);
+            _appenders.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+    }
+
+    // Double the capacity of the node following the filled one
+    if ((reserved & CLOSED) == 0)
+        capacity = std::max(size, std::min(2 * head->capacity, APPEND_CAPACITY));
+
+    _appenders.fetch_sub(1, std::memory_order_release);
+
+    // Copy the data into the node placed together with it
+    SendNode* node = Acquire(capacity);
+    uint8_t* data = reinterpret_cast<uint8_t*>(node + 1);
+    std::memcpy(data, buffer, size);
+    node->data = data;
+    node->size = size;
+    node->reserved.store(size, std::memory_order_relaxed);
+    node->committed.store(size, std::memory_order_relaxed);
+
+    Push(node);
+}
+
+void SendQueue::Enqueue(std::shared_ptr<const Buffer> buffer)
+{
+    SendNode* node = Acquire(0);
+    node->data = buffer->data();
+    node->size = buffer->size();
+    node->shared = std::move(buffer);
+    node->reserved.store(CLOSED, std::memory_order_relaxed);
+
+    Push(node);
+}
+
+SendNode* SendQueue::Acquire(size_t capacity)
+{
+    // Reuse the first spare node which the data fits into. Smaller spare nodes are freed.
+    SendNode* node;
+    for (auto& spare : _spares)
+    {
+        if (spare.load(std::memory_order_relaxed) == nullptr)
+            continue;
+        node = spare.exchange(nullptr, std::memory_order_acquire);
+        if (node != nullptr)
+        {
+            if (node->capacity >= capacity)
+                return node;
+            Free(node);
+        }
+    }
+
+    // Round the data capacity up to the power of two, so spare nodes fit
+    // most of the following buffers of a similar size
+    size_t rounded = 64;
+    while (rounded < capacity)
+        rounded *= 2;
+
+    // Allocate the node together with its data
+    uint8_t* memory = new uint8_t[sizeof(SendNode) + rounded];
+    node = new (memory) SendNode();
+    node->capacity = rounded;
+    return node;
+}
+
+void SendQueue::Push(SendNode* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    SendNode* prev = _head.exchange(node);
+    prev->next.store(node, std::memory_order_release);
+}
+
+bool SendQueue::Close(SendNode* node)
+{
+    // Shared nodes are never open for appending
+    if (node->shared != nullptr)
+        return true;
+
+    size_t reserved = node->reserved.fetch_or(CLOSED, std::memory_order_relaxed) & ~CLOSED;
+    if (node->committed.load(std::memory_order_acquire) != reserved)
+        return false;
+
+    node->size = reserved;
+    return true;
+}
+
+SendNode* SendQueue::Dequeue()
+{
+    SendNode* tail = _tail;
+    SendNode* next = tail->next.load(std::memory_order_acquire);
+
+    // Skip the stub node
+    if (tail == &_stub)
+    {
+        if (next == nullptr)
+            return nullptr;
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr)
+    {
+        if (!Close(tail))
+            return nullptr;
+        _tail = next;
+        return tail;
+    }
+
+    // Some producer has exchanged the head but not yet linked its node
+    SendNode* head = _head.load(std::memory_order_acquire);
+    if (tail != head)
+        return nullptr;
+
+    // Close the last node and push the stub node back to dequeue it
+    if (!Close(tail))
+        return nullptr;
+    Push(&_stub);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+void SendQueue::Release(SendNode* node)
+{
+    assert((node != nullptr) && "Send queue node should not be equal to 'nullptr'!");
+
+    // Retire the released node, because producers could still refer it as
+    // the queue head they are appending into
+    node->shared.reset();
+    node->next.store(_retired, std::memory_order_relaxed);
+    _retired = node;
+
+    Reclaim();
+}
+
+void SendQueue::Reclaim()
+{
+    // Producers appending after the check load the head which is not retired
+    if ((_retired == nullptr) || (_appenders.load() != 0))
+        return;
+
+    while (_retired != nullptr)
+    {
+        SendNode* node = _retired;
+        _retired = node->next.load(std::memory_order_relaxed);
+        Recycle(node);
+    }
+}
+
+void SendQueue::Recycle(SendNode* node)
+{
+    // Keep the released node as a spare one. Older spare nodes are shifted
+    // to the next slots and the oldest one is freed if all slots are taken.
+    for (auto& spare : _spares)
+    {
+        node = spare.exchange(node, std::memory_order_acq_rel);
+        if (node == nullptr)
+            return;
+    }
+    Free(node);
+}
+
+void SendQueue::Free(SendNode* node)
+{
+    node->~SendNode();
+    delete[] (uint8_t*)node;
+}
+
+void SendFlush::Fetch(SendQueue& queue)
+{
+    // Remove completely sent nodes from the front of the flush list only when
+    // they take at least its half, so each node is moved once on average
+    if ((_index > 0) && ((_index * 2) >= _nodes.size()))
+    {
+        _nodes.erase(_nodes.begin(), _nodes.begin() + _index);
+        _index = 0;
+    }
+
+    SendNode* node;
+    while ((node = queue.Dequeue()) != nullptr)
+        _nodes.push_back(node);
+}
+
+SendBuffers SendFlush::Gather(size_t limit)
+{
+    // The coalesce buffer is never reallocated while segments refer to it
+    _buffers.clear();
+    _coalesce.clear();
+    _coalesce.reserve(COALESCE_CAPACITY);
+
+    size_t size = 0;
+    size_t run = 0;
+    bool coalescing = false;
+    for (size_t i = _index; i < _nodes.size(); ++i)
+    {
+        const SendNode* node = _nodes[i];
+        size_t offset = (i == _index) ? _offset : 0;
+        size_t chunk = node->size - offset;
+        if ((limit > 0) && (chunk > (limit - size)))
+            chunk = limit - size;
+
+        if (chunk < COALESCE_SIZE)
+        {
+            // Stop at the full coalesce buffer
+            if ((_coalesce.size() + chunk) > COALESCE_CAPACITY)
+                break;
+
+            // Start a new coalesced segment after the referred one
+            if (!coalescing)
+            {
+                if (_buffers.size() == MAX_SEGMENTS)
+                    break;
+                _buffers.emplace_back();
+                run = _coalesce.size();
+                coalescing = true;
+            }
+
+            // Copy the small segment at the end of the coalesced one
+            _coalesce.insert(_coalesce.end(), node->data + offset, node->data + offset + chunk);
+            _buffers.back() = asio::const_buffer(_coalesce.data() + run, _coalesce.size() - run);
+        }
+        else
+        {
+            if (_buffers.size() == MAX_SEGMENTS)
+                break;
+
+            // Refer the large segment without copying
+            _buffers.emplace_back(node->data + offset, chunk);
+            coalescing = false;
+        }
+
+        size += chunk;
+        if ((limit > 0) && (size == limit))
+            break;
+    }
+
+    return SendBuffers(_buffers);
+}
+
+void SendFlush::Consume(SendQueue& queue, size_t size)
+{
+    while (size > 0)
+    {
+        SendNode* node = _nodes[_index];
+        size_t remain = node->size - _offset;
+        if (size < remain)
+        {
+            _offset += size;
+            break;
+        }
+        size -= remain;
+
+        queue.Release(node);
+        _offset = 0;
+        ++_index;
+    }
+}
+
+size_t SendFlush::Clear(SendQueue& queue)
+{
+    size_t unsent = 0;
+    for (size_t i = _index; i < _nodes.size(); ++i)
+    {
+        unsent += _nodes[i]->size - ((i == _index) ? _offset : 0);
+        queue.Release(_nodes[i]);
+    }
+    SendNode* node;
+    while ((node = queue.Dequeue()) != nullptr)
+    {
+        unsent += node->size;
+        queue.Release(node);
+    }
+    _nodes.clear();
+    _index = 0;
+    _offset = 0;
+    return unsent;
+}
+
+void SendFlush::Shrink(size_t size)
+{
+    if ((_nodes.capacity() * sizeof(SendNode*)) > size)
+        _nodes.shrink_to_fit();
+    _buffers.clear();
+    if ((_buffers.capacity() * sizeof(asio::const_buffer)) > size)
+        _buffers.shrink_to_fit();
+    _coalesce.clear();
+    if (_coalesce.capacity() > size)
+        _coalesce.shrink_to_fit();
+}
+
+} // namespace Asio
+} // namespace CppServer
@@ -10,35 +10,92 @@
 
 #include "errors/fatal.h"
 
+#include <algorithm>
+
 namespace CppServer {
 namespace Asio {
 
 Service::Service()
     : _service(std::make_shared<asio::io_service>()),
-      _started(false)
+      _started(false),
+      _polling(false),
+      _adaptive_spins(0),
+      _adaptive_yields(0),
+      _idle_spins(0),
+      _idle_yields(0),
+      _idle_blocks(0),
+      _numa_node(-1),
+      _timers_base(std::chrono::steady_clock::now()),
+      _timers_resolution(std::chrono::milliseconds(1)),
+      _timers_ticking(false)
 {
     assert((_service != nullptr) && "ASIO service is invalid!");
     if (_service == nullptr)
         throw CppCommon::ArgumentException("ASIO service is invalid!");
+
+    _timers_tick = std::make_unique<asio::steady_timer>(*_service);
 }
 
 Service::Service(std::shared_ptr<asio::io_service> service)
     : _service(service),
-      _started(false)
+      _started(false),
+      _polling(false),
+      _adaptive_spins(0),
+      _adaptive_yields(0),
+      _idle_spins(0),
+      _idle_yields(0),
+      _idle_blocks(0),
+      _numa_node(-1),
+      _timers_base(std::chrono::steady_clock::now()),
+      _timers_resolution(std::chrono::milliseconds(1)),
+      _timers_ticking(false)
 {
     assert((_service != nullptr) && "ASIO service is invalid!");
     if (_service == nullptr)
         throw CppCommon::ArgumentException("ASIO service is invalid!");
 
+    _timers_tick = std::make_unique<asio::steady_timer>(*_service);
+
     _started = !service->stopped();
 }
 
-bool Service::Start(bool polling)
+std::string Service::backend()
+{
+    // Asio selects io_uring as the default backend since Asio 1.21.0 only
+#if defined(ASIO_HAS_IO_URING_AS_DEFAULT) && (ASIO_VERSION >= 102100)
+    return "io_uring";
+#elif defined(ASIO_HAS_IOCP)
+    return "iocp";
+#elif defined(ASIO_HAS_EPOLL)
+    return "epoll";
+#elif defined(ASIO_HAS_KQUEUE)
+    return "kqueue";
+#elif defined(ASIO_HAS_DEV_POLL)
+    return "/dev/poll";
+#else
+    return "select";
+#endif
+}
+
+bool Service::Start(bool polling, int threads)
 {
     assert(!IsStarted() && "Asio service is already started!");
     if (IsStarted())
         return false;
 
+    assert((threads > 0) && "Count of working threads should be greater than zero!");
+    if (threads <= 0)
+        return false;
+
+    // Prepare the stopped Asio service to run again
+    if (_service->stopped())
+        _service->reset();
+
+    // Reset adaptive polling counters
+    _idle_spins = 0;
+    _idle_yields = 0;
+    _idle_blocks = 0;
+
     // Post the started routine
     auto self(this->shared_from_this());
     _service->post([this, self]()
@@ -53,8 +110,20 @@ bool Service::Start(bool polling)
         onStarted();
     });
 
-    // Start the service thread
-    _thread = CppCommon::Thread::Start([this, polling]() { ServiceLoop(polling); });
+    // Pin working threads one per CPU of the affinity or to all CPUs of the NUMA node
+    std::vector<int> cpus = _cpu_affinity.empty() ? Affinity::NumaNodeCpus(_numa_node) : _cpu_affinity;
+
+    // Start the service working threads
+    _polling = polling;
+    for (int thread = 0; thread < threads; ++thread)
+    {
+        std::vector<int> thread_cpus;
+        if (!_cpu_affinity.empty())
+            thread_cpus.push_back(cpus[thread % cpus.size()]);
+        else
+            thread_cpus = cpus;
+        _threads.emplace_back(CppCommon::Thread::Start([this, polling, thread_cpus]() { ServiceLoop(polling, thread_cpus); }));
+    }
 
     return true;
 }
@@ -72,6 +141,18 @@ bool Service::Stop()
         if (!IsStarted())
             return;
 
+        // Cancel all scheduled handlers and stop turning the timer wheel
+        std::vector<TimerWheel::Handler> cleared;
+        {
+            std::lock_guard<std::mutex> locker(_timers_lock);
+            _timers.Clear(cleared);
+            _timers_tick->cancel();
+            _timers_ticking = false;
+        }
+
+        // Destroy cancelled handlers outside of the timers lock, so they could schedule or cancel timers
+        cleared.clear();
+
         // Stop the Asio service
         _service->stop();
 
@@ -82,22 +163,133 @@ bool Service::Stop()
         onStopped();
     });
 
-    // Wait for service thread
-    _thread.join();
+    // Wait for all service working threads
+    for (auto& thread : _threads)
+        thread.join();
+    _threads.clear();
 
     return true;
 }
 
 bool Service::Restart()
 {
+    bool polling = _polling;
+    int threads = (int)_threads.size();
+
     if (!Stop())
         return false;
 
-    return Start();
+    return Start(polling, threads);
+}
+
+void Service::SetupTimerResolution(const std::chrono::steady_clock::duration& resolution)
+{
+    assert((resolution.count() > 0) && "Timer resolution should be greater than zero!");
+    if (resolution.count() <= 0)
+        return;
+
+    std::lock_guard<std::mutex> locker(_timers_lock);
+
+    // Keep the current tick of the timer wheel at the current time
+    _timers_base = std::chrono::steady_clock::now() - resolution * _timers.now();
+    _timers_resolution = resolution;
+}
+
+TimerId Service::Schedule(const std::chrono::steady_clock::duration& delay, TimerWheel::Handler handler)
+{
+    assert((handler != nullptr) && "Scheduled handler should not be empty!");
+    if (handler == nullptr)
+        return 0;
+
+    auto now = std::chrono::steady_clock::now();
+    auto expires = now + std::max(delay, std::chrono::steady_clock::duration::zero());
+
+    std::lock_guard<std::mutex> locker(_timers_lock);
+
+    // Catch up the timer wheel which is not turned while no timers are armed
+    if (!_timers_ticking)
+    {
+        std::vector<TimerWheel::Handler> expired;
+        uint64_t current = TimerTick(now);
+        if (current > _timers.now())
+            _timers.Advance(current - _timers.now(), expired);
+    }
+
+    // Round the expiration time up to the next tick, so the handler is never called too early
+    uint64_t tick = TimerTick(expires - std::chrono::steady_clock::duration(1)) + 1;
+    uint64_t ticks = (tick > _timers.now()) ? (tick - _timers.now()) : 0;
+    TimerId id = _timers.Schedule(ticks, std::move(handler));
+
+    // Start turning the timer wheel
+    if (!_timers_ticking)
+    {
+        _timers_ticking = true;
+        WaitTimers();
+    }
+
+    return id;
+}
+
+bool Service::Cancel(TimerId id)
+{
+    std::lock_guard<std::mutex> locker(_timers_lock);
+
+    return _timers.Cancel(id);
+}
+
+uint64_t Service::TimerTick(const std::chrono::steady_clock::time_point& time) const noexcept
+{
+    return (time > _timers_base) ? (uint64_t)((time - _timers_base) / _timers_resolution) : 0;
+}
+
+void Service::WaitTimers()
+{
+    // Wait for the current tick of the timer wheel. The service is not kept
+    // alive by the waiting timer, so the stopped service could be destroyed.
+    std::weak_ptr<Service> weak(this->shared_from_this());
+    _timers_tick->expires_at(_timers_base + _timers_resolution * _timers.now());
+    _timers_tick->async_wait([weak](std::error_code ec)
+    {
+        // Skip the wait cancelled by the stopped service or by the next wait,
+        // otherwise it would cancel the current wait of the timer wheel
+        if (ec == asio::error::operation_aborted)
+            return;
+
+        auto self = weak.lock();
+        if (self)
+            self->ExpireTimers();
+    });
+}
+
+void Service::ExpireTimers()
+{
+    std::vector<TimerWheel::Handler> expired;
+
+    {
+        std::lock_guard<std::mutex> locker(_timers_lock);
+
+        // Turn the timer wheel up to the current tick inclusive
+        uint64_t current = TimerTick(std::chrono::steady_clock::now());
+        if (current >= _timers.now())
+            _timers.Advance(current - _timers.now() + 1, expired);
+
+        // Wait for the next tick or stop turning the empty timer wheel
+        if (_timers.empty())
+            _timers_ticking = false;
+        else
+            WaitTimers();
+    }
+
+    // Call expired handlers outside of the timers lock, so they could schedule new timers
+    for (auto& handler : expired)
+        handler();
 }
 
-void Service::ServiceLoop(bool polling)
+void Service::ServiceLoop(bool polling, const std::vector<int>& cpus)
 {
+    // Pin the working thread before it allocates any memory
+    PinThread(cpus);
+
     // Call the initialize thread handler
     onThreadInitialize();
 
@@ -105,13 +297,24 @@ void Service::ServiceLoop(bool polling)
     {
         asio::io_service::work work(*_service);
 
+        // Adaptive polling loop state
+        bool adaptive = polling && ((_adaptive_spins > 0) || (_adaptive_yields > 0));
+        size_t idle = 0;
+        uint64_t spins = 0;
+        uint64_t yields = 0;
+
         // Service loop...
         do
         {
             // ...with handling some specific Asio errors
             try
             {
-                if (polling)
+                if (adaptive)
+                {
+                    // Poll pending handlers and wait adaptively when there are no ones
+                    AdaptivePoll(idle, spins, yields);
+                }
+                else if (polling)
                 {
                     // Poll all pending handlers
                     _service->poll();
@@ -137,6 +340,10 @@ void Service::ServiceLoop(bool polling)
                 throw;
             }
         } while (_started);
+
+        // Update adaptive polling counters with the last idle period
+        if (adaptive)
+            UpdateIdleCounters(spins, yields, 0);
     }
     catch (asio::system_error& ex)
     {
@@ -155,6 +362,68 @@ void Service::ServiceLoop(bool polling)
     onThreadCleanup();
 }
 
+void Service::PinThread(const std::vector<int>& cpus)
+{
+    if (!cpus.empty())
+    {
+        std::error_code ec = Affinity::SetThreadAffinity(cpus);
+        if (ec)
+            SendError(ec);
+    }
+
+    if (_numa_node >= 0)
+    {
+        std::error_code ec = Affinity::SetThreadNumaNode(_numa_node);
+        if (ec)
+            SendError(ec);
+    }
+}
+
+void Service::AdaptivePoll(size_t& idle, uint64_t& spins, uint64_t& yields)
+{
+    // Poll all pending handlers and start idle phases over if some were executed
+    if (_service->poll() > 0)
+    {
+        if (idle > 0)
+            UpdateIdleCounters(spins, yields, 0);
+        idle = 0;
+        return;
+    }
+
+    ++idle;
+
+    // Spin phase: poll again immediately
+    if (idle <= _adaptive_spins)
+    {
+        ++spins;
+        return;
+    }
+
+    // Yield phase: call the idle handler which yields the working thread by default
+    if (idle <= (_adaptive_spins + _adaptive_yields))
+    {
+        ++yields;
+        onIdle();
+        return;
+    }
+
+    UpdateIdleCounters(spins, yields, 1);
+    idle = 0;
+
+    // Block phase: wait for the next handler and execute it
+    _service->run_one();
+}
+
+void Service::UpdateIdleCounters(uint64_t& spins, uint64_t& yields, uint64_t blocks)
+{
+    // Shared counters are updated once per idle period, so spinning threads do not contend on them
+    _idle_spins.fetch_add(spins, std::memory_order_relaxed);
+    _idle_yields.fetch_add(yields, std::memory_order_relaxed);
+    _idle_blocks.fetch_add(blocks, std::memory_order_relaxed);
+    spins = 0;
+    yields = 0;
+}
+
 void Service::SendError(std::error_code ec)
 {
     onError(ec.value(), ec.category().name(), ec.message());
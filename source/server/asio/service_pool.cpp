@@ -0,0 +1,106 @@
+/*!
+    \file service_pool.cpp
+    \brief Asio service pool implementation
+    \author Ivan Shynkarenka
+    \date 20.03.2017
+    \copyright MIT License
+*/
+
+#include "server/asio/service_pool.h"
+
+namespace CppServer {
+namespace Asio {
+
+ServicePool::ServicePool(int services)
+    : _round_robin_index(0),
+      _numa_node(-1)
+{
+    assert((services > 0) && "Count of services in the pool should be greater than zero!");
+    if (services <= 0)
+        throw CppCommon::ArgumentException("Count of services in the pool should be greater than zero!");
+
+    for (int i = 0; i < services; ++i)
+        _services.emplace_back(std::make_shared<Service>());
+}
+
+ServicePool::ServicePool(const std::vector<std::shared_ptr<Service>>& services)
+    : _services(services),
+      _round_robin_index(0),
+      _numa_node(-1)
+{
+    assert(!_services.empty() && "Service pool should contain at least one service!");
+    if (_services.empty())
+        throw CppCommon::ArgumentException("Service pool should contain at least one service!");
+
+    for (auto& service : _services)
+    {
+        assert((service != nullptr) && "ASIO service is invalid!");
+        if (service == nullptr)
+            throw CppCommon::ArgumentException("ASIO service is invalid!");
+    }
+}
+
+bool ServicePool::IsStarted() const noexcept
+{
+    for (auto& service : _services)
+        if (!service->IsStarted())
+            return false;
+
+    return true;
+}
+
+bool ServicePool::Start(bool polling)
+{
+    bool result = true;
+
+    // Place services one per CPU of the affinity or of the NUMA node
+    std::vector<int> cpus = _cpu_affinity.empty() ? Affinity::NumaNodeCpus(_numa_node) : _cpu_affinity;
+    for (size_t i = 0; i < _services.size(); ++i)
+    {
+        if (_services[i]->IsStarted())
+            continue;
+        if (!cpus.empty())
+            _services[i]->SetupCpuAffinity({ cpus[i % cpus.size()] });
+        if (_numa_node >= 0)
+            _services[i]->SetupNumaNode(_numa_node);
+    }
+
+    // Start all services with a single working thread
+    for (auto& service : _services)
+        if (!service->IsStarted())
+            result &= service->Start(polling, 1);
+
+    return result;
+}
+
+bool ServicePool::Stop()
+{
+    bool result = true;
+
+    // Stop all started services
+    for (auto& service : _services)
+        if (service->IsStarted())
+            result &= service->Stop();
+
+    return result;
+}
+
+bool ServicePool::Restart()
+{
+    bool result = true;
+
+    // Restart all services
+    for (auto& service : _services)
+        result &= service->Restart();
+
+    return result;
+}
+
+std::shared_ptr<Service>& ServicePool::GetNextService() noexcept
+{
+    size_t index = _round_robin_index++;
+    return _services[index % _services.size()];
+}
+
+} // namespace Asio
+} // namespace CppServer
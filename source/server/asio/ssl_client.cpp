@@ -7,8 +7,9 @@
 */
 
 #include "server/asio/ssl_client.h"
+#include "server/asio/memory.h"
+#include "server/asio/send_queue.h"
 
-#include <mutex>
 #include <vector>
 
 namespace CppServer {
@@ -19,20 +20,38 @@ namespace Asio {
 class SSLClient::Impl : public std::enable_shared_from_this<SSLClient::Impl>
 {
 public:
-    Impl(const CppCommon::UUID& id, std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, const std::string& address, int port)
-        : _id(id),
-          _service(service),
+    Impl(std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, const std::string& address, int port)
+        : _service(service),
           _context(context),
           _endpoint(asio::ip::tcp::endpoint(asio::ip::address::from_string(address), port)),
           _stream(*_service->service(), *_context),
+          _strand(*_service->service()),
+          _strand_required(false),
           _connecting(false),
           _connected(false),
           _handshaking(false),
           _handshaked(false),
+          _send_size_limit(0),
+          _buffer_min(4096),
+          _buffer_max(1048576),
+          _send_buffer_high(0),
+          _send_buffer_low(0),
+          _receive_pause(false),
           _bytes_sent(0),
           _bytes_received(0),
           _reciving(false),
-          _sending(false)
+          _recive_buffer_offset(0),
+          _recive_buffer_size(0),
+          _recive_size(0),
+          _sending(false),
+          _send_pending(0),
+          _send_scheduled(false),
+          _send_full(false),
+          _send_full_notified(false),
+          _recive_async(false),
+          _connect_awaiter(nullptr),
+          _recive_awaiter(nullptr),
+          _send_awaiter(nullptr)
     {
         assert((service != nullptr) && "ASIO service is invalid!");
         if (service == nullptr)
@@ -43,20 +62,38 @@ public:
             throw CppCommon::ArgumentException("SSL context is invalid!");
     }
 
-    Impl(const CppCommon::UUID& id, std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, const asio::ip::tcp::endpoint& endpoint)
-        : _id(id),
-          _service(service),
+    Impl(std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, const asio::ip::tcp::endpoint& endpoint)
+        : _service(service),
           _context(context),
           _endpoint(endpoint),
           _stream(*_service->service(), *_context),
+          _strand(*_service->service()),
+          _strand_required(false),
           _connecting(false),
           _connected(false),
           _handshaking(false),
           _handshaked(false),
+          _send_size_limit(0),
+          _buffer_min(4096),
+          _buffer_max(1048576),
+          _send_buffer_high(0),
+          _send_buffer_low(0),
+          _receive_pause(false),
           _bytes_sent(0),
           _bytes_received(0),
           _reciving(false),
-          _sending(false)
+          _recive_buffer_offset(0),
+          _recive_buffer_size(0),
+          _recive_size(0),
+          _sending(false),
+          _send_pending(0),
+          _send_scheduled(false),
+          _send_full(false),
+          _send_full_notified(false),
+          _recive_async(false),
+          _connect_awaiter(nullptr),
+          _recive_awaiter(nullptr),
+          _send_awaiter(nullptr)
     {
         assert((service != nullptr) && "ASIO service is invalid!");
         if (service == nullptr)
@@ -69,42 +106,56 @@ public:
 
     Impl(const Impl&) = delete;
     Impl(Impl&&) = default;
-    ~Impl() = default;
+    ~Impl() { ClearBuffers(); }
 
     Impl& operator=(const Impl&) = delete;
     Impl& operator=(Impl&&) = default;
 
-    const CppCommon::UUID& id() const noexcept { return _id; }
-
     std::shared_ptr<Service>& service() noexcept { return _service; }
     std::shared_ptr<asio::ssl::context>& context() noexcept { return _context; }
     asio::ip::tcp::endpoint& endpoint() noexcept { return _endpoint; }
     asio::ssl::stream<asio::ip::tcp::socket>& stream() noexcept { return _stream; }
     asio::ssl::stream<asio::ip::tcp::socket>::lowest_layer_type& socket() noexcept { return _stream.lowest_layer(); }
 
-    uint64_t& bytes_sent() noexcept { return _bytes_sent; }
-    uint64_t& bytes_received() noexcept { return _bytes_received; }
+    std::atomic<uint64_t>& bytes_sent() noexcept { return _bytes_sent; }
+    std::atomic<uint64_t>& bytes_received() noexcept { return _bytes_received; }
+    std::atomic<size_t>& bytes_pending() noexcept { return _send_pending; }
+
+    size_t& send_size_limit() noexcept { return _send_size_limit; }
+    size_t& buffer_min() noexcept { return _buffer_min; }
+    size_t& buffer_max() noexcept { return _buffer_max; }
+    size_t& send_buffer_high() noexcept { return _send_buffer_high; }
+    size_t& send_buffer_low() noexcept { return _send_buffer_low; }
+    bool& receive_pause() noexcept { return _receive_pause; }
 
     bool IsConnected() const noexcept { return _connected; }
     bool IsHandshaked() const noexcept { return _handshaked; }
 
-    bool Connect(std::shared_ptr<SSLClient>& client)
+    bool Connect(std::shared_ptr<SSLClient>& client, AsyncAwaiter* awaiter = nullptr)
     {
         _client = client;
 
         if (IsConnected() || IsHandshaked() || _connecting || _handshaking)
             return false;
 
-        // Post the connect routine
+        // Client handlers of the multi-threaded service are serialized by the client strand
+        _strand_required = (_service->threads() > 1);
+
         auto self(this->shared_from_this());
-        _service->service()->post([this, self]()
+        auto connect = [this, self, awaiter]()
         {
             if (IsConnected() || IsHandshaked() || _connecting || _handshaking)
+            {
+                // Resume the coroutine awaiting the client handshake
+                if (awaiter != nullptr)
+                    awaiter->Complete(IsHandshaked() ? 1 : 0);
                 return;
+            }
 
-            // Connect the client socket
-            _connecting = true;
-            socket().async_connect(_endpoint, [this, self](std::error_code ec)
+            // Register the connect awaiter in the IO thread
+            _connect_awaiter = awaiter;
+
+            auto async_connect_handler = [this, self](std::error_code ec)
             {
                 _connecting = false;
 
@@ -117,6 +168,14 @@ public:
                     _bytes_sent = 0;
                     _bytes_received = 0;
 
+                    // Reset the adaptive receive size
+                    _recive_size = _buffer_min;
+
+                    // Drop the data left by producers racing the previous disconnect
+                    ClearBuffers();
+                    _send_pending = 0;
+                    _send_scheduled = false;
+
                     // Update the connected flag
                     _connected = true;
 
@@ -124,44 +183,39 @@ public:
                     onConnected();
 
                     // Perform SSL handshake
-                    _handshaking = true;
-                    _stream.async_handshake(asio::ssl::stream_base::client, [this, self](std::error_code ec)
-                    {
-                        _handshaking = false;
-
-                        if (IsHandshaked() || _handshaking)
-                            return;
-
-                        if (!ec)
-                        {
-                            // Update the handshaked flag
-                            _handshaked = true;
-
-                            // Call the client handshaked handler
-                            onHandshaked();
-
-                            // Call the empty send buffer handler
-                            onEmpty();
-
-                            // Try to receive something from the server
-                            TryReceive();
-                        }
-                        else
-                        {
-                            // Disconnect on in case of the bad handshake
-                            SendError(ec);
-                            Disconnect(true);
-                        }
-                    });
+                    Handshake();
                 }
                 else
                 {
+                    // Close the client socket to connect it again
+                    asio::error_code ignore;
+                    socket().close(ignore);
+
                     // Call the client disconnected handler
                     SendError(ec);
                     onDisconnected();
+
+                    // Resume the coroutine awaiting the client handshake
+                    CompleteConnectAsync(false);
+
+                    // Try to connect the client again
+                    _client->ScheduleReconnect();
                 }
-            });
-        });
+            };
+
+            // Connect the client socket
+            _connecting = true;
+            if (_strand_required)
+                socket().async_connect(_endpoint, _strand.wrap(async_connect_handler));
+            else
+                socket().async_connect(_endpoint, async_connect_handler);
+        };
+
+        // Post the connect routine
+        if (_strand_required)
+            _strand.post(connect);
+        else
+            _service->Post(connect);
 
         return true;
     }
@@ -194,13 +248,61 @@ public:
 
             // Call the client disconnected handler
             onDisconnected();
+
+            // Resume coroutines awaiting the disconnected client
+            CompleteAsync();
+
+            // Try to connect the client again
+            _client->ScheduleReconnect();
         };
 
         // Dispatch or post the disconnect routine
-        if (dispatch)
-            _service->Dispatch(disconnect);
+        if (_strand_required)
+        {
+            if (dispatch)
+                _strand.dispatch(disconnect);
+            else
+                _strand.post(disconnect);
+        }
         else
-            _service->Post(disconnect);
+        {
+            if (dispatch)
+                _service->Dispatch(disconnect);
+            else
+                _service->Post(disconnect);
+        }
+
+        return true;
+    }
+
+    bool Reconnect(std::shared_ptr<SSLClient>& client)
+    {
+        if (!IsConnected() || _connecting || _handshaking)
+            return false;
+
+        client->_reconnect = true;
+
+        auto self(this->shared_from_this());
+        auto reconnect = [this, self, client]()
+        {
+            // Disconnect the client without scheduling automatic reconnect
+            bool reconnect = client->_reconnect.exchange(false);
+            Disconnect(true);
+
+            // Connect the client again by its reset implementation unless it was disconnected after the reconnect request
+            if (reconnect)
+            {
+                auto reconnected(client);
+                client->_reconnect = true;
+                client->_pimpl->Connect(reconnected);
+            }
+        };
+
+        // Post the reconnect routine
+        if (_strand_required)
+            _strand.post(reconnect);
+        else
+            _service->Post(reconnect);
 
         return true;
     }
@@ -215,23 +317,141 @@ public:
         if (!IsHandshaked())
             return 0;
 
+        // Reject data while the send buffer is full
+        if (_send_full)
+            return 0;
+
+        // Account the pending size before the data is enqueued, so the send
+        // routine never observes enqueued data which is not yet pending
+        size_t pending = (_send_pending += size);
+
+        // Enqueue a copy of the buffer into the lock-free send queue
+        _send_queue.Enqueue(buffer, size);
+
+        // Mark the send buffer as full when it reaches the high watermark
+        size_t high = _send_buffer_high;
+        bool full = (high > 0) && (pending >= high) && !_send_full.exchange(true);
+
+        // Dispatch the send routine unless it is already scheduled or when the
+        // send buffer became full. Otherwise the enqueued data is picked up by
+        // the scheduled send routine.
+        bool schedule = !_send_scheduled.exchange(true);
+        if (schedule || full)
         {
-            std::lock_guard<std::mutex> locker(_send_lock);
+            auto self(this->shared_from_this());
+            auto send = [this, self]()
+            {
+                // Update the send buffer state
+                UpdateSendBuffer(_send_pending);
 
-            // Fill the send buffer
-            const uint8_t* bytes = (const uint8_t*)buffer;
-            _send_cache.insert(_send_cache.end(), bytes, bytes + size);
+                // Try to send the buffer
+                TrySend();
+            };
+
+            if (_strand_required)
+                _strand.dispatch(send);
+            else
+                _service->Dispatch(send);
         }
 
-        // Dispatch the send routine
-        auto self(this->shared_from_this());
-        _service->Dispatch([this, self]()
+        return pending;
+    }
+
+    size_t Send(std::shared_ptr<const Buffer> buffer)
+    {
+        assert((buffer != nullptr) && "Shared buffer should not be equal to 'nullptr'!");
+        if ((buffer == nullptr) || buffer->empty())
+            return 0;
+
+        if (!IsHandshaked())
+            return 0;
+
+        // Reject data while the send buffer is full
+        if (_send_full)
+            return 0;
+
+        // Account the pending size before the data is enqueued, so the send
+        // routine never observes enqueued data which is not yet pending
+        size_t size = buffer->size();
+        size_t pending = (_send_pending += size);
+
+        // Enqueue the shared buffer reference without copying its content
+        _send_queue.Enqueue(std::move(buffer));
+
+        // Mark the send buffer as full when it reaches the high watermark
+        size_t high = _send_buffer_high;
+        bool full = (high > 0) && (pending >= high) && !_send_full.exchange(true);
+
+        // Dispatch the send routine unless it is already scheduled or when the
+        // send buffer became full. Otherwise the enqueued data is picked up by
+        // the scheduled send routine.
+        bool schedule = !_send_scheduled.exchange(true);
+        if (schedule || full)
         {
-            // Try to send the buffer
-            TrySend();
-        });
+            auto self(this->shared_from_this());
+            auto send = [this, self]()
+            {
+                // Update the send buffer state
+                UpdateSendBuffer(_send_pending);
 
-        return _send_cache.size();
+                // Try to send the buffer
+                TrySend();
+            };
+
+            if (_strand_required)
+                _strand.dispatch(send);
+            else
+                _service->Dispatch(send);
+        }
+
+        return pending;
+    }
+
+    bool StartConnectAsync(std::shared_ptr<SSLClient>& client, AsyncAwaiter& awaiter)
+    {
+        // Complete at once if the client is already handshaked
+        awaiter.result = IsHandshaked() ? 1 : 0;
+        return Connect(client, &awaiter);
+    }
+
+    bool StartReceiveAsync(AsyncAwaiter& awaiter)
+    {
+        assert((!_strand_required || _strand.running_in_this_thread()) && "Client operations should be awaited in the client strand!");
+        assert((_recive_awaiter == nullptr) && "Only one receive operation of the client could be awaited at once!");
+
+        awaiter.result = 0;
+
+        if (!IsHandshaked())
+            return false;
+
+        // Complete at once with unread data of the receive buffer
+        awaiter.result = ReadBuffer(awaiter.buffer, awaiter.size);
+        if (awaiter.result > 0)
+            return false;
+
+        // Register the awaiter and receive the next chunk of data
+        _recive_async = true;
+        _recive_awaiter = &awaiter;
+        TryReceive();
+        return true;
+    }
+
+    bool StartSendAsync(AsyncAwaiter& awaiter)
+    {
+        assert((!_strand_required || _strand.running_in_this_thread()) && "Client operations should be awaited in the client strand!");
+        assert((_send_awaiter == nullptr) && "Only one send operation of the client could be awaited at once!");
+
+        awaiter.result = 0;
+
+        // Complete at once if the data was not sent
+        size_t pending = Send(awaiter.buffer, awaiter.size);
+        if (pending == 0)
+            return false;
+
+        // Register the awaiter until all pending data is sent
+        awaiter.target = _bytes_sent + pending;
+        _send_awaiter = &awaiter;
+        return true;
     }
 
 protected:
@@ -242,13 +462,11 @@ protected:
     size_t onReceived(const void* buffer, size_t size) { return _client->onReceived(buffer, size); }
     void onSent(size_t sent, size_t pending) { _client->onSent(sent, pending); }
     void onEmpty() { _client->onEmpty(); }
+    void onSendBufferFull() { _client->onSendBufferFull(); }
+    void onSendBufferDrained() { _client->onSendBufferDrained(); }
     void onError(int error, const std::string& category, const std::string& message) { _client->onError(error, category, message); }
 
 private:
-    static const size_t CHUNK = 8192;
-
-    // Client Id
-    CppCommon::UUID _id;
     // SSL client
     std::shared_ptr<SSLClient> _client;
     // Asio service
@@ -257,22 +475,89 @@ private:
     std::shared_ptr<asio::ssl::context> _context;
     asio::ip::tcp::endpoint _endpoint;
     asio::ssl::stream<asio::ip::tcp::socket> _stream;
+    asio::io_service::strand _strand;
+    bool _strand_required;
     std::atomic<bool> _connecting;
     std::atomic<bool> _connected;
     std::atomic<bool> _handshaking;
     std::atomic<bool> _handshaked;
-    // Client statistic
-    uint64_t _bytes_sent;
-    uint64_t _bytes_received;
-    // Receive buffer & cache
+    // Client options
+    size_t _send_size_limit;
+    size_t _buffer_min;
+    size_t _buffer_max;
+    size_t _send_buffer_high;
+    size_t _send_buffer_low;
+    bool _receive_pause;
+    // Client statistic (read from other threads)
+    std::atomic<uint64_t> _bytes_sent;
+    std::atomic<uint64_t> _bytes_received;
+    // Receive buffer
     bool _reciving;
-    uint8_t _recive_buffer[CHUNK];
-    std::vector<uint8_t> _recive_cache;
-    // Send buffer & cache
+    std::vector<uint8_t> _recive_buffer;
+    size_t _recive_buffer_offset;
+    size_t _recive_buffer_size;
+    size_t _recive_size;
+    HandlerStorage _recive_storage;
+    // Send queue
     bool _sending;
-    std::mutex _send_lock;
-    uint8_t _send_buffer[CHUNK];
-    std::vector<uint8_t> _send_cache;
+    SendQueue _send_queue;
+    SendFlush _send_flush;
+    std::atomic<size_t> _send_pending;
+    std::atomic<bool> _send_scheduled;
+    std::atomic<bool> _send_full;
+    bool _send_full_notified;
+    HandlerStorage _send_storage;
+    // Coroutine awaiters
+    bool _recive_async;
+    AsyncAwaiter* _connect_awaiter;
+    AsyncAwaiter* _recive_awaiter;
+    AsyncAwaiter* _send_awaiter;
+
+    void Handshake()
+    {
+        auto self(this->shared_from_this());
+        auto async_handshake_handler = [this, self](std::error_code ec)
+        {
+            _handshaking = false;
+
+            if (IsHandshaked() || _handshaking)
+                return;
+
+            if (!ec)
+            {
+                // Update the handshaked flag
+                _handshaked = true;
+
+                // Reset reconnect attempts
+                _client->_reconnect_policy.Reset();
+
+                // Call the client handshaked handler
+                onHandshaked();
+
+                // Call the empty send buffer handler
+                onEmpty();
+
+                // Try to receive something from the server
+                TryReceive();
+
+                // Resume the coroutine awaiting the client handshake
+                CompleteConnectAsync(true);
+            }
+            else
+            {
+                // Disconnect on in case of the bad handshake
+                SendError(ec);
+                Disconnect(true);
+            }
+        };
+
+        // SSL stream handlers of the multi-threaded service are serialized by the client strand
+        _handshaking = true;
+        if (_strand_required)
+            _stream.async_handshake(asio::ssl::stream_base::client, _strand.wrap(async_handshake_handler));
+        else
+            _stream.async_handshake(asio::ssl::stream_base::client, async_handshake_handler);
+    }
 
     void TryReceive()
     {
@@ -282,29 +567,86 @@ private:
         if (!IsHandshaked())
             return;
 
+        // Receive coroutine data only when the next chunk is awaited
+        if (_recive_async && (_recive_awaiter == nullptr))
+            return;
+
+        // Pause receiving while the peer does not drain the full send buffer
+        if (_send_full && _receive_pause)
+            return;
+
+        // Release the receive buffer above the receive size when all received data is handled
+        if ((_recive_buffer_size == 0) && (_recive_buffer.size() > (2 * _recive_size)))
+        {
+            _recive_buffer.resize(_recive_size);
+            _recive_buffer.shrink_to_fit();
+        }
+
+        // Prepare the free space for the receive size at the tail of the receive buffer
+        if ((_recive_buffer.size() - _recive_buffer_size) < _recive_size)
+        {
+            // Compact unread data to the front of the receive buffer
+            if (_recive_buffer_offset > 0)
+            {
+                std::memmove(_recive_buffer.data(), _recive_buffer.data() + _recive_buffer_offset, _recive_buffer_size - _recive_buffer_offset);
+                _recive_buffer_size -= _recive_buffer_offset;
+                _recive_buffer_offset = 0;
+            }
+
+            // Grow the receive buffer if it is still too small
+            if ((_recive_buffer.size() - _recive_buffer_size) < _recive_size)
+                _recive_buffer.resize(_recive_buffer_size + _recive_size);
+        }
+
         _reciving = true;
         auto self(this->shared_from_this());
-        _stream.async_read_some(asio::buffer(_recive_buffer), [this, self](std::error_code ec, std::size_t size)
+        auto async_receive_handler = [this, self](std::error_code ec, std::size_t size)
         {
             _reciving = false;
 
             if (!IsHandshaked())
                 return;
 
+            AsyncAwaiter* awaiter = nullptr;
+
             // Received some data from the client
             if (size > 0)
             {
                 // Update statistic
                 _bytes_received += size;
 
-                // Fill receive buffer
-                _recive_cache.insert(_recive_cache.end(), _recive_buffer, _recive_buffer + size);
+                // Data was received directly into the free tail of the receive buffer
+                _recive_buffer_size += size;
 
-                // Call the buffer received handler
-                size_t handled = onReceived(_recive_cache.data(), _recive_cache.size());
+                // Grow the receive size while receive operations fill it up and
+                // fall back when they return less than a half of it
+                if (size >= _recive_size)
+                    _recive_size = std::min(2 * _recive_size, _buffer_max);
+                else
+                {
+                    while ((_recive_size > _buffer_min) && (size < (_recive_size / 2)))
+                        _recive_size = std::max(_recive_size / 2, _buffer_min);
+                }
 
-                // Erase the handled buffer
-                _recive_cache.erase(_recive_cache.begin(), _recive_cache.begin() + handled);
+                if (_recive_awaiter != nullptr)
+                {
+                    // Read received data into the buffer of the awaiting coroutine
+                    awaiter = std::exchange(_recive_awaiter, nullptr);
+                    awaiter->result = ReadBuffer(awaiter->buffer, awaiter->size);
+                }
+                else
+                {
+                    // Call the buffer received handler with all unread data
+                    size_t handled = onReceived(_recive_buffer.data() + _recive_buffer_offset, _recive_buffer_size - _recive_buffer_offset);
+
+                    // Skip the handled data. Reset the receive buffer if all data was handled.
+                    _recive_buffer_offset += handled;
+                    if (_recive_buffer_offset >= _recive_buffer_size)
+                    {
+                        _recive_buffer_offset = 0;
+                        _recive_buffer_size = 0;
+                    }
+                }
             }
 
             // Try to receive again if the session is valid
@@ -315,7 +657,19 @@ private:
                 SendError(ec);
                 Disconnect(true);
             }
-        });
+
+            // Resume the coroutine awaiting received data
+            if (awaiter != nullptr)
+                awaiter->Complete(awaiter->result);
+        };
+
+        // SSL stream handlers of the multi-threaded service are serialized by the client strand
+        // Memory of receive operations is recycled by the receive handler storage
+        auto buffer = asio::buffer(_recive_buffer.data() + _recive_buffer_size, _recive_buffer.size() - _recive_buffer_size);
+        if (_strand_required)
+            _stream.async_read_some(buffer, _strand.wrap(make_alloc_handler(_recive_storage, async_receive_handler)));
+        else
+            _stream.async_read_some(buffer, make_alloc_handler(_recive_storage, async_receive_handler));
     }
 
     void TrySend()
@@ -326,18 +680,37 @@ private:
         if (!IsHandshaked())
             return;
 
-        size_t size;
+        // Dequeue all nodes enqueued by producers into the flush list
+        _send_flush.Fetch(_send_queue);
+
+        // Check for nothing to send
+        if (_send_flush.empty())
         {
-            std::lock_guard<std::mutex> locker(_send_lock);
+            // Stop sending until producers schedule the send routine again. Data
+            // pending before the scheduled flag is cleared is checked once more.
+            if (_send_pending == 0)
+            {
+                _send_scheduled = false;
+                if ((_send_pending == 0) || _send_scheduled.exchange(true))
+                    return;
+            }
 
-            // Fill the send buffer
-            size = std::min(_send_cache.size(), CHUNK);
-            std::memcpy(_send_buffer, _send_cache.data(), size);
+            // Some producer has not yet linked its pending data into the send queue. Try again later.
+            auto self(this->shared_from_this());
+            auto send = [this, self]() { TrySend(); };
+            if (_strand_required)
+                _strand.post(send);
+            else
+                _service->Post(send);
+            return;
         }
 
+        // Gather pending segments from the head of the flush list up to the send size limit
+        SendBuffers buffers = _send_flush.Gather(_send_size_limit);
+
         _sending = true;
         auto self(this->shared_from_this());
-        asio::async_write(_stream, asio::buffer(_send_buffer, size), [this, self](std::error_code ec, std::size_t size)
+        auto async_send_handler = [this, self](std::error_code ec, std::size_t size)
         {
             _sending = false;
 
@@ -345,6 +718,7 @@ private:
                 return;
 
             bool resume = true;
+            AsyncAwaiter* awaiter = nullptr;
 
             // Send some data to the client
             if (size > 0)
@@ -352,19 +726,26 @@ private:
                 // Update statistic
                 _bytes_sent += size;
 
-                // Call the buffer sent handler
-                onSent(size, _send_cache.size());
+                // Consume and release completely sent nodes of the flush list
+                _send_flush.Consume(_send_queue, size);
 
-                {
-                    std::lock_guard<std::mutex> locker(_send_lock);
+                // Update the pending size
+                size_t pending = (_send_pending -= size);
 
-                    // Erase the sent buffer
-                    _send_cache.erase(_send_cache.begin(), _send_cache.begin() + size);
+                // Stop sending if the send buffer is empty. Producers dispatch
+                // the send routine again with the next enqueued data.
+                if (pending == 0)
+                    resume = false;
 
-                    // Stop sending if the send buffer is empty
-                    if (_send_cache.empty())
-                        resume = false;
-                }
+                // Call the buffer sent handler
+                onSent(size, pending);
+
+                // Update the send buffer state
+                UpdateSendBuffer(pending);
+
+                // Complete the coroutine awaiting all data sent before its buffer
+                if ((_send_awaiter != nullptr) && (_bytes_sent >= _send_awaiter->target))
+                    awaiter = std::exchange(_send_awaiter, nullptr);
             }
 
             // Try to send again if the session is valid
@@ -373,22 +754,107 @@ private:
                 if (resume)
                     TrySend();
                 else
+                {
+                    // Call the empty send buffer handler and stop sending unless it has sent more data
                     onEmpty();
+                    TrySend();
+                }
             }
             else
             {
                 SendError(ec);
                 Disconnect(true);
             }
-        });
+
+            // Resume the coroutine awaiting sent data
+            if (awaiter != nullptr)
+                awaiter->Complete(awaiter->size);
+        };
+
+        // Send gathered segments without an intermediate copy
+        // SSL stream handlers of the multi-threaded service are serialized by the client strand
+        // Memory of send operations is recycled by the send handler storage
+        if (_strand_required)
+            asio::async_write(_stream, buffers, _strand.wrap(make_alloc_handler(_send_storage, async_send_handler)));
+        else
+            asio::async_write(_stream, buffers, make_alloc_handler(_send_storage, async_send_handler));
     }
 
-    void ClearBuffers()
+    void UpdateSendBuffer(size_t pending)
+    {
+        // Call the send buffer full handler once the send buffer becomes full
+        if (_send_full && !_send_full_notified)
+        {
+            _send_full_notified = true;
+            onSendBufferFull();
+        }
+
+        // Clear the full flag when the send buffer is drained to the low watermark
+        if (_send_full && (pending <= _send_buffer_low))
+        {
+            _send_full = false;
+
+            // Call the send buffer drained handler paired with the notified full send buffer
+            if (_send_full_notified)
+            {
+                _send_full_notified = false;
+                onSendBufferDrained();
+            }
+
+            // Resume receiving paused by the full send buffer
+            TryReceive();
+        }
+    }
+
+    size_t ReadBuffer(void* buffer, size_t size)
     {
-        std::lock_guard<std::mutex> locker(_send_lock);
+        size_t unread = std::min(size, _recive_buffer_size - _recive_buffer_offset);
+        if (unread == 0)
+            return 0;
+
+        std::memcpy(buffer, _recive_buffer.data() + _recive_buffer_offset, unread);
 
-        _recive_cache.clear();
-        _send_cache.clear();
+        // Skip the read data. Reset the receive buffer if all data was read.
+        _recive_buffer_offset += unread;
+        if (_recive_buffer_offset >= _recive_buffer_size)
+        {
+            _recive_buffer_offset = 0;
+            _recive_buffer_size = 0;
+        }
+
+        return unread;
+    }
+
+    void CompleteConnectAsync(bool handshaked)
+    {
+        if (_connect_awaiter != nullptr)
+            std::exchange(_connect_awaiter, nullptr)->Complete(handshaked ? 1 : 0);
+    }
+
+    void CompleteAsync()
+    {
+        _recive_async = false;
+
+        // Resume the coroutine awaiting the handshake of the disconnected client
+        CompleteConnectAsync(false);
+
+        if (_recive_awaiter != nullptr)
+            std::exchange(_recive_awaiter, nullptr)->Complete(0);
+        if (_send_awaiter != nullptr)
+            std::exchange(_send_awaiter, nullptr)->Complete(0);
+    }
+
+    void ClearBuffers()
+    {
+        _recive_buffer_offset = 0;
+        _recive_buffer_size = 0;
+
+        // Release all unsent nodes. Only their size is removed from the pending
+        // size, because producers could enqueue new data at the same time.
+        size_t unsent = _send_flush.Clear(_send_queue);
+        _send_pending -= unsent;
+        _send_full = false;
+        _send_full_notified = false;
     }
 
     void SendError(std::error_code ec)
@@ -416,26 +882,31 @@ private:
     }
 };
 
-const size_t SSLClient::Impl::CHUNK;
-
 //! @endcond
 
 SSLClient::SSLClient(std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, const std::string& address, int port)
-    : _id(CppCommon::UUID::Generate()),
-      _pimpl(std::make_shared<Impl>(_id, service, context, address, port))
+    : _pimpl(std::make_shared<Impl>(service, context, address, port)),
+      _reconnect(false),
+      _reconnect_timer(0)
 {
 }
 
 SSLClient::SSLClient(std::shared_ptr<Service> service, std::shared_ptr<asio::ssl::context> context, const asio::ip::tcp::endpoint& endpoint)
-    : _id(CppCommon::UUID::Generate()),
-      _pimpl(std::make_shared<Impl>(_id, service, context, endpoint))
+    : _pimpl(std::make_shared<Impl>(service, context, endpoint)),
+      _reconnect(false),
+      _reconnect_timer(0)
 {
 }
 
 SSLClient::SSLClient(SSLClient&& client)
-    : _id(std::move(client._id)),
-      _pimpl(std::move(client._pimpl))
+    : _id(client.id()),
+      _pimpl(std::move(client._pimpl)),
+      _reconnect(false),
+      _reconnect_timer(0),
+      _reconnect_policy(std::move(client._reconnect_policy))
 {
+    // Mark the moved client Id as generated
+    std::call_once(_id_flag, []() {});
 }
 
 SSLClient::~SSLClient()
@@ -444,11 +915,19 @@ SSLClient::~SSLClient()
 
 SSLClient& SSLClient::operator=(SSLClient&& client)
 {
-    _id = std::move(client._id);
+    _id = client.id();
+    std::call_once(_id_flag, []() {});
     _pimpl = std::move(client._pimpl);
+    _reconnect_policy = std::move(client._reconnect_policy);
     return *this;
 }
 
+const CppCommon::UUID& SSLClient::id() const
+{
+    std::call_once(_id_flag, [this]() { _id = CppCommon::UUID::Generate(); });
+    return _id;
+}
+
 std::shared_ptr<Service>& SSLClient::service() noexcept
 {
     return _pimpl->service();
@@ -484,6 +963,11 @@ uint64_t SSLClient::bytes_received() const noexcept
     return _pimpl->bytes_received();
 }
 
+uint64_t SSLClient::bytes_pending() const noexcept
+{
+    return _pimpl->bytes_pending();
+}
+
 bool SSLClient::IsConnected() const noexcept
 {
     return _pimpl->IsConnected();
@@ -494,12 +978,94 @@ bool SSLClient::IsHandshaked() const noexcept
     return _pimpl->IsHandshaked();
 }
 
+size_t SSLClient::option_send_size_limit() const noexcept
+{
+    return _pimpl->send_size_limit();
+}
+
+void SSLClient::SetupSendSizeLimit(size_t limit) noexcept
+{
+    _pimpl->send_size_limit() = limit;
+}
+
+size_t SSLClient::option_buffer_min() const noexcept
+{
+    return _pimpl->buffer_min();
+}
+
+size_t SSLClient::option_buffer_max() const noexcept
+{
+    return _pimpl->buffer_max();
+}
+
+void SSLClient::SetupBufferLimits(size_t min, size_t max) noexcept
+{
+    _pimpl->buffer_min() = min;
+    _pimpl->buffer_max() = std::max(min, max);
+}
+
+size_t SSLClient::option_send_buffer_high() const noexcept
+{
+    return _pimpl->send_buffer_high();
+}
+
+size_t SSLClient::option_send_buffer_low() const noexcept
+{
+    return _pimpl->send_buffer_low();
+}
+
+bool SSLClient::option_receive_pause() const noexcept
+{
+    return _pimpl->receive_pause();
+}
+
+void SSLClient::SetupSendBufferWatermarks(size_t high, size_t low) noexcept
+{
+    _pimpl->send_buffer_high() = high;
+    _pimpl->send_buffer_low() = std::min(low, high);
+}
+
+void SSLClient::SetupReceivePause(bool enable) noexcept
+{
+    _pimpl->receive_pause() = enable;
+}
+
+std::chrono::steady_clock::duration SSLClient::option_reconnect_delay_min() const noexcept
+{
+    return _reconnect_policy.delay_min();
+}
+
+std::chrono::steady_clock::duration SSLClient::option_reconnect_delay_max() const noexcept
+{
+    return _reconnect_policy.delay_max();
+}
+
+size_t SSLClient::option_reconnect_attempts() const noexcept
+{
+    return _reconnect_policy.attempts();
+}
+
+void SSLClient::SetupReconnect(const std::chrono::steady_clock::duration& min, const std::chrono::steady_clock::duration& max, size_t attempts) noexcept
+{
+    _reconnect_policy.Setup(min, max, attempts);
+}
+
 bool SSLClient::Connect()
 {
     auto self(this->shared_from_this());
+    _reconnect = true;
     return _pimpl->Connect(self);
 }
 
+bool SSLClient::Disconnect()
+{
+    // Stop automatic reconnect
+    _reconnect = false;
+    CancelReconnect();
+
+    return Disconnect(false);
+}
+
 bool SSLClient::Disconnect(bool dispatch)
 {
     return _pimpl->Disconnect(dispatch);
@@ -507,13 +1073,50 @@ bool SSLClient::Disconnect(bool dispatch)
 
 bool SSLClient::Reconnect()
 {
-    if (!Disconnect())
-        return false;
+    auto self(this->shared_from_this());
+    return _pimpl->Reconnect(self);
+}
+
+void SSLClient::ScheduleReconnect()
+{
+    if (!_reconnect)
+        return;
+
+    // Get the delay of the next reconnect attempt
+    std::chrono::steady_clock::duration delay;
+    if (!_reconnect_policy.Next(delay))
+        return;
 
-    while (IsConnected())
-        CppCommon::Thread::Yield();
+    // Call the client reconnecting handler
+    onReconnecting(_reconnect_policy.attempt(), delay);
 
-    return Connect();
+    // Check for reconnect stopped by the handler
+    if (!_reconnect)
+        return;
+
+    auto self(this->shared_from_this());
+    _reconnect_timer = service()->Schedule(delay, [this, self]()
+    {
+        _reconnect_timer = 0;
+
+        // Connect the client again unless reconnect was stopped
+        if (_reconnect)
+        {
+            auto client(self);
+            _pimpl->Connect(client);
+        }
+    });
+
+    // Cancel the reconnect timer scheduled concurrently with the client disconnect
+    if (!_reconnect)
+        CancelReconnect();
+}
+
+void SSLClient::CancelReconnect()
+{
+    TimerId id = _reconnect_timer.exchange(0);
+    if (id != 0)
+        service()->Cancel(id);
 }
 
 size_t SSLClient::Send(const void* buffer, size_t size)
@@ -521,13 +1124,47 @@ size_t SSLClient::Send(const void* buffer, size_t size)
     return _pimpl->Send(buffer, size);
 }
 
+size_t SSLClient::Send(std::shared_ptr<const Buffer> buffer)
+{
+    return _pimpl->Send(buffer);
+}
+
+bool SSLClient::StartConnectAsync(AsyncAwaiter& awaiter)
+{
+    auto self(this->shared_from_this());
+    _reconnect = true;
+    return _pimpl->StartConnectAsync(self, awaiter);
+}
+
+bool SSLClient::StartReceiveAsync(AsyncAwaiter& awaiter)
+{
+    return _pimpl->StartReceiveAsync(awaiter);
+}
+
+bool SSLClient::StartSendAsync(AsyncAwaiter& awaiter)
+{
+    return _pimpl->StartSendAsync(awaiter);
+}
+
 void SSLClient::onReset()
 {
     size_t bytes_sent = _pimpl->bytes_sent();
     size_t bytes_received = _pimpl->bytes_received();
-    _pimpl = std::make_shared<Impl>(_pimpl->id(), _pimpl->service(), _pimpl->context(), _pimpl->endpoint());
+    size_t send_size_limit = _pimpl->send_size_limit();
+    size_t buffer_min = _pimpl->buffer_min();
+    size_t buffer_max = _pimpl->buffer_max();
+    size_t send_buffer_high = _pimpl->send_buffer_high();
+    size_t send_buffer_low = _pimpl->send_buffer_low();
+    bool receive_pause = _pimpl->receive_pause();
+    _pimpl = std::make_shared<Impl>(_pimpl->service(), _pimpl->context(), _pimpl->endpoint());
     _pimpl->bytes_sent() = bytes_sent;
     _pimpl->bytes_received() = bytes_received;
+    _pimpl->send_size_limit() = send_size_limit;
+    _pimpl->buffer_min() = buffer_min;
+    _pimpl->buffer_max() = buffer_max;
+    _pimpl->send_buffer_high() = send_buffer_high;
+    _pimpl->send_buffer_low() = send_buffer_low;
+    _pimpl->receive_pause() = receive_pause;
 }
 
 } // namespace Asio
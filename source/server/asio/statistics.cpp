@@ -0,0 +1,132 @@
+/*!
+    \file statistics.cpp
+    \brief Server statistics implementation
+    \author Ivan Shynkarenka
+    \date 27.03.2017
+    \copyright MIT License
+*/
+
+#include "server/asio/statistics.h"
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace CppServer {
+namespace Asio {
+
+namespace {
+
+// Shard indexes of running threads. Index of the finished thread is reused by
+// a new one, so each shard is updated by a single thread at a time.
+std::mutex shards_lock;
+std::vector<size_t> shards_free;
+size_t shards_next = 0;
+
+class ThreadShardIndex
+{
+public:
+    ThreadShardIndex()
+    {
+        std::lock_guard<std::mutex> locker(shards_lock);
+        if (!shards_free.empty())
+        {
+            index = shards_free.back();
+            shards_free.pop_back();
+        }
+        else
+            index = shards_next++;
+    }
+    ~ThreadShardIndex()
+    {
+        std::lock_guard<std::mutex> locker(shards_lock);
+        shards_free.push_back(index);
+    }
+
+    size_t index;
+};
+
+} // namespace
+
+const size_t Statistics::CACHE_LINE;
+const size_t Statistics::SHARDS;
+
+Statistics::Statistics()
+{
+    // Allocate cache line aligned shards of threads and the shared shard
+    size_t size = (SHARDS + 1) * sizeof(Shard);
+    _memory.reset(new uint8_t[size + CACHE_LINE]);
+    uintptr_t address = ((uintptr_t)_memory.get() + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1);
+    _shards = (Shard*)address;
+
+    for (size_t i = 0; i <= SHARDS; ++i)
+    {
+        new (&_shards[i]) Shard();
+        for (auto& counter : _shards[i].counters)
+            counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto& base : _base)
+        base.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Statistics::Get(Type type) const noexcept
+{
+    // Load the base value first, so shards are never observed older than at the last reset
+    uint64_t base = _base[type].load(std::memory_order_acquire);
+
+    uint64_t result = 0;
+    for (size_t i = 0; i <= SHARDS; ++i)
+        result += _shards[i].counters[type].load(std::memory_order_relaxed);
+    return result - base;
+}
+
+void Statistics::Add(Type type, uint64_t value) noexcept
+{
+    size_t index = ThreadShard();
+    std::atomic<uint64_t>& counter = _shards[index].counters[type];
+
+    // The only thread updates its own shard without read-modify-write operations
+    if (index < SHARDS)
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    else
+        counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Statistics::Add(Type type1, uint64_t value1, Type type2, uint64_t value2) noexcept
+{
+    size_t index = ThreadShard();
+    std::atomic<uint64_t>& counter1 = _shards[index].counters[type1];
+    std::atomic<uint64_t>& counter2 = _shards[index].counters[type2];
+
+    // The only thread updates its own shard without read-modify-write operations
+    if (index < SHARDS)
+    {
+        counter1.store(counter1.load(std::memory_order_relaxed) + value1, std::memory_order_relaxed);
+        counter2.store(counter2.load(std::memory_order_relaxed) + value2, std::memory_order_relaxed);
+    }
+    else
+    {
+        counter1.fetch_add(value1, std::memory_order_relaxed);
+        counter2.fetch_add(value2, std::memory_order_relaxed);
+    }
+}
+
+void Statistics::Reset() noexcept
+{
+    for (size_t type = 0; type < TYPES; ++type)
+    {
+        uint64_t result = 0;
+        for (size_t i = 0; i <= SHARDS; ++i)
+            result += _shards[i].counters[type].load(std::memory_order_relaxed);
+        _base[type].store(result, std::memory_order_release);
+    }
+}
+
+size_t Statistics::ThreadShard() noexcept
+{
+    thread_local ThreadShardIndex shard;
+    return (shard.index < SHARDS) ? shard.index : SHARDS;
+}
+
+} // namespace Asio
+} // namespace CppServer
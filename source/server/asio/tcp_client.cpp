@@ -11,19 +11,37 @@
 namespace CppServer {
 namespace Asio {
 
-const size_t TCPClient::CHUNK;
-
 TCPClient::TCPClient(std::shared_ptr<Service> service, const std::string& address, int port)
-    : _id(CppCommon::UUID::Generate()),
-      _service(service),
+    : _service(service),
       _endpoint(asio::ip::tcp::endpoint(asio::ip::address::from_string(address), port)),
       _socket(*_service->service()),
+      _strand(*_service->service()),
+      _strand_required(false),
       _connecting(false),
       _connected(false),
+      _send_size_limit(0),
+      _buffer_min(4096),
+      _buffer_max(1048576),
+      _send_buffer_high(0),
+      _send_buffer_low(0),
+      _receive_pause(false),
       _bytes_sent(0),
       _bytes_received(0),
       _reciving(false),
-      _sending(false)
+      _recive_buffer_offset(0),
+      _recive_buffer_size(0),
+      _recive_size(0),
+      _sending(false),
+      _send_pending(0),
+      _send_scheduled(false),
+      _send_full(false),
+      _send_full_notified(false),
+      _recive_async(false),
+      _connect_awaiter(nullptr),
+      _recive_awaiter(nullptr),
+      _send_awaiter(nullptr),
+      _reconnect(false),
+      _reconnect_timer(0)
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -31,37 +49,71 @@ TCPClient::TCPClient(std::shared_ptr<Service> service, const std::string& addres
 }
 
 TCPClient::TCPClient(std::shared_ptr<Service> service, const asio::ip::tcp::endpoint& endpoint)
-    : _id(CppCommon::UUID::Generate()),
-      _service(service),
+    : _service(service),
       _endpoint(endpoint),
       _socket(*_service->service()),
+      _strand(*_service->service()),
+      _strand_required(false),
       _connecting(false),
       _connected(false),
+      _send_size_limit(0),
+      _buffer_min(4096),
+      _buffer_max(1048576),
+      _send_buffer_high(0),
+      _send_buffer_low(0),
+      _receive_pause(false),
       _bytes_sent(0),
       _bytes_received(0),
       _reciving(false),
-      _sending(false)
+      _recive_buffer_offset(0),
+      _recive_buffer_size(0),
+      _recive_size(0),
+      _sending(false),
+      _send_pending(0),
+      _send_scheduled(false),
+      _send_full(false),
+      _send_full_notified(false),
+      _recive_async(false),
+      _connect_awaiter(nullptr),
+      _recive_awaiter(nullptr),
+      _send_awaiter(nullptr),
+      _reconnect(false),
+      _reconnect_timer(0)
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
         throw CppCommon::ArgumentException("ASIO service is invalid!");
 }
 
-bool TCPClient::Connect()
+const CppCommon::UUID& TCPClient::id() const
+{
+    std::call_once(_id_flag, [this]() { _id = CppCommon::UUID::Generate(); });
+    return _id;
+}
+
+bool TCPClient::Connect(AsyncAwaiter* awaiter)
 {
     if (IsConnected())
         return false;
 
-    // Post the connect routine
+    // Client handlers of the multi-threaded service are serialized by the client strand
+    _strand_required = (_service->threads() > 1);
+
     auto self(this->shared_from_this());
-    _service->service()->post([this, self]()
+    auto connect = [this, self, awaiter]()
     {
         if (IsConnected() || _connecting)
+        {
+            // Resume the coroutine awaiting the client connection
+            if (awaiter != nullptr)
+                awaiter->Complete(IsConnected() ? 1 : 0);
             return;
+        }
 
-        // Connect the client socket
-        _connecting = true;
-        _socket.async_connect(_endpoint, [this, self](std::error_code ec)
+        // Register the connect awaiter in the IO thread
+        _connect_awaiter = awaiter;
+
+        auto async_connect_handler = [this, self](std::error_code ec)
         {
             _connecting = false;
 
@@ -71,9 +123,20 @@ bool TCPClient::Connect()
                 _bytes_sent = 0;
                 _bytes_received = 0;
 
+                // Reset the adaptive receive size
+                _recive_size = _buffer_min;
+
+                // Drop the data left by producers racing the previous disconnect
+                ClearBuffers();
+                _send_pending = 0;
+                _send_scheduled = false;
+
                 // Update the connected flag
                 _connected = true;
 
+                // Reset reconnect attempts
+                _reconnect_policy.Reset();
+
                 // Call the client connected handler
                 onConnected();
 
@@ -82,15 +145,41 @@ bool TCPClient::Connect()
 
                 // Try to receive something from the server
                 TryReceive();
+
+                // Resume the coroutine awaiting the client connection
+                CompleteConnectAsync(true);
             }
             else
             {
+                // Close the client socket to connect it again
+                asio::error_code ignore;
+                _socket.close(ignore);
+
                 // Call the client disconnected handler
                 SendError(ec);
                 onDisconnected();
+
+                // Resume the coroutine awaiting the client connection
+                CompleteConnectAsync(false);
+
+                // Try to connect the client again
+                ScheduleReconnect();
             }
-        });
-    });
+        };
+
+        // Connect the client socket
+        _connecting = true;
+        if (_strand_required)
+            _socket.async_connect(_endpoint, _strand.wrap(async_connect_handler));
+        else
+            _socket.async_connect(_endpoint, async_connect_handler);
+    };
+
+    // Post the connect routine
+    if (_strand_required)
+        _strand.post(connect);
+    else
+        _service->Post(connect);
 
     return true;
 }
@@ -117,26 +206,110 @@ bool TCPClient::Disconnect(bool dispatch)
 
         // Call the client disconnected handler
         onDisconnected();
+
+        // Resume coroutines awaiting the disconnected client
+        CompleteAsync();
+
+        // Try to connect the client again
+        ScheduleReconnect();
     };
 
     // Dispatch or post the disconnect routine
-    if (dispatch)
-        _service->Dispatch(disconnect);
+    if (_strand_required)
+    {
+        if (dispatch)
+            _strand.dispatch(disconnect);
+        else
+            _strand.post(disconnect);
+    }
     else
-        _service->Post(disconnect);
+    {
+        if (dispatch)
+            _service->Dispatch(disconnect);
+        else
+            _service->Post(disconnect);
+    }
 
     return true;
 }
 
+bool TCPClient::Disconnect()
+{
+    // Stop automatic reconnect
+    _reconnect = false;
+    CancelReconnect();
+
+    return Disconnect(false);
+}
+
 bool TCPClient::Reconnect()
 {
-    if (!Disconnect())
+    if (!IsConnected())
         return false;
 
-    while (IsConnected())
-        CppCommon::Thread::Yield();
+    _reconnect = true;
+
+    auto self(this->shared_from_this());
+    auto reconnect = [this, self]()
+    {
+        // Disconnect the client without scheduling automatic reconnect
+        bool reconnect = _reconnect.exchange(false);
+        Disconnect(true);
+
+        // Connect the client again unless it was disconnected after the reconnect request
+        if (reconnect)
+        {
+            _reconnect = true;
+            Connect(nullptr);
+        }
+    };
+
+    // Post the reconnect routine
+    if (_strand_required)
+        _strand.post(reconnect);
+    else
+        _service->Post(reconnect);
 
-    return Connect();
+    return true;
+}
+
+void TCPClient::ScheduleReconnect()
+{
+    if (!_reconnect)
+        return;
+
+    // Get the delay of the next reconnect attempt
+    std::chrono::steady_clock::duration delay;
+    if (!_reconnect_policy.Next(delay))
+        return;
+
+    // Call the client reconnecting handler
+    onReconnecting(_reconnect_policy.attempt(), delay);
+
+    // Check for reconnect stopped by the handler
+    if (!_reconnect)
+        return;
+
+    auto self(this->shared_from_this());
+    _reconnect_timer = _service->Schedule(delay, [this, self]()
+    {
+        _reconnect_timer = 0;
+
+        // Connect the client again unless reconnect was stopped
+        if (_reconnect)
+            Connect(nullptr);
+    });
+
+    // Cancel the reconnect timer scheduled concurrently with the client disconnect
+    if (!_reconnect)
+        CancelReconnect();
+}
+
+void TCPClient::CancelReconnect()
+{
+    TimerId id = _reconnect_timer.exchange(0);
+    if (id != 0)
+        _service->Cancel(id);
 }
 
 size_t TCPClient::Send(const void* buffer, size_t size)
@@ -149,23 +322,94 @@ size_t TCPClient::Send(const void* buffer, size_t size)
     if (!IsConnected())
         return 0;
 
+    // Reject data while the send buffer is full
+    if (_send_full)
+        return 0;
+
+    // Account the pending size before the data is enqueued, so the send
+    // routine never observes enqueued data which is not yet pending
+    size_t pending = (_send_pending += size);
+
+    // Enqueue a copy of the buffer into the lock-free send queue
+    _send_queue.Enqueue(buffer, size);
+
+    // Mark the send buffer as full when it reaches the high watermark
+    size_t high = _send_buffer_high;
+    bool full = (high > 0) && (pending >= high) && !_send_full.exchange(true);
+
+    // Dispatch the send routine unless it is already scheduled or when the
+    // send buffer became full. Otherwise the enqueued data is picked up by
+    // the scheduled send routine.
+    bool schedule = !_send_scheduled.exchange(true);
+    if (schedule || full)
     {
-        std::lock_guard<std::mutex> locker(_send_lock);
+        auto self(this->shared_from_this());
+        auto send = [this, self]()
+        {
+            // Update the send buffer state
+            UpdateSendBuffer(_send_pending);
+
+            // Try to send the buffer
+            TrySend();
+        };
 
-        // Fill the send buffer
-        const uint8_t* bytes = (const uint8_t*)buffer;
-        _send_cache.insert(_send_cache.end(), bytes, bytes + size);
+        if (_strand_required)
+            _strand.dispatch(send);
+        else
+            _service->Dispatch(send);
     }
 
-    // Dispatch the send routine
-    auto self(this->shared_from_this());
-    _service->Dispatch([this, self]()
+    return pending;
+}
+
+size_t TCPClient::Send(std::shared_ptr<const Buffer> buffer)
+{
+    assert((buffer != nullptr) && "Shared buffer should not be equal to 'nullptr'!");
+    if ((buffer == nullptr) || buffer->empty())
+        return 0;
+
+    if (!IsConnected())
+        return 0;
+
+    // Reject data while the send buffer is full
+    if (_send_full)
+        return 0;
+
+    // Account the pending size before the data is enqueued, so the send
+    // routine never observes enqueued data which is not yet pending
+    size_t size = buffer->size();
+    size_t pending = (_send_pending += size);
+
+    // Enqueue the shared buffer reference without copying its content
+    _send_queue.Enqueue(std::move(buffer));
+
+    // Mark the send buffer as full when it reaches the high watermark
+    size_t high = _send_buffer_high;
+    bool full = (high > 0) && (pending >= high) && !_send_full.exchange(true);
+
+    // Dispatch the send routine unless it is already scheduled or when the
+    // send buffer became full. Otherwise the enqueued data is picked up by
+    // the scheduled send routine.
+    bool schedule = !_send_scheduled.exchange(true);
+    if (schedule || full)
     {
-        // Try to send the buffer
-        TrySend();
-    });
+        auto self(this->shared_from_this());
+        auto send = [this, self]()
+        {
+            // Update the send buffer state
+            UpdateSendBuffer(_send_pending);
+
+            // Try to send the buffer
+            TrySend();
+        };
+
+        if (_strand_required)
+            _strand.dispatch(send);
+        else
+            _service->Dispatch(send);
+    }
 
-    return _send_cache.size();
+    return pending;
 }
 
 void TCPClient::TryReceive()
@@ -176,29 +420,86 @@ void TCPClient::TryReceive()
     if (!IsConnected())
         return;
 
+    // Receive coroutine data only when the next chunk is awaited
+    if (_recive_async && (_recive_awaiter == nullptr))
+        return;
+
+    // Pause receiving while the peer does not drain the full send buffer
+    if (_send_full && _receive_pause)
+        return;
+
+    // Release the receive buffer above the receive size when all received data is handled
+    if ((_recive_buffer_size == 0) && (_recive_buffer.size() > (2 * _recive_size)))
+    {
+        _recive_buffer.resize(_recive_size);
+        _recive_buffer.shrink_to_fit();
+    }
+
+    // Prepare the free space for the receive size at the tail of the receive buffer
+    if ((_recive_buffer.size() - _recive_buffer_size) < _recive_size)
+    {
+        // Compact unread data to the front of the receive buffer
+        if (_recive_buffer_offset > 0)
+        {
+            std::memmove(_recive_buffer.data(), _recive_buffer.data() + _recive_buffer_offset, _recive_buffer_size - _recive_buffer_offset);
+            _recive_buffer_size -= _recive_buffer_offset;
+            _recive_buffer_offset = 0;
+        }
+
+        // Grow the receive buffer if it is still too small
+        if ((_recive_buffer.size() - _recive_buffer_size) < _recive_size)
+            _recive_buffer.resize(_recive_buffer_size + _recive_size);
+    }
+
     _reciving = true;
     auto self(this->shared_from_this());
-    _socket.async_read_some(asio::buffer(_recive_buffer), [this, self](std::error_code ec, std::size_t size)
+    auto async_receive_handler = [this, self](std::error_code ec, std::size_t size)
     {
         _reciving = false;
 
         if (!IsConnected())
             return;
 
+        AsyncAwaiter* awaiter = nullptr;
+
         // Received some data from the client
         if (size > 0)
         {
             // Update statistic
             _bytes_received += size;
 
-            // Fill receive buffer
-            _recive_cache.insert(_recive_cache.end(), _recive_buffer, _recive_buffer + size);
+            // Data was received directly into the free tail of the receive buffer
+            _recive_buffer_size += size;
 
-            // Call the buffer received handler
-            size_t handled = onReceived(_recive_cache.data(), _recive_cache.size());
+            // Grow the receive size while receive operations fill it up and
+            // fall back when they return less than a half of it
+            if (size >= _recive_size)
+                _recive_size = std::min(2 * _recive_size, _buffer_max);
+            else
+            {
+                while ((_recive_size > _buffer_min) && (size < (_recive_size / 2)))
+                    _recive_size = std::max(_recive_size / 2, _buffer_min);
+            }
 
-            // Erase the handled buffer
-            _recive_cache.erase(_recive_cache.begin(), _recive_cache.begin() + handled);
+            if (_recive_awaiter != nullptr)
+            {
+                // Read received data into the buffer of the awaiting coroutine
+                awaiter = std::exchange(_recive_awaiter, nullptr);
+                awaiter->result = ReadBuffer(awaiter->buffer, awaiter->size);
+            }
+            else
+            {
+                // Call the buffer received handler with all unread data
+                size_t handled = onReceived(_recive_buffer.data() + _recive_buffer_offset, _recive_buffer_size - _recive_buffer_offset);
+
+                // Skip the handled data. Reset the receive buffer if all data was handled.
+                _recive_buffer_offset += handled;
+                if (_recive_buffer_offset >= _recive_buffer_size)
+                {
+                    _recive_buffer_offset = 0;
+                    _recive_buffer_size = 0;
+                }
+            }
         }
 
         // Try to receive again if the session is valid
@@ -209,7 +510,19 @@ void TCPClient::TryReceive()
             SendError(ec);
             Disconnect(true);
         }
-    });
+
+        // Resume the coroutine awaiting received data
+        if (awaiter != nullptr)
+            awaiter->Complete(awaiter->result);
+    };
+
+    // Receive handlers of the multi-threaded service are serialized by the client strand
+    // Memory of receive operations is recycled by the receive handler storage
+    auto buffer = asio::buffer(_recive_buffer.data() + _recive_buffer_size, _recive_buffer.size() - _recive_buffer_size);
+    if (_strand_required)
+        _socket.async_read_some(buffer, _strand.wrap(make_alloc_handler(_recive_storage, async_receive_handler)));
+    else
+        _socket.async_read_some(buffer, make_alloc_handler(_recive_storage, async_receive_handler));
 }
 
 void TCPClient::TrySend()
@@ -220,18 +533,37 @@ void TCPClient::TrySend()
     if (!IsConnected())
         return;
 
-    size_t size;
+    // Dequeue all nodes enqueued by producers into the flush list
+    _send_flush.Fetch(_send_queue);
+
+    // Check for nothing to send
+    if (_send_flush.empty())
     {
-        std::lock_guard<std::mutex> locker(_send_lock);
+        // Stop sending until producers schedule the send routine again. Data
+        // pending before the scheduled flag is cleared is checked once more.
+        if (_send_pending == 0)
+        {
+            _send_scheduled = false;
+            if ((_send_pending == 0) || _send_scheduled.exchange(true))
+                return;
+        }
 
-        // Fill the send buffer
-        size = std::min(_send_cache.size(), CHUNK);
-        std::memcpy(_send_buffer, _send_cache.data(), size);
+        // Some producer has not yet linked its pending data into the send queue. Try again later.
+        auto self(this->shared_from_this());
+        auto send = [this, self]() { TrySend(); };
+        if (_strand_required)
+            _strand.post(send);
+        else
+            _service->Post(send);
+        return;
     }
 
+    // Gather pending segments from the head of the flush list up to the send size limit
+    SendBuffers buffers = _send_flush.Gather(_send_size_limit);
+
     _sending = true;
     auto self(this->shared_from_this());
-    asio::async_write(_socket, asio::buffer(_send_buffer, size), [this, self](std::error_code ec, std::size_t size)
+    auto async_send_handler = [this, self](std::error_code ec, std::size_t size)
     {
         _sending = false;
 
@@ -239,6 +571,7 @@ void TCPClient::TrySend()
             return;
 
         bool resume = true;
+        AsyncAwaiter* awaiter = nullptr;
 
         // Send some data to the client
         if (size > 0)
@@ -246,19 +579,26 @@ void TCPClient::TrySend()
             // Update statistic
             _bytes_sent += size;
 
-            // Call the buffer sent handler
-            onSent(size, _send_cache.size());
+            // Consume and release completely sent nodes of the flush list
+            _send_flush.Consume(_send_queue, size);
 
-            {
-                std::lock_guard<std::mutex> locker(_send_lock);
+            // Update the pending size
+            size_t pending = (_send_pending -= size);
 
-                // Erase the sent buffer
-                _send_cache.erase(_send_cache.begin(), _send_cache.begin() + size);
+            // Stop sending if the send buffer is empty. Producers dispatch
+            // the send routine again with the next enqueued data.
+            if (pending == 0)
+                resume = false;
 
-                // Stop sending if the send buffer is empty
-                if (_send_cache.empty())
-                    resume = false;
-            }
+            // Call the buffer sent handler
+            onSent(size, pending);
+
+            // Update the send buffer state
+            UpdateSendBuffer(pending);
+
+            // Complete the coroutine awaiting all data sent before its buffer
+            if ((_send_awaiter != nullptr) && (_bytes_sent >= _send_awaiter->target))
+                awaiter = std::exchange(_send_awaiter, nullptr);
         }
 
         // Try to send again if the session is valid
@@ -267,22 +607,153 @@ void TCPClient::TrySend()
             if (resume)
                 TrySend();
             else
+            {
+                // Call the empty send buffer handler and stop sending unless it has sent more data
                 onEmpty();
+                TrySend();
+            }
         }
         else
         {
             SendError(ec);
             Disconnect(true);
         }
-    });
+
+        // Resume the coroutine awaiting sent data
+        if (awaiter != nullptr)
+            awaiter->Complete(awaiter->size);
+    };
+
+    // Send gathered segments with a single socket operation. Partially sent
+    // data is consumed by the send handler and the rest is sent again.
+    // Send handlers of the multi-threaded service are serialized by the client strand
+    // Memory of send operations is recycled by the send handler storage
+    if (_strand_required)
+        _socket.async_write_some(buffers, _strand.wrap(make_alloc_handler(_send_storage, async_send_handler)));
+    else
+        _socket.async_write_some(buffers, make_alloc_handler(_send_storage, async_send_handler));
 }
 
-void TCPClient::ClearBuffers()
+void TCPClient::UpdateSendBuffer(size_t pending)
 {
-    std::lock_guard<std::mutex> locker(_send_lock);
+    // Call the send buffer full handler once the send buffer becomes full
+    if (_send_full && !_send_full_notified)
+    {
+        _send_full_notified = true;
+        onSendBufferFull();
+    }
 
-    _recive_cache.clear();
-    _send_cache.clear();
+    // Clear the full flag when the send buffer is drained to the low watermark
+    if (_send_full && (pending <= _send_buffer_low))
+    {
+        _send_full = false;
+
+        // Call the send buffer drained handler paired with the notified full send buffer
+        if (_send_full_notified)
+        {
+            _send_full_notified = false;
+            onSendBufferDrained();
+        }
+
+        // Resume receiving paused by the full send buffer
+        TryReceive();
+    }
+}
+
+bool TCPClient::StartConnectAsync(AsyncAwaiter& awaiter)
+{
+    // Complete at once if the client is already connected
+    awaiter.result = 1;
+    _reconnect = true;
+    return Connect(&awaiter);
+}
+
+bool TCPClient::StartReceiveAsync(AsyncAwaiter& awaiter)
+{
+    assert((!_strand_required || _strand.running_in_this_thread()) && "Client operations should be awaited in the client strand!");
+    assert((_recive_awaiter == nullptr) && "Only one receive operation of the client could be awaited at once!");
+
+    awaiter.result = 0;
+
+    if (!IsConnected())
+        return false;
+
+    // Complete at once with unread data of the receive buffer
+    awaiter.result = ReadBuffer(awaiter.buffer, awaiter.size);
+    if (awaiter.result > 0)
+        return false;
+
+    // Register the awaiter and receive the next chunk of data
+    _recive_async = true;
+    _recive_awaiter = &awaiter;
+    TryReceive();
+    return true;
+}
+
+bool TCPClient::StartSendAsync(AsyncAwaiter& awaiter)
+{
+    assert((!_strand_required || _strand.running_in_this_thread()) && "Client operations should be awaited in the client strand!");
+    assert((_send_awaiter == nullptr) && "Only one send operation of the client could be awaited at once!");
+
+    awaiter.result = 0;
+
+    // Complete at once if the data was not sent
+    size_t pending = Send(awaiter.buffer, awaiter.size);
+    if (pending == 0)
+        return false;
+
+    // Register the awaiter until all pending data is sent
+    awaiter.target = _bytes_sent + pending;
+    _send_awaiter = &awaiter;
+    return true;
+}
+
+size_t TCPClient::ReadBuffer(void* buffer, size_t size)
+{
+    size_t unread = std::min(size, _recive_buffer_size - _recive_buffer_offset);
+    if (unread == 0)
+        return 0;
+
+    std::memcpy(buffer, _recive_buffer.data() + _recive_buffer_offset, unread);
+
+    // Skip the read data. Reset the receive buffer if all data was read.
+    _recive_buffer_offset += unread;
+    if (_recive_buffer_offset >= _recive_buffer_size)
+    {
+        _recive_buffer_offset = 0;
+        _recive_buffer_size = 0;
+    }
+
+    return unread;
+}
+
+void TCPClient::CompleteConnectAsync(bool connected)
+{
+    if (_connect_awaiter != nullptr)
+        std::exchange(_connect_awaiter, nullptr)->Complete(connected ? 1 : 0);
+}
+
+void TCPClient::CompleteAsync()
+{
+    _recive_async = false;
+
+    if (_recive_awaiter != nullptr)
+        std::exchange(_recive_awaiter, nullptr)->Complete(0);
+    if (_send_awaiter != nullptr)
+        std::exchange(_send_awaiter, nullptr)->Complete(0);
+}
+
+void TCPClient::ClearBuffers()
+{
+    _recive_buffer_offset = 0;
+    _recive_buffer_size = 0;
+
+    // Release all unsent nodes. Only their size is removed from the pending
+    // size, because producers could enqueue new data at the same time.
+    size_t unsent = _send_flush.Clear(_send_queue);
+    _send_pending -= unsent;
+    _send_full = false;
+    _send_full_notified = false;
 }
 
 void TCPClient::SendError(std::error_code ec)
@@ -0,0 +1,207 @@
+/*!
+    \file timer_wheel.cpp
+    \brief Hierarchical timer wheel implementation
+    \author Ivan Shynkarenka
+    \date 29.03.2017
+    \copyright MIT License
+*/
+
+#include "server/asio/timer_wheel.h"
+
+namespace CppServer {
+namespace Asio {
+
+const uint32_t TimerWheel::NIL;
+const uint32_t TimerWheel::LEVELS;
+const uint32_t TimerWheel::ROOT_BITS;
+const uint32_t TimerWheel::ROOT_SLOTS;
+const uint32_t TimerWheel::LEVEL_BITS;
+const uint32_t TimerWheel::LEVEL_SLOTS;
+const uint32_t TimerWheel::SLOTS;
+const uint64_t TimerWheel::MAX_TICKS;
+
+TimerWheel::TimerWheel()
+    : _now(0),
+      _size(0),
+      _free(NIL)
+{
+    for (auto& slot : _slots)
+        slot = NIL;
+}
+
+TimerId TimerWheel::Schedule(uint64_t ticks, Handler&& handler)
+{
+    // Reuse the free node or create a new one
+    uint32_t index;
+    if (_free != NIL)
+    {
+        index = _free;
+        _free = _nodes[index].next;
+    }
+    else
+    {
+        index = (uint32_t)_nodes.size();
+        _nodes.push_back({ 0, 0, NIL, NIL, NIL, nullptr });
+    }
+
+    // Start a new node generation. Zero generation is skipped to keep all Ids non-zero.
+    Node& node = _nodes[index];
+    if (++node.generation == 0)
+        ++node.generation;
+    node.expires = _now + ticks;
+    node.handler = std::move(handler);
+
+    Link(index);
+    ++_size;
+
+    return ((TimerId)node.generation << 32) | index;
+}
+
+bool TimerWheel::Cancel(TimerId id)
+{
+    uint32_t index = (uint32_t)id;
+    uint32_t generation = (uint32_t)(id >> 32);
+    if (index >= _nodes.size())
+        return false;
+
+    const Node& node = _nodes[index];
+    if ((node.slot == NIL) || (node.generation != generation))
+        return false;
+
+    Unlink(index);
+    Release(index);
+    --_size;
+
+    return true;
+}
+
+void TimerWheel::Advance(uint64_t ticks, std::vector<Handler>& expired)
+{
+    while (ticks > 0)
+    {
+        // Skip all ticks of the empty wheel at once
+        if (_size == 0)
+        {
+            _now += ticks;
+            return;
+        }
+
+        // Cascade upper levels each time the previous level turns around
+        uint32_t index = (uint32_t)(_now & (ROOT_SLOTS - 1));
+        if (index == 0)
+        {
+            for (uint32_t level = 1; level < LEVELS; ++level)
+            {
+                uint32_t current = (uint32_t)((_now >> (ROOT_BITS + (level - 1) * LEVEL_BITS)) & (LEVEL_SLOTS - 1));
+                Cascade(ROOT_SLOTS + (level - 1) * LEVEL_SLOTS + current);
+                if (current != 0)
+                    break;
+            }
+        }
+
+        // Expire all timers of the current tick
+        uint32_t current = _slots[index];
+        _slots[index] = NIL;
+        while (current != NIL)
+        {
+            uint32_t next = _nodes[current].next;
+            expired.emplace_back(std::move(_nodes[current].handler));
+            Release(current);
+            --_size;
+            current = next;
+        }
+
+        ++_now;
+        --ticks;
+    }
+}
+
+void TimerWheel::Clear(std::vector<Handler>& cleared)
+{
+    // Release all linked nodes and keep their generations
+    for (uint32_t index = 0; index < _nodes.size(); ++index)
+    {
+        if (_nodes[index].slot != NIL)
+        {
+            cleared.emplace_back(std::move(_nodes[index].handler));
+            Release(index);
+        }
+    }
+    for (auto& slot : _slots)
+        slot = NIL;
+    _size = 0;
+}
+
+void TimerWheel::Link(uint32_t index)
+{
+    Node& node = _nodes[index];
+
+    // Find the slot of the expiration tick in the level covering the timer delay
+    uint64_t expires = (node.expires > _now) ? node.expires : _now;
+    uint64_t delta = expires - _now;
+    uint32_t slot;
+    if (delta < ROOT_SLOTS)
+        slot = (uint32_t)(expires & (ROOT_SLOTS - 1));
+    else
+    {
+        // Keep timers above the wheel range in the last level
+        if (delta > MAX_TICKS)
+        {
+            expires = _now + MAX_TICKS;
+            delta = MAX_TICKS;
+        }
+
+        uint32_t level = 1;
+        while ((level < (LEVELS - 1)) && (delta >= ((uint64_t)1 << (ROOT_BITS + level * LEVEL_BITS))))
+            ++level;
+
+        slot = ROOT_SLOTS + (level - 1) * LEVEL_SLOTS + (uint32_t)((expires >> (ROOT_BITS + (level - 1) * LEVEL_BITS)) & (LEVEL_SLOTS - 1));
+    }
+
+    // Link the node at the head of the slot list
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = _slots[slot];
+    if (node.next != NIL)
+        _nodes[node.next].prev = index;
+    _slots[slot] = index;
+}
+
+void TimerWheel::Unlink(uint32_t index)
+{
+    Node& node = _nodes[index];
+
+    if (node.prev != NIL)
+        _nodes[node.prev].next = node.next;
+    else
+        _slots[node.slot] = node.next;
+    if (node.next != NIL)
+        _nodes[node.next].prev = node.prev;
+}
+
+void TimerWheel::Release(uint32_t index)
+{
+    Node& node = _nodes[index];
+
+    node.handler = nullptr;
+    node.slot = NIL;
+    node.prev = NIL;
+    node.next = _free;
+    _free = index;
+}
+
+void TimerWheel::Cascade(uint32_t slot)
+{
+    // Relink all timers of the slot according to their remaining delays
+    uint32_t current = _slots[slot];
+    _slots[slot] = NIL;
+    while (current != NIL)
+    {
+        uint32_t next = _nodes[current].next;
+        Link(current);
+        current = next;
+    }
+}
+
+} // namespace Asio
+} // namespace CppServer
@@ -11,8 +11,6 @@
 namespace CppServer {
 namespace Asio {
 
-const size_t UDPClient::CHUNK;
-
 UDPClient::UDPClient(std::shared_ptr<Service> service, const std::string& address, int port)
     : _id(CppCommon::UUID::Generate()),
       _service(service),
@@ -24,6 +22,7 @@ UDPClient::UDPClient(std::shared_ptr<Service> service, const std::string& addres
       _bytes_sent(0),
       _bytes_received(0),
       _reciving(false),
+      _recive_buffer_limit(8192),
       _multicast(false),
       _reuse_address(false)
 {
@@ -43,6 +42,7 @@ UDPClient::UDPClient(std::shared_ptr<Service> service, const asio::ip::udp::endp
       _bytes_sent(0),
       _bytes_received(0),
       _reciving(false),
+      _recive_buffer_limit(8192),
       _multicast(false),
       _reuse_address(false)
 {
@@ -62,6 +62,7 @@ UDPClient::UDPClient(std::shared_ptr<Service> service, const std::string& addres
       _bytes_sent(0),
       _bytes_received(0),
       _reciving(false),
+      _recive_buffer_limit(8192),
       _multicast(true),
       _reuse_address(reuse_address)
 {
@@ -81,6 +82,7 @@ UDPClient::UDPClient(std::shared_ptr<Service> service, const asio::ip::udp::endp
       _bytes_sent(0),
       _bytes_received(0),
       _reciving(false),
+      _recive_buffer_limit(8192),
       _multicast(true),
       _reuse_address(reuse_address)
 {
@@ -262,9 +264,14 @@ void UDPClient::TryReceive()
     if (!IsConnected())
         return;
 
+    // Prepare the receive buffer of the configured size
+    if (_recive_buffer.size() != _recive_buffer_limit)
+        _recive_buffer.resize(_recive_buffer_limit);
+
+    // Memory of receive operations is recycled by the receive handler storage
     _reciving = true;
     auto self(this->shared_from_this());
-    _socket.async_receive_from(asio::buffer(_recive_buffer), _recive_endpoint, [this, self](std::error_code ec, std::size_t size)
+    _socket.async_receive_from(asio::buffer(_recive_buffer), _recive_endpoint, make_alloc_handler(_recive_storage, [this, self](std::error_code ec, std::size_t size)
     {
         _reciving = false;
 
@@ -279,7 +286,7 @@ void UDPClient::TryReceive()
             _bytes_received += size;
 
             // Call the datagram received handler
-            onReceived(_recive_endpoint, _recive_buffer, size);
+            onReceived(_recive_endpoint, _recive_buffer.data(), size);
         }
 
         // Try to receive again if the session is valid
@@ -290,7 +297,7 @@ void UDPClient::TryReceive()
             SendError(ec);
             Disconnect(true);
         }
-    });
+    }));
 }
 
 void UDPClient::SendError(std::error_code ec)
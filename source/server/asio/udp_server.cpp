@@ -11,17 +11,14 @@
 namespace CppServer {
 namespace Asio {
 
-const size_t UDPServer::CHUNK;
-
 UDPServer::UDPServer(std::shared_ptr<Service> service, InternetProtocol protocol, int port)
     : _service(service),
       _socket(*_service->service()),
       _started(false),
-      _datagrams_sent(0),
-      _datagrams_received(0),
-      _bytes_sent(0),
-      _bytes_received(0),
-      _reciving(false)
+      _reciving(false),
+      _recive_buffer_limit(8192),
+      _recive_async(false),
+      _recive_awaiter(nullptr)
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -42,11 +39,10 @@ UDPServer::UDPServer(std::shared_ptr<Service> service, const std::string& addres
     : _service(service),
       _socket(*_service->service()),
       _started(false),
-      _datagrams_sent(0),
-      _datagrams_received(0),
-      _bytes_sent(0),
-      _bytes_received(0),
-      _reciving(false)
+      _reciving(false),
+      _recive_buffer_limit(8192),
+      _recive_async(false),
+      _recive_awaiter(nullptr)
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -60,11 +56,10 @@ UDPServer::UDPServer(std::shared_ptr<Service> service, const asio::ip::udp::endp
       _endpoint(endpoint),
       _socket(*_service->service()),
       _started(false),
-      _datagrams_sent(0),
-      _datagrams_received(0),
-      _bytes_sent(0),
-      _bytes_received(0),
-      _reciving(false)
+      _reciving(false),
+      _recive_buffer_limit(8192),
+      _recive_async(false),
+      _recive_awaiter(nullptr)
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -88,10 +83,7 @@ bool UDPServer::Start()
         _socket = asio::ip::udp::socket(*_service->service(), _endpoint);
 
         // Reset statistic
-        _datagrams_sent = 0;
-        _datagrams_received = 0;
-        _bytes_sent = 0;
-        _bytes_received = 0;
+        _statistics.Reset();
 
          // Update the started flag
         _started = true;
@@ -139,6 +131,11 @@ bool UDPServer::Stop()
 
         // Call the server stopped handler
         onStopped();
+
+        // Resume the coroutine awaiting a datagram of the stopped server
+        _recive_async = false;
+        if (_recive_awaiter != nullptr)
+            std::exchange(_recive_awaiter, nullptr)->Complete(0);
     });
 
     return true;
@@ -178,8 +175,7 @@ bool UDPServer::Send(const asio::ip::udp::endpoint& endpoint, const void* buffer
     if (sent > 0)
     {
         // Update statistic
-        ++_datagrams_sent;
-        _bytes_sent += sent;
+        _statistics.AddSent(sent);
 
         // Call the datagram sent handler
         onSent(endpoint, sent);
@@ -203,24 +199,45 @@ void UDPServer::TryReceive()
     if (!IsStarted())
         return;
 
+    // Receive coroutine datagrams only when the next one is awaited
+    if (_recive_async && (_recive_awaiter == nullptr))
+        return;
+
+    // Prepare the receive buffer of the configured size
+    if (_recive_buffer.size() != _recive_buffer_limit)
+        _recive_buffer.resize(_recive_buffer_limit);
+
+    // Memory of receive operations is recycled by the receive handler storage
     _reciving = true;
     auto self(this->shared_from_this());
-    _socket.async_receive_from(asio::buffer(_recive_buffer), _recive_endpoint, [this, self](std::error_code ec, std::size_t size)
+    _socket.async_receive_from(asio::buffer(_recive_buffer), _recive_endpoint, make_alloc_handler(_recive_storage, [this, self](std::error_code ec, std::size_t size)
     {
         _reciving = false;
 
         if (!IsStarted())
             return;
 
+        AsyncAwaiter* awaiter = nullptr;
+
         // Received some data from the client
         if (size > 0)
         {
             // Update statistic
-            ++_datagrams_received;
-            _bytes_received += size;
-
-            // Call the datagram received handler
-            onReceived(_recive_endpoint, _recive_buffer, size);
+            _statistics.AddReceived(size);
+
+            if (_recive_awaiter != nullptr)
+            {
+                // Copy the datagram into the buffer of the awaiting coroutine
+                awaiter = std::exchange(_recive_awaiter, nullptr);
+                awaiter->result = std::min(size, awaiter->size);
+                std::memcpy(awaiter->buffer, _recive_buffer.data(), awaiter->result);
+                *awaiter->endpoint = _recive_endpoint;
+            }
+            else
+            {
+                // Call the datagram received handler
+                onReceived(_recive_endpoint, _recive_buffer.data(), size);
+            }
         }
 
         // Try to receive again if the session is valid
@@ -228,7 +245,33 @@ void UDPServer::TryReceive()
             TryReceive();
         else
             SendError(ec);
-    });
+
+        // Resume the coroutine awaiting the received datagram
+        if (awaiter != nullptr)
+            awaiter->Complete(awaiter->result);
+    }));
+}
+
+bool UDPServer::StartReceiveAsync(AsyncAwaiter& awaiter)
+{
+    assert((_recive_awaiter == nullptr) && "Only one receive operation of the server could be awaited at once!");
+
+    awaiter.result = 0;
+
+    if (!IsStarted())
+        return false;
+
+    // Register the awaiter and receive the next datagram
+    _recive_async = true;
+    _recive_awaiter = &awaiter;
+    TryReceive();
+    return true;
+}
+
+bool UDPServer::StartSendAsync(AsyncAwaiter& awaiter)
+{
+    awaiter.result = Send(*awaiter.endpoint, awaiter.buffer, awaiter.size) ? awaiter.size : 0;
+    return false;
 }
 
 void UDPServer::SendError(std::error_code ec)
@@ -241,6 +284,9 @@ void UDPServer::SendError(std::error_code ec)
         (ec == asio::error::operation_aborted))
         return;
 
+    // Update statistic
+    _statistics.AddError();
+
     onError(ec.value(), ec.category().name(), ec.message());
 }
 
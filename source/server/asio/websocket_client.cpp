@@ -20,7 +20,10 @@ WebSocketClient::WebSocketClient(std::shared_ptr<Service> service, const std::st
       _messages_sent(0),
       _messages_received(0),
       _bytes_sent(0),
-      _bytes_received(0)
+      _bytes_received(0),
+      _reconnect(false),
+      _reconnecting(false),
+      _reconnect_timer(0)
 {
     assert((service != nullptr) && "ASIO service is invalid!");
     if (service == nullptr)
@@ -56,6 +59,8 @@ bool WebSocketClient::Connect()
     if (IsConnected())
         return false;
 
+    _reconnect = true;
+
     // Post the connect routine
     auto self(this->shared_from_this());
     _service->service()->post([this, self]()
@@ -119,10 +124,22 @@ void WebSocketClient::Connected(websocketpp::connection_hdl connection)
     _connection = connection;
     _connected = true;
 
+    // Reset reconnect attempts
+    _reconnect_policy.Reset();
+
     // Call the client connected handler
     onConnected();
 }
 
+bool WebSocketClient::Disconnect(websocketpp::close::status::value code, const std::string& reason)
+{
+    // Stop automatic reconnect
+    _reconnect = false;
+    CancelReconnect();
+
+    return Disconnect(false, code, reason);
+}
+
 bool WebSocketClient::Disconnect(bool dispatch, websocketpp::close::status::value code, const std::string& reason)
 {
     if (!IsConnected())
@@ -155,17 +172,68 @@ void WebSocketClient::Disconnected(websocketpp::connection_hdl connection)
 
     // Call the client disconnected handler
     onDisconnected();
+
+    // Connect the client again requested by Reconnect() or try to connect it again automatically
+    if (_reconnecting.exchange(false) && _reconnect)
+        Connect();
+    else
+        ScheduleReconnect();
 }
 
 bool WebSocketClient::Reconnect()
 {
-    if (!Disconnect())
+    if (!IsConnected())
+        return false;
+
+    // Connect the client again when its connection is closed
+    _reconnect = true;
+    _reconnecting = true;
+    if (!Disconnect(false))
+    {
+        _reconnecting = false;
         return false;
+    }
 
-    while (IsConnected())
-        CppCommon::Thread::Yield();
+    return true;
+}
 
-    return Connect();
+void WebSocketClient::ScheduleReconnect()
+{
+    if (!_reconnect)
+        return;
+
+    // Get the delay of the next reconnect attempt
+    std::chrono::steady_clock::duration delay;
+    if (!_reconnect_policy.Next(delay))
+        return;
+
+    // Call the client reconnecting handler
+    onReconnecting(_reconnect_policy.attempt(), delay);
+
+    // Check for reconnect stopped by the handler
+    if (!_reconnect)
+        return;
+
+    auto self(this->shared_from_this());
+    _reconnect_timer = _service->Schedule(delay, [this, self]()
+    {
+        _reconnect_timer = 0;
+
+        // Connect the client again unless reconnect was stopped
+        if (_reconnect)
+            Connect();
+    });
+
+    // Cancel the reconnect timer scheduled concurrently with the client disconnect
+    if (!_reconnect)
+        CancelReconnect();
+}
+
+void WebSocketClient::CancelReconnect()
+{
+    TimerId id = _reconnect_timer.exchange(0);
+    if (id != 0)
+        _service->Cancel(id);
 }
 
 size_t WebSocketClient::Send(const void* buffer, size_t size, websocketpp::frame::opcode::value opcode)
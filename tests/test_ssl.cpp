@@ -5,6 +5,7 @@
 #include "catch.hpp"
 
 #include "server/asio/ssl_client.h"
+#include "server/asio/ssl_client_pool.h"
 #include "server/asio/ssl_server.h"
 #include "threads/thread.h"
 
@@ -41,7 +42,7 @@ protected:
     void onStarted() override { started = true; }
     void onStopped() override { stopped = true; }
     void onIdle() override { idle = true; }
-    void onError(int error, const std::string& category, const std::string& message) override { error = true; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
 };
 
 class EchoSSLClient : public SSLClient
@@ -50,6 +51,8 @@ public:
     std::atomic<bool> connected;
     std::atomic<bool> handshaked;
     std::atomic<bool> disconnected;
+    std::atomic<size_t> handshakes;
+    std::atomic<size_t> reconnects;
     std::atomic<bool> error;
 
     explicit EchoSSLClient(std::shared_ptr<EchoSSLService> service, std::shared_ptr<asio::ssl::context> context, const std::string& address, int port)
@@ -57,6 +60,8 @@ public:
           connected(false),
           handshaked(false),
           disconnected(false),
+          handshakes(0),
+          reconnects(0),
           error(false)
     {
     }
@@ -71,9 +76,10 @@ public:
 
 protected:
     void onConnected() override { connected = true; }
-    void onHandshaked() override { handshaked = true; }
+    void onHandshaked() override { handshaked = true; ++handshakes; }
     void onDisconnected() override { disconnected = true; }
-    void onError(int error, const std::string& category, const std::string& message) override { error = true; }
+    void onReconnecting(size_t attempt, const std::chrono::steady_clock::duration& delay) override { ++reconnects; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
 };
 
 class EchoSSLServer;
@@ -100,7 +106,7 @@ protected:
     void onHandshaked() override { handshaked = true; }
     void onDisconnected() override { disconnected = true; }
     size_t onReceived(const void* buffer, size_t size) override { Send(buffer, size); return size; }
-    void onError(int error, const std::string& category, const std::string& message) override { error = true; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
 };
 
 class EchoSSLServer : public SSLServer<EchoSSLServer, EchoSSLSession>
@@ -140,7 +146,7 @@ protected:
     void onStopped() override { stopped = true; }
     void onConnected(std::shared_ptr<EchoSSLSession>& session) override { connected = true; ++clients; }
     void onDisconnected(std::shared_ptr<EchoSSLSession>& session) override { disconnected = true; --clients; }
-    void onError(int error, const std::string& category, const std::string& message) override { error = true; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
 };
 
 TEST_CASE("SSL server", "[CppServer][Asio]")
@@ -350,6 +356,272 @@ TEST_CASE("SSL server multicast", "[CppServer][Asio]")
     REQUIRE(!client3->error);
 }
 
+TEST_CASE("SSL server with multi-threaded service", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 3336;
+
+    // Create and start Asio service with several working threads
+    auto service = std::make_shared<EchoSSLService>();
+    REQUIRE(service->Start(false, 4));
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and prepare a new SSL server context
+    auto server_context = EchoSSLServer::CreateContext();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoSSLServer>(service, server_context, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and prepare a new SSL client context
+    auto client_context = EchoSSLClient::CreateContext();
+
+    // Create and connect Echo clients
+    std::vector<std::shared_ptr<EchoSSLClient>> clients;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        auto client = std::make_shared<EchoSSLClient>(service, client_context, address, port);
+        REQUIRE(client->Connect());
+        clients.emplace_back(client);
+    }
+    for (auto& client : clients)
+        while (!client->IsConnected() || !client->IsHandshaked())
+            Thread::Yield();
+    while (server->clients != clients.size())
+        Thread::Yield();
+
+    // Send a lot of messages from each client to the Echo server
+    for (size_t i = 0; i < 1000; ++i)
+        for (auto& client : clients)
+            client->Send("test");
+
+    // Wait for all data processed...
+    for (auto& client : clients)
+        while (client->bytes_received() != 4000)
+            Thread::Yield();
+
+    // Disconnect Echo clients
+    for (auto& client : clients)
+        REQUIRE(client->Disconnect());
+    for (auto& client : clients)
+        while (client->IsConnected() || client->IsHandshaked())
+            Thread::Yield();
+    while (server->clients != 0)
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->started);
+    REQUIRE(server->stopped);
+    REQUIRE(server->connected);
+    REQUIRE(server->disconnected);
+    REQUIRE(server->bytes_sent() == 32000);
+    REQUIRE(server->bytes_received() == 32000);
+    REQUIRE(!server->error);
+
+    // Check the Echo clients state
+    for (auto& client : clients)
+    {
+        REQUIRE(client->connected);
+        REQUIRE(client->handshaked);
+        REQUIRE(client->disconnected);
+        REQUIRE(client->bytes_sent() == 4000);
+        REQUIRE(client->bytes_received() == 4000);
+        REQUIRE(!client->error);
+    }
+}
+
+TEST_CASE("SSL server graceful stop", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 3337;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoSSLService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and prepare a new SSL server context
+    auto server_context = EchoSSLServer::CreateContext();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoSSLServer>(service, server_context, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and prepare a new SSL client context
+    auto client_context = EchoSSLClient::CreateContext();
+
+    // Create and connect Echo clients
+    auto client1 = std::make_shared<EchoSSLClient>(service, client_context, address, port);
+    auto client2 = std::make_shared<EchoSSLClient>(service, client_context, address, port);
+    REQUIRE(client1->Connect());
+    REQUIRE(client2->Connect());
+    while (!client1->IsHandshaked() || !client2->IsHandshaked() || (server->clients != 2))
+        Thread::Yield();
+
+    // Wait for echoes, so server sessions are handshaked too
+    client1->Send("test");
+    client2->Send("test");
+    while ((client1->bytes_received() != 4) || (client2->bytes_received() != 4))
+        Thread::Yield();
+
+    // Fill send buffers of all sessions and stop the Echo server gracefully.
+    // Sessions which do not complete SSL shutdown are aborted after the drain timeout.
+    auto message = std::make_shared<const Buffer>(1048576, 'x');
+    REQUIRE(server->Multicast(message));
+    REQUIRE(server->Stop(std::chrono::seconds(1)));
+
+    // Wait for the Echo server stopped without spinning...
+    server->WaitStopped();
+    REQUIRE(!server->IsStarted());
+    REQUIRE(!server->IsDraining());
+    REQUIRE(server->stopped);
+    REQUIRE(server->clients == 0);
+
+    // Both clients are disconnected by the server after they received all data
+    while (client1->IsConnected() || client2->IsConnected())
+        Thread::Yield();
+    REQUIRE(client1->bytes_received() == (message->size() + 4));
+    REQUIRE(client2->bytes_received() == (message->size() + 4));
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->bytes_sent() == (2 * (message->size() + 4)));
+    REQUIRE(!server->error);
+}
+
+TEST_CASE("SSL client reconnect", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 3338;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoSSLService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Connect the client with automatic reconnect before the Echo server is started
+    auto client_context = EchoSSLClient::CreateContext();
+    auto client = std::make_shared<EchoSSLClient>(service, client_context, address, port);
+    client->SetupReconnect(std::chrono::milliseconds(10), std::chrono::milliseconds(40));
+    REQUIRE(client->Connect());
+    while (client->reconnects < 3)
+        Thread::Yield();
+    REQUIRE(!client->IsHandshaked());
+
+    // Create and start Echo server. The client should be handshaked by the next attempt.
+    auto server_context = EchoSSLServer::CreateContext();
+    auto server = std::make_shared<EchoSSLServer>(service, server_context, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+    while ((client->handshakes != 1) || !client->IsHandshaked())
+        Thread::Yield();
+
+    // Reconnect the client without waiting for the disconnect
+    REQUIRE(client->Reconnect());
+    while ((client->handshakes != 2) || !client->IsHandshaked())
+        Thread::Yield();
+
+    // Disconnect the client. Automatic reconnect should be stopped.
+    size_t reconnects = client->reconnects;
+    REQUIRE(client->Disconnect());
+    while (client->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+    Thread::Sleep(100);
+    REQUIRE(!client->IsConnected());
+    REQUIRE(client->reconnects == reconnects);
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    server->WaitStopped();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    REQUIRE(!client->error);
+    REQUIRE(!server->error);
+}
+
+TEST_CASE("SSL client pool", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 3339;
+    const std::string message = "test";
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoSSLService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server
+    auto server_context = EchoSSLServer::CreateContext();
+    auto server = std::make_shared<EchoSSLServer>(service, server_context, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect the client pool with two connections per endpoint
+    auto client_context = EchoSSLClient::CreateContext();
+    auto pool = std::make_shared<SSLClientPool<>>(service, client_context, 2);
+    pool->SetupLoadBalancing(LoadBalancing::PowerOfTwo);
+    REQUIRE(pool->AddEndpoint(address, port));
+    REQUIRE(pool->Connect());
+    while ((pool->connected_clients() != 2) || (server->clients != 2))
+        Thread::Yield();
+    REQUIRE(pool->available_endpoints() == 1);
+
+    // Send messages through pool clients
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(pool->Send(message) > 0);
+    while (pool->bytes_received() != (100 * message.size()))
+        Thread::Yield();
+    REQUIRE(pool->statistics().messages_sent() == 100);
+
+    // Remove the endpoint. Sending through the pool should be rejected.
+    REQUIRE(pool->RemoveEndpoint(asio::ip::tcp::endpoint(asio::ip::address::from_string(address), port)));
+    REQUIRE(pool->clients() == 0);
+    while (server->clients != 0)
+        Thread::Yield();
+    REQUIRE(pool->Send(message) == 0);
+    REQUIRE(pool->statistics().errors() == 1);
+    REQUIRE(pool->Disconnect());
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    server->WaitStopped();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    REQUIRE(!server->error);
+}
+
 TEST_CASE("SSL server random test", "[CppServer][Asio]")
 {
     const std::string address = "127.0.0.1";
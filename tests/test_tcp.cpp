@@ -4,12 +4,18 @@
 
 #include "catch.hpp"
 
+#include "server/asio/framed_tcp_client.h"
+#include "server/asio/framed_tcp_session.h"
+#include "server/asio/service_pool.h"
 #include "server/asio/tcp_client.h"
+#include "server/asio/tcp_client_pool.h"
 #include "server/asio/tcp_server.h"
 #include "threads/thread.h"
 
 #include <atomic>
 #include <chrono>
+#include <ctime>
+#include <thread>
 #include <vector>
 
 using namespace CppCommon;
@@ -41,7 +47,7 @@ protected:
     void onStarted() override { started = true; }
     void onStopped() override { stopped = true; }
     void onIdle() override { idle = true; }
-    void onError(int error, const std::string& category, const std::string& message) override { error = true; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
 };
 
 class EchoTCPClient : public TCPClient
@@ -49,47 +55,136 @@ class EchoTCPClient : public TCPClient
 public:
     std::atomic<bool> connected;
     std::atomic<bool> disconnected;
+    std::atomic<size_t> connects;
+    std::atomic<size_t> disconnects;
+    std::atomic<size_t> reconnects;
+    std::atomic<bool> delays_valid;
+    std::atomic<bool> full;
+    std::atomic<bool> drained;
+    std::atomic<size_t> frames;
     std::atomic<bool> error;
 
-    explicit EchoTCPClient(std::shared_ptr<EchoTCPService> service, const std::string& address, int port)
+    explicit EchoTCPClient(std::shared_ptr<Service> service, const std::string& address, int port, size_t frame = 0)
         : TCPClient(service, address, port),
           connected(false),
           disconnected(false),
-          error(false)
+          connects(0),
+          disconnects(0),
+          reconnects(0),
+          delays_valid(true),
+          full(false),
+          drained(false),
+          frames(0),
+          error(false),
+          _frame(frame)
+    {
+    }
+
+    explicit EchoTCPClient(std::shared_ptr<Service> service, const asio::ip::tcp::endpoint& endpoint)
+        : TCPClient(service, endpoint),
+          connected(false),
+          disconnected(false),
+          connects(0),
+          disconnects(0),
+          reconnects(0),
+          delays_valid(true),
+          full(false),
+          drained(false),
+          frames(0),
+          error(false),
+          _frame(0)
     {
     }
 
 protected:
-    void onConnected() override { connected = true; }
-    void onDisconnected() override { disconnected = true; }
-    void onError(int error, const std::string& category, const std::string& message) override { error = true; }
+    void onConnected() override { connected = true; ++connects; }
+    void onDisconnected() override { disconnected = true; ++disconnects; }
+    void onReconnecting(size_t attempt, const std::chrono::steady_clock::duration& delay) override
+    {
+        ++reconnects;
+
+        // Delay with jitter should be between a half of the minimal delay and the maximal delay
+        if ((delay < option_reconnect_delay_min() / 2) || (delay > option_reconnect_delay_max()))
+            delays_valid = false;
+    }
+    size_t onReceived(const void* buffer, size_t size) override
+    {
+        if (_frame == 0)
+            return size;
+
+        // Handle only complete frames and keep the rest in the receive buffer
+        frames += size / _frame;
+        return size - (size % _frame);
+    }
+    void onSendBufferFull() override { full = true; }
+    void onSendBufferDrained() override { drained = true; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
+
+private:
+    size_t _frame;
+};
+
+class EchoTCPClientPool : public TCPClientPool<EchoTCPClient>
+{
+public:
+    using TCPClientPool<EchoTCPClient>::TCPClientPool;
+
+protected:
+    std::shared_ptr<EchoTCPClient> CreateClient(std::shared_ptr<Service>& service, const asio::ip::tcp::endpoint& endpoint) override
+    {
+        auto client = TCPClientPool<EchoTCPClient>::CreateClient(service, endpoint);
+        client->SetupReconnect(std::chrono::milliseconds(10), std::chrono::milliseconds(40));
+        return client;
+    }
 };
 
-class EchoTCPServer;
+template <class TSession>
+class TestTCPServer;
 
-class EchoTCPSession : public TCPSession<EchoTCPServer, EchoTCPSession>
+std::atomic<size_t> echo_sessions_created(0);
+std::atomic<size_t> echo_sessions_reset(0);
+std::atomic<size_t> echo_sessions_idle(0);
+std::atomic<bool> echo_sessions_dirty(false);
+
+class EchoTCPSession : public TCPSession<TestTCPServer<EchoTCPSession>, EchoTCPSession>
 {
 public:
     std::atomic<bool> connected;
     std::atomic<bool> disconnected;
     std::atomic<bool> error;
+    size_t echoed;
 
-    explicit EchoTCPSession(std::shared_ptr<TCPServer<EchoTCPServer, EchoTCPSession>> server, asio::ip::tcp::socket&& socket)
-        : TCPSession<EchoTCPServer, EchoTCPSession>(server, std::move(socket)),
+    explicit EchoTCPSession(std::shared_ptr<TCPServer<TestTCPServer<EchoTCPSession>, EchoTCPSession>> server, asio::ip::tcp::socket&& socket)
+        : TCPSession<TestTCPServer<EchoTCPSession>, EchoTCPSession>(server, std::move(socket)),
           connected(false),
           disconnected(false),
-          error(false)
+          error(false),
+          echoed(0)
     {
+        ++echo_sessions_created;
     }
 
 protected:
-    void onConnected() override { connected = true; }
+    void onConnected() override { connected = true; if (echoed != 0) echo_sessions_dirty = true; }
     void onDisconnected() override { disconnected = true; }
-    size_t onReceived(const void* buffer, size_t size) override { Send(buffer, size); return size; }
-    void onError(int error, const std::string& category, const std::string& message) override { error = true; }
+    void onReset() override { echoed = 0; ++echo_sessions_reset; }
+    size_t onReceived(const void* buffer, size_t size) override { echoed += size; Send(buffer, size); return size; }
+    void onIdleTimeout() override { ++echo_sessions_idle; }
+    void onSendBufferFull() override { if (server()->FindSession(id()) == nullptr) error = true; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
 };
 
-class EchoTCPServer : public TCPServer<EchoTCPServer, EchoTCPSession>
+class FramedEchoTCPSession : public FramedTCPSession<TestTCPServer<FramedEchoTCPSession>, FramedEchoTCPSession>
+{
+public:
+    using FramedTCPSession<TestTCPServer<FramedEchoTCPSession>, FramedEchoTCPSession>::FramedTCPSession;
+
+protected:
+    void onMessage(const void* buffer, size_t size) override { SendMessage(buffer, size); }
+};
+
+template <class TSession>
+class TestTCPServer : public TCPServer<TestTCPServer<TSession>, TSession>
 {
 public:
     std::atomic<bool> started;
@@ -97,15 +192,17 @@ public:
     std::atomic<bool> connected;
     std::atomic<bool> disconnected;
     std::atomic<size_t> clients;
+    std::atomic<SessionId> last_session;
     std::atomic<bool> error;
 
-    explicit EchoTCPServer(std::shared_ptr<EchoTCPService> service, InternetProtocol protocol, int port)
-        : TCPServer<EchoTCPServer, EchoTCPSession>(service, protocol, port),
+    explicit TestTCPServer(std::shared_ptr<EchoTCPService> service, InternetProtocol protocol, int port)
+        : TCPServer<TestTCPServer<TSession>, TSession>(service, protocol, port),
           started(false),
           stopped(false),
           connected(false),
           disconnected(false),
           clients(0),
+          last_session(0),
           error(false)
     {
     }
@@ -113,11 +210,74 @@ public:
 protected:
     void onStarted() override { started = true; }
     void onStopped() override { stopped = true; }
-    void onConnected(std::shared_ptr<EchoTCPSession>& session) override { connected = true; ++clients; }
-    void onDisconnected(std::shared_ptr<EchoTCPSession>& session) override { disconnected = true; --clients; }
-    void onError(int error, const std::string& category, const std::string& message) override { error = true; }
+    void onConnected(std::shared_ptr<TSession>& session) override { connected = true; last_session = session->id(); ++clients; }
+    void onDisconnected(std::shared_ptr<TSession>& session) override { disconnected = true; --clients; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
+};
+
+typedef TestTCPServer<EchoTCPSession> EchoTCPServer;
+typedef TestTCPServer<FramedEchoTCPSession> FramedEchoTCPServer;
+
+class FramedEchoTCPClient : public FramedTCPClient<>
+{
+public:
+    std::atomic<size_t> messages;
+    std::atomic<size_t> message_bytes;
+    std::atomic<bool> error;
+
+    explicit FramedEchoTCPClient(std::shared_ptr<EchoTCPService> service, const std::string& address, int port)
+        : FramedTCPClient<>(service, address, port),
+          messages(0),
+          message_bytes(0),
+          error(false)
+    {
+    }
+
+protected:
+    void onMessage(const void* buffer, size_t size) override { ++messages; message_bytes += size; }
+    void onError(int code, const std::string& category, const std::string& message) override { error = true; }
 };
 
+// Connect the given count of Echo clients to the Echo server
+std::vector<std::shared_ptr<EchoTCPClient>> ConnectEchoClients(std::shared_ptr<EchoTCPService> service, std::shared_ptr<EchoTCPServer> server, const std::string& address, int port, size_t count)
+{
+    std::vector<std::shared_ptr<EchoTCPClient>> clients;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto client = std::make_shared<EchoTCPClient>(service, address, port);
+        REQUIRE(client->Connect());
+        clients.emplace_back(client);
+    }
+    for (auto& client : clients)
+        while (!client->IsConnected())
+            Thread::Yield();
+    while (server->clients != clients.size())
+        Thread::Yield();
+    return clients;
+}
+
+// Send the given count of messages from each Echo client and wait for all of them echoed
+void EchoMessages(const std::vector<std::shared_ptr<EchoTCPClient>>& clients, size_t messages)
+{
+    for (size_t i = 0; i < messages; ++i)
+        for (auto& client : clients)
+            client->Send("test");
+    for (auto& client : clients)
+        while (client->bytes_received() != (4 * messages))
+            Thread::Yield();
+}
+
+// Disconnect all Echo clients from the server side
+void DisconnectEchoClients(std::shared_ptr<EchoTCPServer> server, const std::vector<std::shared_ptr<EchoTCPClient>>& clients)
+{
+    REQUIRE(server->DisconnectAll());
+    while (server->clients != 0)
+        Thread::Yield();
+    for (auto& client : clients)
+        while (client->IsConnected())
+            Thread::Yield();
+}
+
 TEST_CASE("TCP server", "[CppServer][Asio]")
 {
     const std::string address = "127.0.0.1";
@@ -141,6 +301,12 @@ TEST_CASE("TCP server", "[CppServer][Asio]")
     while (!client->IsConnected() || (server->clients != 1))
         Thread::Yield();
 
+    // Find the connected session by its Id
+    SessionId id = server->last_session;
+    REQUIRE(id != 0);
+    REQUIRE(server->FindSession(id) != nullptr);
+    REQUIRE(server->FindSession(id)->id() == id);
+
     // Send a message to the Echo server
     client->Send("test");
 
@@ -153,6 +319,21 @@ TEST_CASE("TCP server", "[CppServer][Asio]")
     while (client->IsConnected() || (server->clients != 0))
         Thread::Yield();
 
+    // Check the disconnected session Id is not found
+    REQUIRE(server->FindSession(id) == nullptr);
+
+    // Connect another Echo client into the same registry slot with a new Id
+    auto client2 = std::make_shared<EchoTCPClient>(service, address, port);
+    REQUIRE(client2->Connect());
+    while (!client2->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+    REQUIRE(server->last_session != id);
+    REQUIRE(server->FindSession(id) == nullptr);
+    REQUIRE(server->FindSession(server->last_session) != nullptr);
+    REQUIRE(client2->Disconnect());
+    while (client2->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+
     // Stop the Echo server
     REQUIRE(server->Stop());
     while (server->IsStarted())
@@ -178,6 +359,11 @@ TEST_CASE("TCP server", "[CppServer][Asio]")
     REQUIRE(server->disconnected);
     REQUIRE(server->bytes_sent() == 4);
     REQUIRE(server->bytes_received() == 4);
+    REQUIRE(server->statistics().messages_sent() == 1);
+    REQUIRE(server->statistics().messages_received() == 1);
+    REQUIRE(server->statistics().connects() == 2);
+    REQUIRE(server->statistics().disconnects() == 2);
+    REQUIRE(server->statistics().errors() == 0);
     REQUIRE(!server->error);
 
     // Check the Echo client state
@@ -312,6 +498,1477 @@ TEST_CASE("TCP server multicast", "[CppServer][Asio]")
     REQUIRE(!client3->error);
 }
 
+TEST_CASE("TCP server multicast into full send buffers", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1133;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server. Its sessions find themselves in the server
+    // when their send buffers become full by the multicast.
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    server->SetupSendBufferWatermarks(4, 0);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo clients
+    auto client1 = std::make_shared<EchoTCPClient>(service, address, port);
+    auto client2 = std::make_shared<EchoTCPClient>(service, address, port);
+    REQUIRE(client1->Connect());
+    REQUIRE(client2->Connect());
+    while (!client1->IsConnected() || !client2->IsConnected() || (server->clients != 2))
+        Thread::Yield();
+
+    // Multicast some data to all clients
+    REQUIRE(server->Multicast("test"));
+    while ((client1->bytes_received() != 4) || (client2->bytes_received() != 4))
+        Thread::Yield();
+
+    // Disconnect all clients by the server
+    REQUIRE(server->DisconnectAll());
+    while (client1->IsConnected() || client2->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    REQUIRE(!client1->error);
+    REQUIRE(!client2->error);
+    REQUIRE(!server->error);
+}
+
+TEST_CASE("TCP server with service pool", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1114;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Asio service pool
+    auto pool = std::make_shared<ServicePool>(4);
+    REQUIRE(pool->Start());
+    while (!pool->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server with sessions placed into the service pool
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    server->SetupServicePool(pool);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo clients
+    auto clients = ConnectEchoClients(service, server, address, port, 8);
+
+    // Echo a message from each client
+    EchoMessages(clients, 1);
+
+    // Multicast some data to all clients
+    server->Multicast("test");
+
+    // Wait for all data processed...
+    for (auto& client : clients)
+        while (client->bytes_received() != 8)
+            Thread::Yield();
+
+    // Disconnect all clients from the server side
+    DisconnectEchoClients(server, clients);
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service pool
+    REQUIRE(pool->Stop());
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->started);
+    REQUIRE(server->stopped);
+    REQUIRE(server->connected);
+    REQUIRE(server->disconnected);
+    REQUIRE(server->bytes_received() == 32);
+    REQUIRE(!server->error);
+
+    // Check the Echo clients state
+    for (auto& client : clients)
+    {
+        REQUIRE(client->connected);
+        REQUIRE(client->disconnected);
+        REQUIRE(client->bytes_sent() == 4);
+        REQUIRE(client->bytes_received() == 8);
+        REQUIRE(!client->error);
+    }
+}
+
+TEST_CASE("TCP server with outstanding accepts", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1123;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Asio service pool
+    auto pool = std::make_shared<ServicePool>(4);
+    REQUIRE(pool->Start());
+    while (!pool->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server with several outstanding accepts and a short backlog
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    server->SetupServicePool(pool);
+    server->SetupAcceptBacklog(16);
+    server->SetupAcceptConcurrency(4);
+    REQUIRE(server->option_accept_backlog() == 16);
+    REQUIRE(server->option_accept_concurrency() == 4);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Connect a storm of Echo clients at once
+    auto clients = ConnectEchoClients(service, server, address, port, 32);
+
+    // Echo a message from each client
+    EchoMessages(clients, 1);
+
+    // Disconnect all clients from the server side
+    DisconnectEchoClients(server, clients);
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service pool
+    REQUIRE(pool->Stop());
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->statistics().connects() == clients.size());
+    REQUIRE(server->statistics().disconnects() == clients.size());
+    REQUIRE(server->bytes_received() == (clients.size() * 4));
+    REQUIRE(!server->error);
+
+    // Check the Echo clients state
+    for (auto& client : clients)
+    {
+        REQUIRE(client->bytes_received() == 4);
+        REQUIRE(!client->error);
+    }
+}
+
+TEST_CASE("TCP server with reuse port acceptors", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1115;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Asio service pool
+    auto pool = std::make_shared<ServicePool>(4);
+    REQUIRE(pool->Start());
+    while (!pool->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server with one reuse port acceptor per pool service
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    server->SetupServicePool(pool);
+    server->SetupReusePort(true);
+    REQUIRE(server->option_reuse_port());
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo clients
+    auto clients = ConnectEchoClients(service, server, address, port, 16);
+
+    // Echo a message from each client
+    EchoMessages(clients, 1);
+
+    // Disconnect all clients from the server side
+    DisconnectEchoClients(server, clients);
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service pool
+    REQUIRE(pool->Stop());
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->started);
+    REQUIRE(server->stopped);
+    REQUIRE(server->connected);
+    REQUIRE(server->disconnected);
+    REQUIRE(server->bytes_received() == 64);
+    REQUIRE(!server->error);
+
+    // Check the Echo clients state
+    for (auto& client : clients)
+    {
+        REQUIRE(client->connected);
+        REQUIRE(client->disconnected);
+        REQUIRE(client->bytes_sent() == 4);
+        REQUIRE(client->bytes_received() == 4);
+        REQUIRE(!client->error);
+    }
+}
+
+TEST_CASE("TCP server with multi-threaded service", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1116;
+
+    // Create and start Asio service with several working threads
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start(false, 4));
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo clients
+    auto clients = ConnectEchoClients(service, server, address, port, 8);
+
+    // Echo a lot of messages from each client
+    EchoMessages(clients, 1000);
+
+    // Disconnect all clients from the server side
+    DisconnectEchoClients(server, clients);
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->started);
+    REQUIRE(server->stopped);
+    REQUIRE(server->connected);
+    REQUIRE(server->disconnected);
+    REQUIRE(server->bytes_sent() == 32000);
+    REQUIRE(server->bytes_received() == 32000);
+    REQUIRE(!server->error);
+
+    // Check the Echo clients state
+    for (auto& client : clients)
+    {
+        REQUIRE(client->connected);
+        REQUIRE(client->disconnected);
+        REQUIRE(client->bytes_sent() == 4000);
+        REQUIRE(client->bytes_received() == 4000);
+        REQUIRE(!client->error);
+    }
+}
+
+TEST_CASE("TCP server shared buffers", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1117;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo clients
+    auto client1 = std::make_shared<EchoTCPClient>(service, address, port);
+    auto client2 = std::make_shared<EchoTCPClient>(service, address, port);
+    REQUIRE(client1->Connect());
+    REQUIRE(client2->Connect());
+    while (!client1->IsConnected() || !client2->IsConnected() || (server->clients != 2))
+        Thread::Yield();
+
+    // Send copied and shared buffers from the same client
+    auto shared = std::make_shared<const Buffer>(Buffer{ 't', 'e', 's', 't' });
+    client1->Send("test");
+    client1->Send(shared);
+    client1->Send("test");
+    client1->Send(shared);
+
+    // Wait for all data processed...
+    while (client1->bytes_received() != 16)
+        Thread::Yield();
+
+    // Multicast the same shared buffer to all clients
+    REQUIRE(server->Multicast(shared));
+
+    // Wait for all data processed...
+    while ((client1->bytes_received() != 20) || (client2->bytes_received() != 4))
+        Thread::Yield();
+
+    // Disconnect Echo clients
+    REQUIRE(client1->Disconnect());
+    REQUIRE(client2->Disconnect());
+    while (client1->IsConnected() || client2->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the shared buffer is released by all sessions and clients
+    REQUIRE(shared.use_count() == 1);
+
+    // Check the Echo server state
+    REQUIRE(server->bytes_sent() == 24);
+    REQUIRE(server->bytes_received() == 16);
+    REQUIRE(!server->error);
+
+    // Check the Echo clients state
+    REQUIRE(client1->bytes_sent() == 16);
+    REQUIRE(client1->bytes_received() == 20);
+    REQUIRE(client2->bytes_received() == 4);
+    REQUIRE(!client1->error);
+    REQUIRE(!client2->error);
+}
+
+TEST_CASE("TCP server partial receive", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1118;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect frame client with frames larger than the maximal receive size
+    const size_t frame = 10000;
+    auto client = std::make_shared<EchoTCPClient>(service, address, port, frame);
+    client->SetupBufferLimits(256, 2048);
+    REQUIRE(client->Connect());
+    while (!client->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+
+    // Send frames split into small messages
+    std::vector<uint8_t> message(1000, 'x');
+    for (size_t i = 0; i < 100; ++i)
+        client->Send(message.data(), message.size());
+
+    // Wait for all frames received...
+    while (client->frames != 10)
+        Thread::Yield();
+
+    // Disconnect the frame client
+    REQUIRE(client->Disconnect());
+    while (client->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->bytes_sent() == 100000);
+    REQUIRE(server->bytes_received() == 100000);
+    REQUIRE(!server->error);
+
+    // Check the frame client state
+    REQUIRE(client->bytes_sent() == 100000);
+    REQUIRE(client->bytes_received() == 100000);
+    REQUIRE(!client->error);
+}
+
+TEST_CASE("TCP server send buffer watermarks", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1119;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect watermark client
+    auto client = std::make_shared<EchoTCPClient>(service, address, port);
+    client->SetupSendBufferWatermarks(65536, 16384);
+    REQUIRE(client->Connect());
+    while (!client->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+
+    // Fill the send buffer above the high watermark
+    std::vector<uint8_t> message(1048576, 'x');
+    REQUIRE(client->Send(message.data(), message.size()) == message.size());
+
+    // Wait for the send buffer drained and all data processed...
+    while (!client->drained || (client->bytes_received() != message.size()))
+        Thread::Yield();
+
+    // Send buffer accepts data again after it was drained
+    REQUIRE(client->Send("test") > 0);
+    while (client->bytes_received() != (message.size() + 4))
+        Thread::Yield();
+
+    // Disconnect the watermark client
+    REQUIRE(client->Disconnect());
+    while (client->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the watermark client state
+    REQUIRE(client->full);
+    REQUIRE(client->drained);
+    REQUIRE(client->bytes_sent() == (message.size() + 4));
+    REQUIRE(!client->error);
+}
+
+TEST_CASE("TCP server framed messages", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1120;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start framed Echo server
+    auto server = std::make_shared<FramedEchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect framed Echo client
+    auto client = std::make_shared<FramedEchoTCPClient>(service, address, port);
+    REQUIRE(client->Connect());
+    while (!client->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+
+    // Send messages of different sizes including the empty one
+    size_t total = 0;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        std::string message(i % 100, 'x');
+        REQUIRE(client->SendMessage(message) > 0);
+        total += message.size();
+    }
+
+    // Wait for all messages processed...
+    while (client->messages != 1000)
+        Thread::Yield();
+
+    // Disconnect the framed Echo client
+    REQUIRE(client->Disconnect());
+    while (client->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+
+    // Stop the framed Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the framed Echo server state
+    REQUIRE(server->bytes_received() == (total + 4 * 1000));
+    REQUIRE(!server->error);
+
+    // Check the framed Echo client state
+    REQUIRE(client->message_bytes == total);
+    REQUIRE(client->bytes_received() == (total + 4 * 1000));
+    REQUIRE(!client->error);
+}
+
+TEST_CASE("TCP server concurrent producers", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1121;
+
+    const int producers = 4;
+    const int messages = 1000;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo client
+    auto client = std::make_shared<EchoTCPClient>(service, address, port);
+    REQUIRE(client->Connect());
+    while (!client->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+
+    // Send copied and shared buffers into the same client from several producer threads
+    auto shared = std::make_shared<const Buffer>(Buffer{ 't', 'e', 's', 't' });
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; ++i)
+    {
+        threads.push_back(std::thread([client, shared, messages]()
+        {
+            for (int j = 0; j < messages; ++j)
+            {
+                if ((j % 2) == 0)
+                    client->Send("test");
+                else
+                    client->Send(shared);
+            }
+        }));
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // Wait for all data processed...
+    while (client->bytes_received() != (producers * messages * 4))
+        Thread::Yield();
+
+    // Disconnect Echo client
+    REQUIRE(client->Disconnect());
+    while (client->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the shared buffer is released by the client
+    REQUIRE(shared.use_count() == 1);
+
+    // Check the Echo server state
+    REQUIRE(server->bytes_sent() == (producers * messages * 4));
+    REQUIRE(server->bytes_received() == (producers * messages * 4));
+    REQUIRE(!server->error);
+
+    // Check the Echo client state
+    REQUIRE(client->bytes_sent() == (producers * messages * 4));
+    REQUIRE(client->bytes_received() == (producers * messages * 4));
+    REQUIRE(!client->error);
+}
+
+TEST_CASE("TCP server session pool", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1122;
+
+    const size_t cycles = 10;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Sessions are counted by all tests
+    size_t created = echo_sessions_created;
+    size_t reset = echo_sessions_reset;
+
+    // Create and start the server with the session pool
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    server->SetupSessionPool(1);
+    REQUIRE(server->option_session_pool() == 1);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Connect, echo and disconnect clients one by one
+    for (size_t i = 0; i < cycles; ++i)
+    {
+        auto client = std::make_shared<EchoTCPClient>(service, address, port);
+        REQUIRE(client->Connect());
+        while (!client->IsConnected() || (server->clients != 1))
+            Thread::Yield();
+
+        client->Send("test");
+        while (client->bytes_received() != 4)
+            Thread::Yield();
+
+        REQUIRE(client->Disconnect());
+        while (client->IsConnected() || (server->clients != 0))
+            Thread::Yield();
+
+        // Wait for the disconnected session released into the session pool
+        while (echo_sessions_reset != (reset + i + 1))
+            Thread::Yield();
+
+        REQUIRE(!client->error);
+    }
+
+    // Stop the server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check all connections reused the single pooled session with the cleared user state
+    REQUIRE(echo_sessions_created == (created + 1));
+    REQUIRE(echo_sessions_reset == (reset + cycles));
+    REQUIRE(!echo_sessions_dirty);
+
+    // Check the server state
+    REQUIRE(server->bytes_sent() == (cycles * 4));
+    REQUIRE(server->bytes_received() == (cycles * 4));
+    REQUIRE(!server->error);
+}
+
+TEST_CASE("Asio service scheduled handlers", "[CppServer][Asio]")
+{
+    // Create and start Asio service with several working threads
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start(false, 4));
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Schedule a lot of handlers with different delays
+    std::atomic<size_t> called(0);
+    std::atomic<size_t> early(0);
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        auto delay = std::chrono::milliseconds(i % 100);
+        auto scheduled = std::chrono::steady_clock::now();
+        REQUIRE(service->Schedule(delay, [&called, &early, delay, scheduled]()
+        {
+            if ((std::chrono::steady_clock::now() - scheduled) < delay)
+                ++early;
+            ++called;
+        }) != 0);
+    }
+
+    // Schedule and cancel a handler
+    std::atomic<bool> cancelled(true);
+    TimerId id = service->Schedule(std::chrono::milliseconds(10), [&cancelled]() { cancelled = false; });
+    REQUIRE(service->Cancel(id));
+    REQUIRE(!service->Cancel(id));
+
+    // Wait for all scheduled handlers called...
+    while (called != 10000)
+        Thread::Yield();
+
+    // Schedule a handler which cancels timers when it is destroyed by the stopped service
+    std::atomic<bool> destroyed(false);
+    {
+        Service* raw = service.get();
+        std::shared_ptr<void> guard(nullptr, [raw, id, &destroyed](void*) { raw->Cancel(id); destroyed = true; });
+        REQUIRE(service->Schedule(std::chrono::hours(1), [guard]() {}) != 0);
+    }
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+    REQUIRE(destroyed);
+
+    // Restart the Asio service. Scheduled handlers should be called again.
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+    std::atomic<bool> restarted(false);
+    REQUIRE(service->Schedule(std::chrono::milliseconds(10), [&restarted]() { restarted = true; }) != 0);
+    while (!restarted)
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check scheduled handlers are never called before their delays
+    REQUIRE(early == 0);
+    REQUIRE(cancelled);
+    REQUIRE(!service->error);
+}
+
+TEST_CASE("Asio service restart with armed timer", "[CppServer][Asio]")
+{
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Arm the timer wheel and stop the Asio service
+    REQUIRE(service->Schedule(std::chrono::hours(1), []() {}) != 0);
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Arm the timer wheel of the stopped service again, so the cancelled wait
+    // of the previous run is completed after the current wait is started
+    std::atomic<bool> called(false);
+    REQUIRE(service->Schedule(std::chrono::milliseconds(300), [&called]() { called = true; }) != 0);
+
+    // Restart the Asio service
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // The idle service should not spin on cancelled waits of the timer wheel
+    std::clock_t start = std::clock();
+    Thread::Sleep(200);
+    double elapsed = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+    REQUIRE(elapsed < 0.1);
+
+    // Wait for the scheduled handler called...
+    while (!called)
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    REQUIRE(!service->error);
+}
+
+TEST_CASE("TCP server idle timeout", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1124;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server with the idle timeout
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    server->SetupIdleTimeout(std::chrono::milliseconds(100));
+    REQUIRE(server->option_idle_timeout() == std::chrono::milliseconds(100));
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect active and idle Echo clients
+    auto active = std::make_shared<EchoTCPClient>(service, address, port);
+    auto idle = std::make_shared<EchoTCPClient>(service, address, port);
+    REQUIRE(active->Connect());
+    REQUIRE(idle->Connect());
+    while (!active->IsConnected() || !idle->IsConnected() || (server->clients != 2))
+        Thread::Yield();
+
+    // Keep the active client busy longer than the idle timeout
+    for (size_t i = 0; i < 10; ++i)
+    {
+        active->Send("test");
+        Thread::Sleep(30);
+    }
+
+    // Wait for the idle client disconnected by the server...
+    while (idle->IsConnected())
+        Thread::Yield();
+    REQUIRE(active->IsConnected());
+    REQUIRE(echo_sessions_idle == 1);
+
+    // Wait for the active client disconnected by the server when it becomes idle...
+    while (active->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+    REQUIRE(echo_sessions_idle == 2);
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->bytes_received() == 40);
+    REQUIRE(server->statistics().disconnects() == 2);
+    REQUIRE(!server->error);
+
+    // Check the Echo clients state
+    REQUIRE(active->bytes_received() == 40);
+    REQUIRE(idle->bytes_received() == 0);
+    REQUIRE(!active->error);
+    REQUIRE(!idle->error);
+}
+
+TEST_CASE("TCP server with adaptive polling service", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1125;
+
+    // Create and start Asio service in adaptive polling loop mode
+    auto service = std::make_shared<EchoTCPService>();
+    service->SetupAdaptivePolling(1000, 100);
+    REQUIRE(service->option_adaptive_spins() == 1000);
+    REQUIRE(service->option_adaptive_yields() == 100);
+    REQUIRE(service->Start(true, 2));
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo client
+    auto client = std::make_shared<EchoTCPClient>(service, address, port);
+    REQUIRE(client->Connect());
+    while (!client->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+
+    // Send messages with pauses, so the service becomes idle between them
+    for (size_t i = 0; i < 10; ++i)
+    {
+        client->Send("test");
+        while (client->bytes_received() != ((i + 1) * 4))
+            Thread::Yield();
+        Thread::Sleep(10);
+    }
+
+    // Disconnect Echo client
+    REQUIRE(client->Disconnect());
+    while (client->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the idle service passed all adaptive polling phases
+    REQUIRE(service->idle_spins() > 0);
+    REQUIRE(service->idle_yields() > 0);
+    REQUIRE(service->idle_blocks() > 0);
+    REQUIRE(service->idle);
+
+    // Check the Echo server state
+    REQUIRE(server->bytes_sent() == 40);
+    REQUIRE(server->bytes_received() == 40);
+    REQUIRE(!server->error);
+
+    // Check the Echo client state
+    REQUIRE(client->bytes_received() == 40);
+    REQUIRE(!client->error);
+}
+
+TEST_CASE("Asio handler storage", "[CppServer][Asio]")
+{
+    HandlerStorage storage;
+
+    // The first operation takes the storage and the next one falls back to the heap
+    void* first = storage.allocate(64);
+    void* second = storage.allocate(64);
+    REQUIRE(first != second);
+    storage.deallocate(second);
+    storage.deallocate(first);
+
+    // The released storage is reused and too large operations fall back to the heap
+    REQUIRE(storage.allocate(HandlerStorage::SIZE) == first);
+    void* large = storage.allocate(HandlerStorage::SIZE + 1);
+    REQUIRE(large != first);
+    storage.deallocate(large);
+    storage.deallocate(first);
+
+    // The allocate handler wrapper uses the storage through its allocator
+    auto handler = make_alloc_handler(storage, [](int value) { REQUIRE(value == 1); });
+    auto allocator = handler.get_allocator();
+    auto ptr = allocator.allocate(1);
+    REQUIRE((void*)ptr == first);
+    allocator.deallocate(ptr, 1);
+    handler(1);
+}
+
+TEST_CASE("CPU list parsing", "[CppServer][Asio]")
+{
+    REQUIRE(Affinity::ParseCpuList("").empty());
+    REQUIRE(Affinity::ParseCpuList("3") == std::vector<int>({ 3 }));
+    REQUIRE(Affinity::ParseCpuList("0-3,8,10-11") == std::vector<int>({ 0, 1, 2, 3, 8, 10, 11 }));
+    REQUIRE(Affinity::ParseCpuList("1,x,3-2,-1,5") == std::vector<int>({ 1, 5 }));
+    REQUIRE(!Affinity::NumaNodeCpus(0).empty());
+    REQUIRE(Affinity::NumaNodeCpus(-1).empty());
+    REQUIRE(Affinity::NumaNodes() > 0);
+}
+
+TEST_CASE("TCP server with pinned service pool", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1126;
+
+    // Create and start Asio service pinned to all CPUs of the first NUMA node
+    auto service = std::make_shared<EchoTCPService>();
+    service->SetupNumaNode(0);
+    REQUIRE(service->option_numa_node() == 0);
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Asio service pool with services pinned one per CPU of the first NUMA node
+    std::vector<std::shared_ptr<Service>> services;
+    for (size_t i = 0; i < 2; ++i)
+        services.emplace_back(std::make_shared<EchoTCPService>());
+    auto pool = std::make_shared<ServicePool>(services);
+    pool->SetupNumaNode(0);
+    REQUIRE(pool->Start());
+    while (!pool->IsStarted())
+        Thread::Yield();
+
+    // Check services of the pool are placed
+    for (auto& pool_service : pool->services())
+    {
+        REQUIRE(pool_service->option_cpu_affinity().size() == 1);
+        REQUIRE(pool_service->option_numa_node() == 0);
+    }
+
+    // Create and start Echo server with sessions placed into the service pool
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    server->SetupServicePool(pool);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo clients
+    auto clients = ConnectEchoClients(service, server, address, port, 4);
+
+    // Echo a message from each client
+    EchoMessages(clients, 1);
+
+    // Disconnect all clients
+    for (auto& client : clients)
+        REQUIRE(client->Disconnect());
+    for (auto& client : clients)
+        while (client->IsConnected())
+            Thread::Yield();
+    while (server->clients != 0)
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service pool
+    REQUIRE(pool->Stop());
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check all working threads were pinned without errors
+    REQUIRE(!service->error);
+    for (auto& pool_service : services)
+        REQUIRE(!std::static_pointer_cast<EchoTCPService>(pool_service)->error);
+
+    // Check the Echo server state
+    REQUIRE(server->bytes_received() == 16);
+    REQUIRE(!server->error);
+}
+
+#if defined(CPPSERVER_ASIO_COROUTINES)
+
+std::atomic<size_t> coroutine_sessions_finished(0);
+
+class CoroutineTCPSession : public TCPSession<TestTCPServer<CoroutineTCPSession>, CoroutineTCPSession>
+{
+public:
+    using TCPSession<TestTCPServer<CoroutineTCPSession>, CoroutineTCPSession>::TCPSession;
+
+protected:
+    void onConnected() override { Echo(std::static_pointer_cast<CoroutineTCPSession>(shared_from_this())); }
+
+private:
+    static Task Echo(std::shared_ptr<CoroutineTCPSession> session)
+    {
+        // Echo received data until the session is disconnected
+        uint8_t buffer[64];
+        size_t size;
+        while ((size = co_await session->ReceiveAsync(buffer, sizeof(buffer))) > 0)
+            if (co_await session->SendAsync(buffer, size) != size)
+                break;
+        ++coroutine_sessions_finished;
+    }
+};
+
+typedef TestTCPServer<CoroutineTCPSession> CoroutineTCPServer;
+
+class CoroutineTCPClient : public EchoTCPClient
+{
+public:
+    std::atomic<size_t> echoes;
+    std::atomic<bool> finished;
+
+    explicit CoroutineTCPClient(std::shared_ptr<EchoTCPService> service, const std::string& address, int port)
+        : EchoTCPClient(service, address, port),
+          echoes(0),
+          finished(false)
+    {
+    }
+
+    static Task Run(std::shared_ptr<CoroutineTCPClient> client, size_t count)
+    {
+        // Connect the client and await echoes of sent messages
+        if (co_await client->ConnectAsync())
+        {
+            const std::string message = "test";
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (co_await client->SendAsync(message.data(), message.size()) != message.size())
+                    break;
+
+                char buffer[4];
+                size_t received = 0;
+                while (received < sizeof(buffer))
+                {
+                    size_t size = co_await client->ReceiveAsync(buffer + received, sizeof(buffer) - received);
+                    if (size == 0)
+                        break;
+                    received += size;
+                }
+                if (std::string(buffer, received) != message)
+                    break;
+
+                ++client->echoes;
+            }
+        }
+        client->finished = true;
+    }
+};
+
+TEST_CASE("TCP server coroutines", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1127;
+
+    // Create and start Asio service with several working threads
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start(false, 4));
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server with coroutine sessions
+    auto server = std::make_shared<CoroutineTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create Echo clients and run their coroutines
+    std::vector<std::shared_ptr<CoroutineTCPClient>> clients;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        auto client = std::make_shared<CoroutineTCPClient>(service, address, port);
+        CoroutineTCPClient::Run(client, 100);
+        clients.emplace_back(client);
+    }
+
+    // Wait for all coroutines finished...
+    for (auto& client : clients)
+        while (!client->finished)
+            Thread::Yield();
+
+    // Disconnect all clients
+    for (auto& client : clients)
+        REQUIRE(client->Disconnect());
+    for (auto& client : clients)
+        while (client->IsConnected())
+            Thread::Yield();
+    while ((server->clients != 0) || (coroutine_sessions_finished != clients.size()))
+        Thread::Yield();
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    while (server->IsStarted())
+        Thread::Yield();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo clients state
+    for (auto& client : clients)
+    {
+        REQUIRE(client->echoes == 100);
+        REQUIRE(!client->error);
+    }
+
+    // Check the Echo server state
+    REQUIRE(server->bytes_received() == 1600);
+    REQUIRE(server->bytes_sent() == 1600);
+    REQUIRE(!server->error);
+}
+
+#endif
+
+TEST_CASE("TCP server graceful stop", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1128;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start Echo server
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+
+    // Create and connect Echo clients
+    auto client1 = std::make_shared<EchoTCPClient>(service, address, port);
+    auto client2 = std::make_shared<EchoTCPClient>(service, address, port);
+    REQUIRE(client1->Connect());
+    REQUIRE(client2->Connect());
+    while (!client1->IsConnected() || !client2->IsConnected() || (server->clients != 2))
+        Thread::Yield();
+
+    // Fill the send buffer of the last connected session and stop the Echo server gracefully
+    auto message = std::make_shared<const Buffer>(4194304, 'x');
+    REQUIRE(server->FindSession(server->last_session)->Send(message) > 0);
+    REQUIRE(server->Stop(std::chrono::seconds(10)));
+
+    // Wait for the Echo server stopped without spinning...
+    server->WaitStopped();
+    REQUIRE(!server->IsStarted());
+    REQUIRE(!server->IsDraining());
+    REQUIRE(server->stopped);
+    REQUIRE(server->clients == 0);
+
+    // Both clients are disconnected by the server and the busy one received all data
+    while (client1->IsConnected() || client2->IsConnected())
+        Thread::Yield();
+    REQUIRE((client1->bytes_received() + client2->bytes_received()) == message->size());
+    REQUIRE(!client1->error);
+    REQUIRE(!client2->error);
+
+    // Restart the Echo server and connect the client which never closes the connection
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+    asio::ip::tcp::socket socket(*service->service());
+    socket.connect(asio::ip::tcp::endpoint(asio::ip::address::from_string(address), port));
+    while (server->clients != 1)
+        Thread::Yield();
+
+    // The session which is not drained is disconnected by the drain timeout
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(server->Stop(std::chrono::milliseconds(100)));
+    server->WaitStopped();
+    REQUIRE((std::chrono::steady_clock::now() - start) >= std::chrono::milliseconds(100));
+    while (server->clients != 0)
+        Thread::Yield();
+    socket.close();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    // Check the Echo server state
+    REQUIRE(server->statistics().disconnects() == 1);
+    REQUIRE(!server->error);
+}
+
+TEST_CASE("TCP client reconnect", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port = 1129;
+    const int closed_port = 1130;
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Connect the client with automatic reconnect before the Echo server is started
+    auto client = std::make_shared<EchoTCPClient>(service, address, port);
+    client->SetupReconnect(std::chrono::milliseconds(10), std::chrono::milliseconds(40));
+    REQUIRE(client->Connect());
+    while (client->reconnects < 3)
+        Thread::Yield();
+    REQUIRE(!client->IsConnected());
+
+    // Create and start Echo server. The client should be connected by the next attempt.
+    auto server = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port);
+    REQUIRE(server->Start());
+    while (!server->IsStarted())
+        Thread::Yield();
+    while (!client->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+    REQUIRE(client->connects == 1);
+
+    // Disconnect the client by the server. The client should connect again.
+    REQUIRE(server->DisconnectAll());
+    while ((client->connects != 2) || !client->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+
+    // Reconnect the client without waiting for the disconnect
+    REQUIRE(client->Reconnect());
+    while ((client->connects != 3) || !client->IsConnected() || (server->clients != 1))
+        Thread::Yield();
+
+    // Send data while the client is disconnected by the server. Data left by
+    // the racing producer should not stall sending after the next connect.
+    std::atomic<bool> producing(true);
+    std::thread producer([&client, &producing]()
+    {
+        while (producing)
+            client->Send("test");
+    });
+    for (size_t i = 0; i < 10; ++i)
+    {
+        size_t connects = client->connects;
+        server->DisconnectAll();
+        while ((client->connects == connects) || !client->IsConnected() || (server->clients != 1))
+            Thread::Yield();
+    }
+    producing = false;
+    producer.join();
+    REQUIRE(client->Send("test") > 0);
+    for (size_t i = 0; (i < 1000) && (client->bytes_pending() > 0); ++i)
+        Thread::Sleep(10);
+    REQUIRE(client->bytes_pending() == 0);
+
+    // Disconnect the client. Automatic reconnect should be stopped.
+    size_t reconnects = client->reconnects;
+    REQUIRE(client->Disconnect());
+    while (client->IsConnected() || (server->clients != 0))
+        Thread::Yield();
+    Thread::Sleep(100);
+    REQUIRE(!client->IsConnected());
+    REQUIRE(client->reconnects == reconnects);
+    REQUIRE(client->delays_valid);
+
+    // Reconnect attempts of the client should be limited
+    auto limited = std::make_shared<EchoTCPClient>(service, address, closed_port);
+    limited->SetupReconnect(std::chrono::milliseconds(5), std::chrono::milliseconds(5), 3);
+    REQUIRE(limited->Connect());
+    while (limited->disconnects != 4)
+        Thread::Yield();
+    Thread::Sleep(100);
+    REQUIRE(limited->reconnects == 3);
+    REQUIRE(limited->disconnects == 4);
+    REQUIRE(!limited->IsConnected());
+
+    // Stop the Echo server
+    REQUIRE(server->Stop());
+    server->WaitStopped();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    REQUIRE(!client->error);
+    REQUIRE(!limited->error);
+    REQUIRE(!server->error);
+}
+
+TEST_CASE("TCP client pool", "[CppServer][Asio]")
+{
+    const std::string address = "127.0.0.1";
+    const int port1 = 1131;
+    const int port2 = 1132;
+    const std::string message = "test";
+
+    // Create and start Asio service
+    auto service = std::make_shared<EchoTCPService>();
+    REQUIRE(service->Start());
+    while (!service->IsStarted())
+        Thread::Yield();
+
+    // Create and start two Echo servers
+    auto server1 = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port1);
+    auto server2 = std::make_shared<EchoTCPServer>(service, InternetProtocol::IPv4, port2);
+    REQUIRE(server1->Start());
+    REQUIRE(server2->Start());
+    while (!server1->IsStarted() || !server2->IsStarted())
+        Thread::Yield();
+
+    // Create and connect the client pool with two connections per endpoint
+    auto pool = std::make_shared<EchoTCPClientPool>(service, 2);
+    REQUIRE(pool->AddEndpoint(address, port1));
+    REQUIRE(pool->AddEndpoint(address, port2));
+    REQUIRE(!pool->AddEndpoint(address, port1));
+    REQUIRE(pool->endpoints() == 2);
+    REQUIRE(pool->clients() == 4);
+    REQUIRE(pool->Connect());
+    while ((pool->connected_clients() != 4) || (server1->clients != 2) || (server2->clients != 2))
+        Thread::Yield();
+    REQUIRE(pool->available_endpoints() == 2);
+
+    // Send messages through the least pending clients
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(pool->Send(message) > 0);
+    while (pool->bytes_received() != (100 * message.size()))
+        Thread::Yield();
+
+    // Send messages through the power of two choices clients
+    pool->SetupLoadBalancing(LoadBalancing::PowerOfTwo);
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(pool->Send(message) > 0);
+    while (pool->bytes_received() != (200 * message.size()))
+        Thread::Yield();
+
+    // Both servers should receive messages
+    REQUIRE(server1->bytes_received() > 0);
+    REQUIRE(server2->bytes_received() > 0);
+    REQUIRE((server1->bytes_received() + server2->bytes_received()) == (200 * message.size()));
+
+    // Stop the second server. Its endpoint should be out of rotation.
+    REQUIRE(server2->Stop());
+    server2->WaitStopped();
+    while ((pool->connected_clients() != 2) || (pool->available_endpoints() != 1))
+        Thread::Yield();
+    uint64_t received = server1->bytes_received();
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(pool->Send(message) > 0);
+    while (server1->bytes_received() != (received + 100 * message.size()))
+        Thread::Yield();
+
+    // Start the second server again. Its clients should be reconnected.
+    REQUIRE(server2->Start());
+    while ((pool->connected_clients() != 4) || (server2->clients != 2))
+        Thread::Yield();
+
+    // Remove the second endpoint
+    REQUIRE(pool->RemoveEndpoint(asio::ip::tcp::endpoint(asio::ip::address::from_string(address), port2)));
+    REQUIRE(!pool->RemoveEndpoint(asio::ip::tcp::endpoint(asio::ip::address::from_string(address), port2)));
+    REQUIRE(pool->endpoints() == 1);
+    REQUIRE(pool->clients() == 2);
+    while (server2->clients != 0)
+        Thread::Yield();
+
+    // Disconnect the client pool. Sending through it should be rejected.
+    REQUIRE(pool->Disconnect());
+    while ((pool->connected_clients() != 0) || (server1->clients != 0))
+        Thread::Yield();
+    REQUIRE(pool->Send(message) == 0);
+    REQUIRE(pool->statistics().messages_sent() == 300);
+    REQUIRE(pool->statistics().bytes_sent() == (300 * message.size()));
+    REQUIRE(pool->statistics().errors() == 1);
+
+    // Stop Echo servers
+    REQUIRE(server1->Stop());
+    REQUIRE(server2->Stop());
+    server1->WaitStopped();
+    server2->WaitStopped();
+
+    // Stop the Asio service
+    REQUIRE(service->Stop());
+    while (service->IsStarted())
+        Thread::Yield();
+
+    REQUIRE(!server1->error);
+    REQUIRE(!server2->error);
+}
+
 TEST_CASE("TCP server random test", "[CppServer][Asio]")
 {
     const std::string address = "127.0.0.1";
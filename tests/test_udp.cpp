@@ -145,6 +145,9 @@ TEST_CASE("UDP server", "[CppServer][Asio]")
     REQUIRE(server->stopped);
     REQUIRE(server->bytes_sent() == 4);
     REQUIRE(server->bytes_received() == 4);
+    REQUIRE(server->datagrams_sent() == 1);
+    REQUIRE(server->datagrams_received() == 1);
+    REQUIRE(server->statistics().errors() == 0);
     REQUIRE(!server->error);
 
     // Check the Echo client state